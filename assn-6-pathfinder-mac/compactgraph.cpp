@@ -0,0 +1,286 @@
+/*
+ * File: compactgraph.cpp
+ * ----------------------
+ * This file implements the compactgraph.h interface.
+ */
+
+#include <cmath>
+#include <climits>
+#include <cstring>
+#include "genlib.h"
+#include "compactgraph.h"
+
+/* Private function prototypes */
+
+static weightCodingT ChooseCoding(Graph<nodeT,arcT> & graph, double tolerance,
+                                  double & maxError);
+static void SortByFinish(Vector<arcT *> & arcs);
+static unsigned DecodeVarint(const unsigned char * & cp);
+
+CompactGraph::CompactGraph() {
+	clear();
+}
+
+CompactGraph::~CompactGraph() {
+	/* Empty */
+}
+
+/*
+ * Implementation notes: build
+ * ---------------------------
+ * The arcs of each node are copied into a buffer and sorted by the
+ * index of their finish nodes, so that every difference after the
+ * first is nonnegative.  The byte array grows by doubling as the arcs
+ * are encoded, and copying it at the end trims it to its final size.
+ */
+
+void CompactGraph::build(Graph<nodeT,arcT> & graph, double tolerance) {
+	clear();
+	coding = ChooseCoding(graph, tolerance, maxError);
+	int nNodes = graph.size();
+	offsets = Vector<int>(nNodes);
+	Vector<arcT *> arcs;
+	for (int i = 0; i < nNodes; i++) {
+		nodeT *node = graph.getNodeByIndex(i);
+		offsets.add(bytes.size());
+		while (!arcs.isEmpty()) {
+			arcs.removeAt(arcs.size() - 1);
+		}
+		for (int j = 0; j < node->arcs.size(); j++) {
+			arcs.add(node->arcs[j]);
+		}
+		SortByFinish(arcs);
+		putVarint(arcs.size());
+		int prev = i;
+		for (int j = 0; j < arcs.size(); j++) {
+			int finish = arcs[j]->finish->index;
+			if (j > 0) {
+				putVarint(unsigned(finish - prev));
+			} else if (finish >= prev) {
+				putVarint(unsigned(finish - prev) << 1);
+			} else {
+				putVarint((unsigned(prev - finish - 1) << 1) | 1);
+			}
+			prev = finish;
+			double d = arcs[j]->distance;
+			if (coding == INTEGER_WEIGHTS) {
+				putVarint(unsigned(d));
+			} else if (coding == FLOAT_WEIGHTS) {
+				float f = float(d);
+				putRaw(&f, sizeof f);
+				d = f;
+			} else {
+				putRaw(&d, sizeof d);
+			}
+			if (d > maxArc) maxArc = d;
+		}
+		nArcs += arcs.size();
+		if (arcs.size() > maxDegree) maxDegree = arcs.size();
+	}
+	Vector<unsigned char> packed(bytes);
+	bytes.swap(packed);
+	graphVersion = graph.getVersion();
+}
+
+int CompactGraph::size() {
+	return offsets.size();
+}
+
+long CompactGraph::getArcCount() {
+	return nArcs;
+}
+
+int CompactGraph::getMaxDegree() {
+	return maxDegree;
+}
+
+/*
+ * Implementation notes: decodeArcs
+ * --------------------------------
+ * The test on the coding is made once per node rather than once per
+ * arc, and the bytes are read through a pointer so that only the start
+ * of the node is checked against the bounds of the array.  Distances
+ * stored as floats and doubles are copied with memcpy because they are
+ * not aligned.
+ */
+
+int CompactGraph::decodeArcs(int index, compactArcT arcs[]) {
+	const unsigned char *cp = &bytes[offsets[index]];
+	int n = DecodeVarint(cp);
+	int finish = index;
+	for (int i = 0; i < n; i++) {
+		unsigned delta = DecodeVarint(cp);
+		if (i > 0) {
+			finish += delta;
+		} else if ((delta & 1) == 0) {
+			finish += delta >> 1;
+		} else {
+			finish -= (delta >> 1) + 1;
+		}
+		arcs[i].finish = finish;
+		switch (coding) {
+		  case INTEGER_WEIGHTS:
+			arcs[i].distance = DecodeVarint(cp);
+			break;
+		  case FLOAT_WEIGHTS: {
+			float f;
+			memcpy(&f, cp, sizeof f);
+			cp += sizeof f;
+			arcs[i].distance = f;
+			break;
+		  }
+		  default:
+			memcpy(&arcs[i].distance, cp, sizeof(double));
+			cp += sizeof(double);
+			break;
+		}
+	}
+	return n;
+}
+
+weightCodingT CompactGraph::getWeightCoding() {
+	return coding;
+}
+
+double CompactGraph::getMaxArcDistance() {
+	return maxArc;
+}
+
+double CompactGraph::getMaxWeightError() {
+	return maxError;
+}
+
+bool CompactGraph::isCurrent(Graph<nodeT,arcT> & graph) {
+	return graphVersion == graph.getVersion();
+}
+
+graphMemoryT CompactGraph::memoryStats() {
+	graphMemoryT stats;
+	memset(&stats, 0, sizeof stats);
+	stats.nNodes = size();
+	stats.nArcs = int(nArcs);
+	stats.adjacencyBytes = bytes.getHeapBytes();
+	stats.indexBytes = offsets.getHeapBytes() + sizeof *this;
+	stats.totalBytes = stats.adjacencyBytes + stats.indexBytes;
+	stats.bytesPerNode = (stats.nNodes == 0) ? 0
+	                   : double(stats.totalBytes) / stats.nNodes;
+	stats.bytesPerArc = (stats.nArcs == 0) ? 0
+	                  : double(stats.totalBytes) / stats.nArcs;
+	return stats;
+}
+
+double CompactGraph::getCompressionRatio() {
+	double plain = (size() + 1.0) * sizeof(int)
+	             + nArcs * (sizeof(int) + sizeof(double));
+	return plain / memoryStats().totalBytes;
+}
+
+void CompactGraph::clear() {
+	bytes.clear();
+	offsets.clear();
+	nArcs = 0;
+	maxDegree = 0;
+	coding = INTEGER_WEIGHTS;
+	maxArc = 0;
+	maxError = 0;
+	graphVersion = 0;
+}
+
+/*
+ * Implementation notes: putVarint
+ * -------------------------------
+ * A varint stores seven bits of the value in each byte, starting with
+ * the least significant bits, and sets the high bit of every byte but
+ * the last.  Values below 128 take one byte and no unsigned value
+ * takes more than five.
+ */
+
+void CompactGraph::putVarint(unsigned value) {
+	while (value >= 0x80) {
+		bytes.add((unsigned char) (value | 0x80));
+		value >>= 7;
+	}
+	bytes.add((unsigned char) value);
+}
+
+void CompactGraph::putRaw(const void *data, int nBytes) {
+	const unsigned char *cp = (const unsigned char *) data;
+	for (int i = 0; i < nBytes; i++) {
+		bytes.add(cp[i]);
+	}
+}
+
+/*
+ * Function: ChooseCoding
+ * Usage: weightCodingT coding = ChooseCoding(graph, tolerance, maxError);
+ * -----------------------------------------------------------------------
+ * Returns the first coding in weightCodingT that can store every arc
+ * distance in graph within the relative tolerance.  If the coding is
+ * FLOAT_WEIGHTS, the largest relative error it introduces is stored in
+ * maxError; otherwise maxError is set to 0.
+ */
+
+static weightCodingT ChooseCoding(Graph<nodeT,arcT> & graph, double tolerance,
+                                  double & maxError) {
+	bool integral = true;
+	bool fitsFloat = true;
+	maxError = 0;
+	for (int i = 0; i < graph.size(); i++) {
+		nodeT *node = graph.getNodeByIndex(i);
+		for (int j = 0; j < node->arcs.size(); j++) {
+			double d = node->arcs[j]->distance;
+			if (d < 0) Error("CompactGraph: Negative arc distance");
+			if (d != floor(d) || d > UINT_MAX) integral = false;
+			double error = (d == 0) ? 0 : fabs(double(float(d)) - d) / d;
+			if (error > tolerance) fitsFloat = false;
+			if (error > maxError) maxError = error;
+		}
+	}
+	if (integral) {
+		maxError = 0;
+		return INTEGER_WEIGHTS;
+	}
+	if (fitsFloat) return FLOAT_WEIGHTS;
+	maxError = 0;
+	return DOUBLE_WEIGHTS;
+}
+
+/*
+ * Function: SortByFinish
+ * Usage: SortByFinish(arcs);
+ * --------------------------
+ * Sorts arcs into increasing order of the index of their finish nodes
+ * with an insertion sort, since a node has only a few arcs.
+ */
+
+static void SortByFinish(Vector<arcT *> & arcs) {
+	for (int i = 1; i < arcs.size(); i++) {
+		arcT *arc = arcs[i];
+		int j = i;
+		while (j > 0 && arcs[j - 1]->finish->index > arc->finish->index) {
+			arcs[j] = arcs[j - 1];
+			j--;
+		}
+		arcs[j] = arc;
+	}
+}
+
+/*
+ * Function: DecodeVarint
+ * Usage: unsigned value = DecodeVarint(cp);
+ * -----------------------------------------
+ * Reads a varint starting at cp and advances cp past it.  The test for
+ * a single byte comes first because nearly every value in a compact
+ * graph of a reordered map is that small.
+ */
+
+static unsigned DecodeVarint(const unsigned char * & cp) {
+	unsigned value = *cp++;
+	if (value < 0x80) return value;
+	value &= 0x7F;
+	for (int shift = 7; true; shift += 7) {
+		unsigned next = *cp++;
+		value |= (next & 0x7F) << shift;
+		if (next < 0x80) return value;
+	}
+}
@@ -0,0 +1,211 @@
+/*
+ * File: compactgraph.h
+ * --------------------
+ * This file provides the interface to the CompactGraph class, a
+ * read-only copy of the arcs of a Pathfinder graph packed into a single
+ * array of bytes.  A Graph keeps every arc in a separate structure and
+ * reaches it through pointers held by the nodes, so that a search
+ * follows one pointer per arc to memory that may be anywhere on the
+ * heap.  A CompactGraph stores the arcs leaving each node one after
+ * another, giving each neighbor as the difference from the previous
+ * neighbor's index and each distance in as few bytes as the values
+ * allow.  On maps whose nodes have been put in a local order by
+ * ReorderGraph in nodeorder.h, most of those differences fit in a
+ * single byte, and a search reads far less memory than it does when
+ * running on the Graph itself.
+ */
+
+#ifndef _compactgraph_h
+#define _compactgraph_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+
+/*
+ * Type: weightCodingT
+ * -------------------
+ * This type identifies the way the arc distances are stored:
+ *
+ *   INTEGER_WEIGHTS  Every distance is a nonnegative integer that fits
+ *                    in an unsigned int and is stored as a varint, so
+ *                    that distances below 128 take a single byte.
+ *   FLOAT_WEIGHTS    Every distance is stored as a four-byte float.
+ *                    This coding is used when each distance is exactly
+ *                    representable as a float or when the client allows
+ *                    the rounding error it introduces.
+ *   DOUBLE_WEIGHTS   Every distance is stored exactly as a double.
+ *
+ * The build method always chooses the first coding that applies.
+ */
+
+enum weightCodingT { INTEGER_WEIGHTS, FLOAT_WEIGHTS, DOUBLE_WEIGHTS };
+
+/*
+ * Type: compactArcT
+ * -----------------
+ * This type holds an arc as it is decoded from a CompactGraph: the
+ * index of the node at the end of the arc and the arc's distance.
+ */
+
+struct compactArcT {
+	int finish;
+	double distance;
+};
+
+/*
+ * Class: CompactGraph
+ * -------------------
+ * This class holds the compressed arcs of a graph.  The nodes are
+ * identified by the values their index fields had when the copy was
+ * built, and the copy describes the graph as it was at that time; the
+ * isCurrent method reports whether the graph has changed since.
+ */
+
+class CompactGraph {
+public:
+
+/*
+ * Constructor: CompactGraph
+ * Usage: CompactGraph compact;
+ * ----------------------------
+ * Creates an empty compact graph, which has no nodes until build is
+ * called.
+ */
+	CompactGraph();
+
+/*
+ * Destructor: ~CompactGraph
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees the storage associated with this compact graph.
+ */
+	~CompactGraph();
+
+/*
+ * Method: build
+ * Usage: compact.build(graph);
+ *        compact.build(graph, tolerance);
+ * ---------------------------------------
+ * Replaces the contents of this object with a compressed copy of the
+ * arcs of graph, choosing the coding for the distances as described
+ * for weightCodingT.  The optional tolerance is the largest relative
+ * error the client accepts in each distance; it is 0 by default, in
+ * which case every distance is stored exactly.  Arc distances must be
+ * nonnegative.  Building takes time proportional to the size of the
+ * graph.
+ */
+	void build(Graph<nodeT,arcT> & graph, double tolerance = 0);
+
+/*
+ * Methods: size, getArcCount, getMaxDegree
+ * Usage: int nNodes = compact.size();
+ *        long nArcs = compact.getArcCount();
+ *        int degree = compact.getMaxDegree();
+ * ---------------------------------------------
+ * These methods return the number of nodes and arcs and the largest
+ * number of arcs leaving any one node.
+ */
+	int size();
+	long getArcCount();
+	int getMaxDegree();
+
+/*
+ * Method: decodeArcs
+ * Usage: int nArcs = compact.decodeArcs(index, arcs);
+ * ---------------------------------------------------
+ * Stores the arcs leaving the node with the specified index in the
+ * array arcs, which must have room for getMaxDegree entries, and
+ * returns their number.  The arcs come out in increasing order of the
+ * index of their finish nodes.  Decoding every arc of a node in one
+ * call keeps the inner loop of a search free of function calls.
+ */
+	int decodeArcs(int index, compactArcT arcs[]);
+
+/*
+ * Methods: getWeightCoding, getMaxArcDistance, getMaxWeightError
+ * Usage: weightCodingT coding = compact.getWeightCoding();
+ *        double maxArc = compact.getMaxArcDistance();
+ *        double error = compact.getMaxWeightError();
+ * -------------------------------------------------------------
+ * These methods return the coding chosen for the distances, the longest
+ * arc distance as stored, and the largest relative error introduced by
+ * storing any distance, which is 0 unless build was given a tolerance.
+ */
+	weightCodingT getWeightCoding();
+	double getMaxArcDistance();
+	double getMaxWeightError();
+
+/*
+ * Method: isCurrent
+ * Usage: if (compact.isCurrent(graph)) . . .
+ * ------------------------------------------
+ * Returns true if this object was built from graph and the graph has
+ * not changed since.
+ */
+	bool isCurrent(Graph<nodeT,arcT> & graph);
+
+/*
+ * Method: memoryStats
+ * Usage: graphMemoryT stats = compact.memoryStats();
+ * --------------------------------------------------
+ * Returns the memory used by this object in the form described in
+ * graph.h.  The encoded arcs are reported as adjacencyBytes and the
+ * table of offsets as indexBytes; the other fields are zero.
+ */
+	graphMemoryT memoryStats();
+
+/*
+ * Method: getCompressionRatio
+ * Usage: double ratio = compact.getCompressionRatio();
+ * ----------------------------------------------------
+ * Returns the size of the same arcs in an uncompressed adjacency array,
+ * with a four-byte offset per node and a four-byte index and an
+ * eight-byte distance per arc, divided by the size of this object.
+ * Comparing against the Graph itself, whose arcs are separate heap
+ * objects, gives a much larger figure that says little about the
+ * coding; clients can compute it from the memoryStats of both.
+ */
+	double getCompressionRatio();
+
+private:
+
+/*
+ * Implementation notes: layout
+ * ----------------------------
+ * The arcs of each node begin at the position in bytes given by its
+ * entry in offsets, with the number of arcs as a varint.  Each arc
+ * follows as a neighbor and a distance.  The first neighbor is the
+ * signed difference from the node's own index, mapped onto the
+ * unsigned values by the zigzag coding so that small differences in
+ * either direction stay small; each later neighbor is the nonnegative
+ * difference from the one before.  Every node has at least the byte
+ * giving its count, so its offset is always a valid position.
+ */
+
+/* Instance variables */
+
+	Vector<unsigned char> bytes;
+	Vector<int> offsets;
+	long nArcs;
+	int maxDegree;
+	weightCodingT coding;
+	double maxArc;
+	double maxError;
+	long graphVersion;
+
+/* Private methods */
+
+	void clear();
+	void putVarint(unsigned value);
+	void putRaw(const void *data, int nBytes);
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(CompactGraph)
+
+};
+
+#endif
@@ -0,0 +1,163 @@
+/*
+ * File: components.cpp
+ * --------------------
+ * This file implements the components.h interface.
+ */
+
+#include "genlib.h"
+#include "components.h"
+
+ComponentIndex::ComponentIndex() {
+	graph = NULL;
+	nComponents = 0;
+	stale = false;
+}
+
+ComponentIndex::ComponentIndex(Graph<nodeT,arcT> & graph) {
+	this->graph = NULL;
+	nComponents = 0;
+	stale = false;
+	attach(graph);
+}
+
+ComponentIndex::~ComponentIndex() {
+	detach();
+}
+
+void ComponentIndex::attach(Graph<nodeT,arcT> & graph) {
+	detach();
+	this->graph = &graph;
+	rebuild();
+	graph.addListener(this);
+}
+
+void ComponentIndex::detach() {
+	if (graph != NULL) graph->removeListener(this);
+	graph = NULL;
+	parent.clear();
+	treeSize.clear();
+	nComponents = 0;
+	stale = false;
+}
+
+bool ComponentIndex::sameComponent(nodeT *n1, nodeT *n2) {
+	return getComponent(n1) == getComponent(n2);
+}
+
+int ComponentIndex::getComponent(nodeT *node) {
+	if (stale) rebuild();
+	if (node->index < 0 || node->index >= parent.size()) {
+		Error("getComponent: Node " + node->name + " is not in the index");
+	}
+	return find(node->index);
+}
+
+int ComponentIndex::getComponentCount() {
+	if (stale) rebuild();
+	return nComponents;
+}
+
+/*
+ * Implementation notes: nodeAdded, arcAdded
+ * -----------------------------------------
+ * A new node always receives the next index, so it becomes a component
+ * of its own at the end of the arrays.  While the index is stale, these
+ * methods do nothing, since the next query rebuilds it anyway.
+ */
+
+void ComponentIndex::nodeAdded(nodeT *node) {
+	if (!stale) addNodes(1);
+}
+
+void ComponentIndex::nodeRemoved(nodeT *node) {
+	stale = true;
+}
+
+void ComponentIndex::arcAdded(arcT *arc) {
+	if (!stale) merge(arc->start->index, arc->finish->index);
+}
+
+void ComponentIndex::arcRemoved(arcT *arc) {
+	stale = true;
+}
+
+/*
+ * Implementation notes: graphReset
+ * --------------------------------
+ * A graph that has just been cleared is empty, so the index can be
+ * emptied at once and then follow the graph as it is filled again,
+ * which is how a new map is loaded.
+ */
+
+void ComponentIndex::graphReset() {
+	if (graph != NULL && graph->size() == 0) {
+		rebuild();
+	} else {
+		stale = true;
+	}
+}
+
+/*
+ * Private method: rebuild
+ * Usage: rebuild();
+ * -----------------
+ * Labels the components of the graph from scratch by merging the
+ * endpoints of every arc.
+ */
+
+void ComponentIndex::rebuild() {
+	parent.clear();
+	treeSize.clear();
+	nComponents = 0;
+	stale = false;
+	if (graph == NULL) return;
+	int n = graph->size();
+	parent = Vector<int>(n);
+	treeSize = Vector<int>(n);
+	addNodes(n);
+	for (int i = 0; i < n; i++) {
+		nodeT *node = graph->getNodeByIndex(i);
+		for (int j = 0; j < node->arcs.size(); j++) {
+			merge(i, node->arcs[j]->finish->index);
+		}
+	}
+}
+
+void ComponentIndex::addNodes(int nNodes) {
+	for (int i = 0; i < nNodes; i++) {
+		parent.add(parent.size());
+		treeSize.add(1);
+		nComponents++;
+	}
+}
+
+void ComponentIndex::merge(int i1, int i2) {
+	int r1 = find(i1);
+	int r2 = find(i2);
+	if (r1 == r2) return;
+	if (treeSize[r1] < treeSize[r2]) {
+		int tmp = r1;
+		r1 = r2;
+		r2 = tmp;
+	}
+	parent[r2] = r1;
+	treeSize[r1] += treeSize[r2];
+	nComponents--;
+}
+
+/*
+ * Private method: find
+ * Usage: int root = find(index);
+ * ------------------------------
+ * Returns the root of the tree containing the node with the specified
+ * index.  Along the way, each node on the path is linked to its
+ * grandparent, which halves the length of the path.
+ */
+
+int ComponentIndex::find(int index) {
+	while (parent[index] != index) {
+		parent[index] = parent[parent[index]];
+		index = parent[index];
+	}
+	return index;
+}
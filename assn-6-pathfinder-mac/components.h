@@ -0,0 +1,145 @@
+/*
+ * File: components.h
+ * ------------------
+ * This file provides the interface to the ComponentIndex class, which
+ * labels the connected components of a Pathfinder graph.  A search
+ * between nodes in different components is the worst case for every
+ * query engine, because it must explore the entire component of the
+ * start before it can report that there is no path.  With the index,
+ * the engines reject such queries before they begin.
+ */
+
+#ifndef _components_h
+#define _components_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+
+/*
+ * Class: ComponentIndex
+ * ---------------------
+ * This class divides the nodes of a graph into components, ignoring
+ * the direction of the arcs.  Nodes in different components can never
+ * be joined by a path, although two nodes in the same component are
+ * not necessarily joined by a path that follows the arcs forward.  On
+ * maps in which every road runs both ways, the two notions agree.
+ *
+ * Once attached to a graph, the index registers itself as a listener.
+ * Adding nodes and arcs updates the index immediately, while removing
+ * them, which may split a component, marks the index as out of date
+ * so that it is rebuilt by the next query.
+ */
+
+class ComponentIndex : public GraphListener<nodeT,arcT> {
+public:
+
+/*
+ * Constructor: ComponentIndex
+ * Usage: ComponentIndex components;
+ *        ComponentIndex components(graph);
+ * ----------------------------------------
+ * Creates a component index.  The second form attaches the index to
+ * the graph, as described for the attach method.
+ */
+	ComponentIndex();
+	ComponentIndex(Graph<nodeT,arcT> & graph);
+
+/*
+ * Destructor: ~ComponentIndex
+ * Usage: (usually implicit)
+ * -------------------------
+ * Detaches the index from its graph and frees its storage.
+ */
+	virtual ~ComponentIndex();
+
+/*
+ * Methods: attach, detach
+ * Usage: components.attach(graph);
+ *        components.detach();
+ * -------------------------------
+ * The attach method labels the components of the graph, which takes
+ * time proportional to the size of the graph, and registers the index
+ * as a listener.  If the index is attached to an empty graph, such as
+ * one about to be filled from a map file, the labels are built as the
+ * nodes and arcs are added.  The graph must outlive the index or be
+ * detached from it first.  The detach method unregisters the index.
+ */
+	void attach(Graph<nodeT,arcT> & graph);
+	void detach();
+
+/*
+ * Method: sameComponent
+ * Usage: if (components.sameComponent(n1, n2)) . . .
+ * --------------------------------------------------
+ * Returns true if the two nodes lie in the same component.  Apart from
+ * rebuilding an index that is out of date, this method runs in what is
+ * for all practical purposes constant time.
+ */
+	bool sameComponent(nodeT *n1, nodeT *n2);
+
+/*
+ * Method: getComponent
+ * Usage: int label = components.getComponent(node);
+ * -------------------------------------------------
+ * Returns a label for the component containing the node.  Two nodes
+ * have the same label exactly when they lie in the same component, but
+ * the labels themselves may change whenever the graph does.
+ */
+	int getComponent(nodeT *node);
+
+/*
+ * Method: getComponentCount
+ * Usage: int n = components.getComponentCount();
+ * ----------------------------------------------
+ * Returns the number of components, which is also the number of trees
+ * in a minimum spanning forest of the graph.
+ */
+	int getComponentCount();
+
+/* Methods called by the graph, as described in graph.h */
+
+	virtual void nodeAdded(nodeT *node);
+	virtual void nodeRemoved(nodeT *node);
+	virtual void arcAdded(arcT *arc);
+	virtual void arcRemoved(arcT *arc);
+	virtual void graphReset();
+
+private:
+
+/*
+ * Implementation notes: union-find
+ * --------------------------------
+ * The components are kept in a union-find structure indexed by the
+ * index fields of the nodes.  Each component is a tree in the parent
+ * array whose root is its label, and adding an arc merges the trees
+ * of its endpoints.  The smaller tree always goes under the larger,
+ * and find shortens the paths it follows, which together make every
+ * operation take nearly constant time.  Removals cannot be undone in
+ * this structure, so they set the stale flag instead.
+ */
+
+/* Instance variables */
+
+	Graph<nodeT,arcT> *graph;   /* The graph being indexed                */
+	Vector<int> parent;         /* Parent of each node in its tree        */
+	Vector<int> treeSize;       /* Size of the tree for each root         */
+	int nComponents;            /* Number of components                   */
+	bool stale;                 /* True after a removal until rebuilt     */
+
+/* Private methods */
+
+	void rebuild();
+	void addNodes(int nNodes);
+	void merge(int i1, int i2);
+	int find(int index);
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(ComponentIndex)
+
+};
+
+#endif
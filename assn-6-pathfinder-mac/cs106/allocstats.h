@@ -0,0 +1,191 @@
+/*
+ * File: allocstats.h
+ * ------------------
+ * This interface exports the AllocStats class, which counts the heap
+ * allocations made by the container classes in this library, broken
+ * down by the kind of container and the purpose of the allocation.
+ * Counting is turned on by creating an AllocStats object and stays on
+ * until the last such object is destroyed, so a program that never
+ * creates one pays only for testing a flag on each allocation.  The
+ * typical use measures a single operation:
+ *
+ *     path.SetMap(graph);
+ *     path.SetStart(start);
+ *     path.SetFinish(finish);
+ *     AllocStats scope;
+ *     double distance = path.GetDistance();
+ *     scope.report();
+ *
+ * The counts cover the storage the containers allocate for themselves:
+ * the element arrays of Vector, Grid, and SmallSet, the cells of Map
+ * and Queue, the nodes of BST (and therefore of Set), the nodes and
+ * arcs created by Graph, and the iterators created by foreach.  Memory
+ * allocated by the elements themselves, such as the characters of a
+ * string, is not counted.  Containers built from other containers are
+ * charged to the container that actually allocates: the bucket array
+ * of a Map and the storage of a Stack appear as Vector storage.
+ */
+
+#ifndef _allocstats_h
+#define _allocstats_h
+
+#include <iostream>
+#include "genlib.h"
+#include "disallowcopy.h"
+
+/*
+ * Type: allocClassT
+ * -----------------
+ * This type identifies the container class that made an allocation.
+ */
+
+enum allocClassT {
+	ALLOC_VECTOR, ALLOC_GRID, ALLOC_SMALLSET, ALLOC_MAP, ALLOC_BST,
+	ALLOC_QUEUE, ALLOC_GRAPH, NUM_ALLOC_CLASSES
+};
+
+/*
+ * Type: allocSiteT
+ * ----------------
+ * This type identifies the purpose of an allocation:
+ *
+ *   ALLOC_STORAGE   An element array, allocated when a container is
+ *                   created, grows, or is copied.
+ *   ALLOC_CELL      A single linked cell, tree node, or graph object,
+ *                   allocated for each element added.
+ *   ALLOC_ITERATOR  The iterator allocated at the start of each
+ *                   foreach loop.
+ */
+
+enum allocSiteT {
+	ALLOC_STORAGE, ALLOC_CELL, ALLOC_ITERATOR, NUM_ALLOC_SITES
+};
+
+/*
+ * Type: allocCountsT
+ * ------------------
+ * This type holds the number of allocations and frees of one kind and
+ * the number of bytes each of them involved.
+ */
+
+struct allocCountsT {
+	long allocs;
+	long frees;
+	long bytesAllocated;
+	long bytesFreed;
+};
+
+/*
+ * Class: AllocStats
+ * -----------------
+ * Each AllocStats object reports the allocations made since it was
+ * created or last reset.  Objects may be nested, as when a benchmark
+ * measures a whole run and a test inside it measures a single query;
+ * each sees every allocation made during its own lifetime.
+ *
+ * The counters are shared by all threads and are not locked, so counts
+ * taken while several threads allocate may be slightly low.  Measure
+ * single-threaded operations when the exact numbers matter.
+ */
+
+class AllocStats {
+public:
+
+/*
+ * Constructor: AllocStats
+ * Usage: AllocStats scope;
+ * ------------------------
+ * Turns counting on, if it is not on already, and starts measuring
+ * from the current point.
+ */
+	AllocStats();
+
+/*
+ * Destructor: ~AllocStats
+ * Usage: (usually implicit)
+ * -------------------------
+ * Turns counting off unless another AllocStats object still exists.
+ */
+	~AllocStats();
+
+/*
+ * Method: reset
+ * Usage: scope.reset();
+ * ---------------------
+ * Starts measuring again from the current point, discarding the counts
+ * accumulated so far.
+ */
+	void reset();
+
+/*
+ * Method: getCounts
+ * Usage: allocCountsT counts = scope.getCounts();
+ *        allocCountsT counts = scope.getCounts(cls);
+ *        allocCountsT counts = scope.getCounts(cls, site);
+ * ----------------------------------------------------
+ * Returns the counts accumulated by this object, either in total, for
+ * one container class, or for one class and purpose.
+ */
+	allocCountsT getCounts();
+	allocCountsT getCounts(allocClassT cls);
+	allocCountsT getCounts(allocClassT cls, allocSiteT site);
+
+/*
+ * Method: getAllocCount
+ * Usage: if (scope.getAllocCount() > budget) . . .
+ * ------------------------------------------------
+ * Returns the total number of allocations made since this object was
+ * created or last reset, which is the number most useful for checking
+ * that an operation stays within an allocation budget.
+ */
+	long getAllocCount();
+
+/*
+ * Method: toString
+ * Usage: string str = scope.toString();
+ * -------------------------------------
+ * Returns a table with one line for each container class and purpose
+ * that has allocated or freed memory, followed by a line of totals.
+ */
+	string toString();
+
+/*
+ * Method: report
+ * Usage: scope.report();
+ *        scope.report(out);
+ * -------------------------
+ * Writes the table returned by toString to the specified stream, which
+ * is cout if none is given.
+ */
+	void report(ostream & out = cout);
+
+#include "private/allocstatspriv.h"
+
+};
+
+/*
+ * Functions: AllocStatsNoteAlloc, AllocStatsNoteFree, AllocStatsNoteIterator
+ * Usage: AllocStatsNoteAlloc(ALLOC_VECTOR, ALLOC_STORAGE, nBytes);
+ *        AllocStatsNoteFree(ALLOC_VECTOR, ALLOC_STORAGE, nBytes);
+ *        AllocStatsNoteIterator(ALLOC_VECTOR, nBytes);
+ * -------------------------------------------------------------------------
+ * These functions record an allocation or free if counting is on.  They
+ * are called by the container implementations.  The iterator that
+ * foreach allocates is freed at the end of the loop by FE_State, which
+ * is compiled into the library and cannot record the free itself, so
+ * AllocStatsNoteIterator records both at once.
+ *
+ * Graph records only the nodes and arcs it creates, but it frees every
+ * node and arc it contains.  A client that allocates its own nodes and
+ * arcs and passes them to addNode and addArc can keep the counts in
+ * balance by charging them with AllocStatsNoteAlloc(ALLOC_GRAPH,
+ * ALLOC_CELL, nBytes).
+ */
+
+void AllocStatsNoteAlloc(allocClassT cls, allocSiteT site, long nBytes);
+void AllocStatsNoteFree(allocClassT cls, allocSiteT site, long nBytes);
+void AllocStatsNoteIterator(allocClassT cls, long nBytes);
+
+#include "private/allocstatsimpl.cpp"
+
+#endif
@@ -14,6 +14,7 @@
 #include "genlib.h"
 #include "cmpfn.h"
 #include "stack.h"
+#include "allocstats.h"
 #include "foreach.h"
 
 /*
@@ -10,7 +10,9 @@
 #define _graph_h
 
 #include "set.h"
+#include "smallset.h"
 #include "map.h"
+#include "allocstats.h"
 
 /*
  * Comparison functions: NodeCompare, ArcCompare
@@ -25,6 +27,114 @@ int NodeCompare(NodeType *n1, NodeType *n2);
 template <typename NodeType,typename ArcType>
 int ArcCompare(ArcType *a1, ArcType *a2);
 
+/*
+ * Type: graphMemoryT
+ * ------------------
+ * This type reports the memory used by a graph, broken down by the
+ * purpose of the storage.  The Graph class fills in every field.  Other
+ * representations of a graph, such as a compact copy built for fast
+ * searching, report their memory in the same type and leave the fields
+ * that do not apply to them at zero, so that layouts can be compared
+ * side by side.  The fields are:
+ *
+ *   nodeBytes         The node structures themselves
+ *   arcBytes          The arc structures themselves
+ *   adjacencyBytes    Heap storage for the arcs leaving and entering
+ *                     each node, beyond what fits in the node itself
+ *   setBytes          The node and arc pointers held by the AVL trees
+ *                     of the node and arc sets
+ *   avlOverheadBytes  The child pointers and balance factors of those
+ *                     trees, along with any padding
+ *   bucketBytes       The bucket array of the map from names to nodes
+ *   cellBytes         The cells of that map
+ *   nameBytes         The characters of the node names and of the keys
+ *                     in the map, which some string implementations
+ *                     share or store inside the string object
+ *   indexBytes        The table of nodes by index and other bookkeeping
+ *   totalBytes        The sum of the fields above
+ *
+ * The bytesPerNode and bytesPerArc fields divide the total by the
+ * number of nodes and arcs.  None of the figures include the overhead
+ * of the memory allocator itself.
+ */
+
+struct graphMemoryT {
+	int nNodes;
+	int nArcs;
+	long nodeBytes;
+	long arcBytes;
+	long adjacencyBytes;
+	long setBytes;
+	long avlOverheadBytes;
+	long bucketBytes;
+	long cellBytes;
+	long nameBytes;
+	long indexBytes;
+	long totalBytes;
+	double bytesPerNode;
+	double bytesPerArc;
+};
+
+/*
+ * Function: GraphMemoryToString
+ * Usage: string str = GraphMemoryToString(stats);
+ * -----------------------------------------------
+ * Returns a table of the fields of stats, one per line, omitting the
+ * fields that are zero.
+ */
+
+string GraphMemoryToString(graphMemoryT & stats);
+
+/*
+ * Class: GraphListener<NodeType,ArcType>
+ * --------------------------------------
+ * This class is the base class for objects that keep data derived
+ * from a graph, such as a spatial index of its nodes, up to date as
+ * the graph changes.  After a listener is registered by calling the
+ * addListener method of the graph, the graph calls the appropriate
+ * method of the listener after each change:
+ *
+ *   nodeAdded         After a node has been added
+ *   nodeRemoved       Just before a node is removed and freed, by which
+ *                     time its arcs have already been removed
+ *   arcAdded          After an arc has been added
+ *   arcRemoved        After an arc has been removed
+ *   arcWeightChanged  After updateArcWeight has changed the distance of
+ *                     an arc, with the old distance as a second argument
+ *   graphReset        After the contents of the graph have been replaced
+ *                     by clear, assignment, or swap, or renumbered by
+ *                     reorderNodes
+ *
+ * The nodeAdded and arcAdded methods are called before addNode or
+ * addArc returns, so a node added by name, or an arc added by giving
+ * its endpoints, reaches the listeners with the default values of its
+ * other fields, such as a zero distance.  Because the client fills in
+ * those fields only afterward, these forms of addNode and addArc call
+ * markChanged an extra time before telling the listeners.  A listener
+ * that checks getPreviousVersion therefore treats the node or arc as a
+ * change it was not told about and rebuilds its data when next used,
+ * instead of bringing the data up to date from the default values.  A
+ * client can avoid the rebuild by creating the node or arc, filling it
+ * in, and passing it to addNode or addArc.
+ *
+ * The default implementation of each method does nothing, so a
+ * subclass overrides only the methods for the changes it cares about.
+ * Listeners must not add or remove nodes or arcs from within these
+ * methods.
+ */
+
+template <typename NodeType,typename ArcType>
+class GraphListener {
+public:
+	virtual ~GraphListener();
+	virtual void nodeAdded(NodeType *node);
+	virtual void nodeRemoved(NodeType *node);
+	virtual void arcAdded(ArcType *arc);
+	virtual void arcRemoved(ArcType *arc);
+	virtual void arcWeightChanged(ArcType *arc, double oldDistance);
+	virtual void graphReset();
+};
+
 /*
  * Class: Graph<NodeType,ArcType>
  * ------------------------------
@@ -37,7 +147,16 @@ int ArcCompare(ArcType *a1, ArcType *a2);
  *
  * The NodeType definition must include:
  *   - A string field called name
- *   - A Set<ArcType *> field called arcs
+ *   - A SmallSet<ArcType *> field called arcs
+ *   - A SmallSet<ArcType *> field called incoming
+ *   - An int field called index
+ *
+ * The arcs field holds the arcs that leave the node; the incoming field
+ * is maintained by the Graph package and holds the arcs that finish at
+ * the node, which allows arcs and nodes to be removed by looking only
+ * at the arcs that touch them.  The index field is also maintained by
+ * the Graph package and numbers the nodes densely from 0 to size() - 1,
+ * so that algorithms can keep per-node data in arrays.
  *
  * The ArcType definition must include:
  *   - A NodeType * field called start
@@ -49,6 +168,9 @@ class Graph {
 
 public:
 
+/* Forward references */
+	class NeighborIterator;
+
 /*
  * Constructor: Graph
  * Usage: Graph<NodeType,ArcType> g;
@@ -98,7 +220,8 @@ public:
  * creates a new node of the appropriate type and initializes its
  * fields; the second assumes that the client has already created
  * the node and simply adds it to the graph.  Both versions of this
- * method return a pointer to the node.
+ * method return a pointer to the node.  Listeners are told about the
+ * node before addNode returns, as described for GraphListener.
  */
 	NodeType *addNode(string name);
 	NodeType *addNode(NodeType *node);
@@ -110,7 +233,11 @@ public:
  * --------------------------
  * Removes a node from the graph, where the node can be specified
  * either by its name or as a pointer value.  Removing a node also
- * removes all arcs that contain that node.
+ * removes all arcs that contain that node.  The storage for the node
+ * and for those arcs is freed, and the node's name is removed from
+ * the name table, so that the node pointer must not be used again.
+ * The time required is proportional to the number of arcs that
+ * touch the node.
  */
 	void removeNode(string name);
 	void removeNode(NodeType *node);
@@ -133,6 +260,33 @@ public:
  */
 	bool nodeExists(string name);
 
+/*
+ * Method: getNodeByIndex
+ * Usage: NodeType *node = g.getNodeByIndex(index);
+ * ------------------------------------------------
+ * Returns the node whose index field has the specified value, which
+ * must be in the range [0, size()-1].  Node indices are stable while
+ * nodes are added, but removing a node moves the node with the
+ * highest index into the vacated position.
+ */
+	NodeType *getNodeByIndex(int index);
+
+/*
+ * Method: reorderNodes
+ * Usage: g.reorderNodes(order);
+ * -----------------------------
+ * Renumbers the nodes so that order[i] has index i.  The order vector
+ * must contain every node of the graph exactly once.  The arcs leaving
+ * each node are then put in order of the index of their finish nodes,
+ * and the arcs entering it in order of their start nodes, so that an
+ * algorithm that walks the arcs of a node visits its neighbors in the
+ * order in which they lie in any array indexed by node.  No nodes or
+ * arcs move in memory; copying the graph afterward allocates them in
+ * the new order, as described for the copy constructor.  Listeners
+ * are notified as though the graph had been cleared and refilled.
+ */
+	void reorderNodes(Vector<NodeType *> & order);
+
 /*
  * Method: addArc
  * Usage: g.addArc(s1, s2);
@@ -145,7 +299,8 @@ public:
  * client can create the arc structure explicitly and pass that
  * pointer to the addArc method.  All three of these versions
  * return a pointer to the arc in case the client needs to
- * capture this value.
+ * capture this value.  Listeners are told about the arc before
+ * addArc returns, as described for GraphListener.
  */
 	ArcType *addArc(string s1, string s2);
 	ArcType *addArc(NodeType *n1, NodeType *n2);
@@ -162,7 +317,10 @@ public:
  * pointers at its endpoints, or as an arc pointer.  Removing an
  * arc must remove it from the set of arcs in the entire graph as
  * well as the set leaving the start node.  If more than one arc
- * connects the specified endpoints, all of them are removed.
+ * connects the specified endpoints, all of them are removed.  The
+ * time required is proportional to the degree of the start node,
+ * and the arc structures themselves are not freed, so that a client
+ * that created an arc explicitly may add it again later.
  */
 	void removeArc(string s1, string s2);
 	void removeArc(NodeType *n1, NodeType *n2);
@@ -196,11 +354,24 @@ public:
  * --------------------------------------------------------
  * Returns the set of all arcs in the graph or, in the second and
  * third forms, the arcs that start at the specified node, which
- * can be indicated either as a pointer or by name.
+ * can be indicated either as a pointer or by name.  The arcs leaving
+ * a node are stored in a SmallSet, which keeps them in the order in
+ * which they were added.
  */
 	Set<ArcType *> & getArcSet();
-	Set<ArcType *> & getArcSet(NodeType *node);
-	Set<ArcType *> & getArcSet(string name);
+	SmallSet<ArcType *> & getArcSet(NodeType *node);
+	SmallSet<ArcType *> & getArcSet(string name);
+
+/*
+ * Method: getIncomingArcSet
+ * Usage: foreach (ArcType *arc in g.getIncomingArcSet(node)) . . .
+ *        foreach (ArcType *arc in g.getIncomingArcSet(name)) . . .
+ * ----------------------------------------------------------------
+ * Returns the set of arcs that finish at the specified node, which
+ * can be indicated either as a pointer or by name.
+ */
+	SmallSet<ArcType *> & getIncomingArcSet(NodeType *node);
+	SmallSet<ArcType *> & getIncomingArcSet(string name);
 
 /*
  * Method: getNeighbors
@@ -213,6 +384,117 @@ public:
 	Set<NodeType *> getNeighbors(NodeType *node);
 	Set<NodeType *> getNeighbors(string node);
 
+/*
+ * Method: neighbors
+ * Usage: Graph<NodeType,ArcType>::NeighborIterator iter = g.neighbors(node);
+ *        while (iter.hasNext()) {
+ *            NodeType *neighbor = iter.next();
+ *            . . .
+ *        }
+ * ------------------------------------------------------------------------
+ * Returns an iterator over the distinct nodes at the end of the arcs
+ * leaving the specified node.  Unlike getNeighbors, this method does
+ * not build a set: the iterator walks the node's arcs directly and
+ * allocates no storage, which makes it appropriate for algorithms that
+ * examine the neighbors of every node they visit.  Because neither the
+ * iterator nor the graph is modified during the walk, several threads
+ * may iterate over the neighbors of a graph that is no longer changing.
+ * The neighbors are returned in the order of the arcs that reach them.
+ */
+	NeighborIterator neighbors(NodeType *node);
+
+/*
+ * Method: forEachNeighbor
+ * Usage: g.forEachNeighbor(node, fn);
+ *        g.forEachNeighbor(node, fn, data);
+ * -----------------------------------------
+ * Calls fn once for each distinct neighbor of the specified node,
+ * passing along the client's data in the second form.  As with the
+ * neighbors method, no storage is allocated.
+ */
+	void forEachNeighbor(NodeType *node, void (*fn)(NodeType *neighbor));
+
+	template <typename ClientDataType>
+	void forEachNeighbor(NodeType *node,
+	                     void (*fn)(NodeType *neighbor, ClientDataType & data),
+	                     ClientDataType & data);
+
+/*
+ * Method: getVersion
+ * Usage: long version = g.getVersion();
+ * -------------------------------------
+ * Returns a number that changes whenever the graph changes.  A client
+ * that keeps data computed from the graph, such as a cache of shortest
+ * paths, can record the version at the time of the computation and
+ * discard the data when the version no longer matches.  Versions are
+ * never reused, even by different graphs, so a version also tells
+ * which graph the data came from.
+ */
+	long getVersion();
+
+/*
+ * Method: getPreviousVersion
+ * Usage: long version = g.getPreviousVersion();
+ * ---------------------------------------------
+ * Returns the version the graph had before the most recent call to
+ * markChanged.  Each method that tells the listeners about a change
+ * calls markChanged just before it does so.  A listener that records
+ * the version whenever its data matches the graph can therefore
+ * compare that version with this one: if they differ, the graph also
+ * changed in some way the listener was not told about, and the data
+ * must be rebuilt rather than brought up to date.
+ */
+	long getPreviousVersion();
+
+/*
+ * Method: markChanged
+ * Usage: g.markChanged();
+ * -----------------------
+ * Gives the graph a new version number.  The methods that add and
+ * remove nodes and arcs call markChanged themselves, but the graph has
+ * no way to notice when a client changes the fields of a node or arc
+ * directly.  A client that does so must call markChanged afterward.
+ * The distance of an arc is better changed by updateArcWeight, which
+ * calls markChanged itself.
+ */
+	void markChanged();
+
+/*
+ * Method: updateArcWeight
+ * Usage: g.updateArcWeight(arc, distance);
+ * ----------------------------------------
+ * Sets the distance field of the arc, which ArcType must declare as a
+ * double in order to use this method, calls markChanged, and then
+ * tells each listener about the change.  Unlike a change made to the
+ * field directly, a change made this way lets listeners that hold
+ * shortest paths repair them instead of discarding them.
+ */
+	void updateArcWeight(ArcType *arc, double distance);
+
+/*
+ * Method: memoryStats
+ * Usage: graphMemoryT stats = g.memoryStats();
+ * --------------------------------------------
+ * Returns the number of bytes used by the graph and the nodes and arcs
+ * it contains, as described in the comments for graphMemoryT.  The
+ * method examines every node, so it runs in linear time.
+ */
+	graphMemoryT memoryStats();
+
+/*
+ * Methods: addListener, removeListener
+ * Usage: g.addListener(listener);
+ *        g.removeListener(listener);
+ * ----------------------------------
+ * Registers or unregisters an object that is told about every change
+ * to the graph, as described in the comments for GraphListener.  The
+ * graph stores only the pointer, so the listener must be removed
+ * before it is destroyed.  Listeners are not copied along with the
+ * graph, and the graph does not notify them when it is destroyed.
+ */
+	void addListener(GraphListener<NodeType,ArcType> *listener);
+	void removeListener(GraphListener<NodeType,ArcType> *listener);
+
 private:
 
 #include "private/graphpriv.h"
@@ -32,6 +32,7 @@
 
 #include "genlib.h"
 #include "strutils.h"
+#include "allocstats.h"
 #include "foreach.h"
 
 /*
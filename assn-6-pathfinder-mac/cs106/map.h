@@ -12,6 +12,7 @@
 
 #include "genlib.h"
 #include "vector.h"
+#include "allocstats.h"
 #include "foreach.h"
 #include <string>
 #include <cstdlib>
@@ -0,0 +1,193 @@
+/*
+ * File: allocstatsimpl.cpp
+ * ------------------------
+ * This file contains the implementation of the allocstats.h interface.
+ * The functions are defined inline so that the hooks in the container
+ * templates compile to a single test when counting is off, and so that
+ * the interface needs no code outside the headers.
+ */
+
+#ifdef _allocstats_h
+
+#include <sstream>
+
+/*
+ * Type: allocTableT
+ * -----------------
+ * This type holds the running totals shared by every AllocStats object,
+ * together with the number of objects that currently exist.
+ */
+
+struct allocTableT {
+	int nActive;
+	allocCountsT counts[NUM_ALLOC_CLASSES][NUM_ALLOC_SITES];
+};
+
+/*
+ * Function: AllocStatsTable
+ * Usage: allocTableT & table = AllocStatsTable();
+ * -----------------------------------------------
+ * Returns the table of running totals.  The table is a static local
+ * variable of an inline function, which the language guarantees to be
+ * a single object in every file that includes this header.  Because
+ * the table contains no constructors, it is zeroed before the program
+ * starts rather than on first use.
+ */
+
+inline allocTableT & AllocStatsTable() {
+	static allocTableT table;
+	return table;
+}
+
+inline void AllocStatsNoteAlloc(allocClassT cls, allocSiteT site,
+                                long nBytes) {
+	allocTableT & table = AllocStatsTable();
+	if (table.nActive > 0) {
+		table.counts[cls][site].allocs++;
+		table.counts[cls][site].bytesAllocated += nBytes;
+	}
+}
+
+inline void AllocStatsNoteFree(allocClassT cls, allocSiteT site,
+                               long nBytes) {
+	allocTableT & table = AllocStatsTable();
+	if (table.nActive > 0) {
+		table.counts[cls][site].frees++;
+		table.counts[cls][site].bytesFreed += nBytes;
+	}
+}
+
+inline void AllocStatsNoteIterator(allocClassT cls, long nBytes) {
+	allocTableT & table = AllocStatsTable();
+	if (table.nActive > 0) {
+		table.counts[cls][ALLOC_ITERATOR].allocs++;
+		table.counts[cls][ALLOC_ITERATOR].bytesAllocated += nBytes;
+		table.counts[cls][ALLOC_ITERATOR].frees++;
+		table.counts[cls][ALLOC_ITERATOR].bytesFreed += nBytes;
+	}
+}
+
+inline AllocStats::AllocStats() {
+	AllocStatsTable().nActive++;
+	reset();
+}
+
+inline AllocStats::~AllocStats() {
+	AllocStatsTable().nActive--;
+}
+
+inline void AllocStats::reset() {
+	allocTableT & table = AllocStatsTable();
+	for (int i = 0; i < NUM_ALLOC_CLASSES; i++) {
+		for (int j = 0; j < NUM_ALLOC_SITES; j++) {
+			start[i][j] = table.counts[i][j];
+		}
+	}
+}
+
+inline allocCountsT AllocStats::getCounts() {
+	allocCountsT total = { 0, 0, 0, 0 };
+	for (int i = 0; i < NUM_ALLOC_CLASSES; i++) {
+		allocCountsT counts = getCounts(allocClassT(i));
+		total.allocs += counts.allocs;
+		total.frees += counts.frees;
+		total.bytesAllocated += counts.bytesAllocated;
+		total.bytesFreed += counts.bytesFreed;
+	}
+	return total;
+}
+
+inline allocCountsT AllocStats::getCounts(allocClassT cls) {
+	allocCountsT total = { 0, 0, 0, 0 };
+	for (int j = 0; j < NUM_ALLOC_SITES; j++) {
+		allocCountsT counts = difference(cls, allocSiteT(j));
+		total.allocs += counts.allocs;
+		total.frees += counts.frees;
+		total.bytesAllocated += counts.bytesAllocated;
+		total.bytesFreed += counts.bytesFreed;
+	}
+	return total;
+}
+
+inline allocCountsT AllocStats::getCounts(allocClassT cls,
+                                          allocSiteT site) {
+	return difference(cls, site);
+}
+
+inline long AllocStats::getAllocCount() {
+	return getCounts().allocs;
+}
+
+/*
+ * Function: AllocStatsWriteRow
+ * Usage: AllocStatsWriteRow(os, label, counts);
+ * ---------------------------------------------
+ * Writes one line of the table produced by toString.  The columns are
+ * aligned using the width method of the stream rather than the
+ * manipulators in <iomanip>, so this header needs only <sstream>.
+ */
+
+inline void AllocStatsWriteRow(ostream & os, string label,
+                               allocCountsT counts) {
+	os.setf(ios::left, ios::adjustfield);
+	os.width(20);
+	os << label;
+	os.setf(ios::right, ios::adjustfield);
+	os.width(10);
+	os << counts.allocs;
+	os.width(10);
+	os << counts.frees;
+	os.width(14);
+	os << counts.bytesAllocated;
+	os.width(14);
+	os << counts.bytesFreed << endl;
+}
+
+inline string AllocStats::toString() {
+	static const char *CLASS_NAMES[] = {
+		"Vector", "Grid", "SmallSet", "Map", "BST", "Queue", "Graph"
+	};
+	static const char *SITE_NAMES[] = { "storage", "cell", "iterator" };
+	ostringstream os;
+	os.setf(ios::left, ios::adjustfield);
+	os.width(20);
+	os << "Allocation";
+	os.setf(ios::right, ios::adjustfield);
+	os.width(10);
+	os << "allocs";
+	os.width(10);
+	os << "frees";
+	os.width(14);
+	os << "bytes";
+	os.width(14);
+	os << "bytes freed" << endl;
+	for (int i = 0; i < NUM_ALLOC_CLASSES; i++) {
+		for (int j = 0; j < NUM_ALLOC_SITES; j++) {
+			allocCountsT counts = difference(allocClassT(i), allocSiteT(j));
+			if (counts.allocs != 0 || counts.frees != 0) {
+				AllocStatsWriteRow(os, string(CLASS_NAMES[i]) + " "
+				                       + SITE_NAMES[j], counts);
+			}
+		}
+	}
+	AllocStatsWriteRow(os, "Total", getCounts());
+	return os.str();
+}
+
+inline void AllocStats::report(ostream & out) {
+	out << toString();
+}
+
+inline allocCountsT AllocStats::difference(allocClassT cls,
+                                           allocSiteT site) {
+	allocCountsT now = AllocStatsTable().counts[cls][site];
+	allocCountsT result;
+	result.allocs = now.allocs - start[cls][site].allocs;
+	result.frees = now.frees - start[cls][site].frees;
+	result.bytesAllocated = now.bytesAllocated
+	                      - start[cls][site].bytesAllocated;
+	result.bytesFreed = now.bytesFreed - start[cls][site].bytesFreed;
+	return result;
+}
+
+#endif
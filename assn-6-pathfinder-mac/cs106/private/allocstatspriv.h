@@ -0,0 +1,32 @@
+/*
+ * File: allocstatspriv.h
+ * ----------------------
+ * This file contains the private section of the allocstats.h interface.
+ * This portion of the class definition is taken out of the allocstats.h
+ * header so that the client need not have to see all of these
+ * details.
+ */
+
+private:
+
+/*
+ * Implementation notes: counting
+ * ------------------------------
+ * The library keeps a single table of running totals, which grow for
+ * as long as any AllocStats object exists.  Each object copies the
+ * table when it starts measuring and reports the difference between
+ * the current table and that copy, which is what allows objects to
+ * nest without interfering with one another.
+ */
+
+/* Instance variables */
+
+	allocCountsT start[NUM_ALLOC_CLASSES][NUM_ALLOC_SITES];
+
+/* Private method prototypes */
+
+	allocCountsT difference(allocClassT cls, allocSiteT site);
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(AllocStats)
@@ -27,6 +27,7 @@ void BST<ElemType>::recDeleteTree(nodeT * t) {
 	if (t != NULL) {
 		recDeleteTree(t->left);
 		recDeleteTree(t->right);
+		AllocStatsNoteFree(ALLOC_BST, ALLOC_CELL, sizeof(nodeT));
 		delete t;
 	}
 }
@@ -109,6 +110,7 @@ bool BST<ElemType>::recAddNode(nodeT * & t, ElemType & data,
                                bool & createdNewNode) {
 	if (t == NULL) {
 		t = new nodeT;
+		AllocStatsNoteAlloc(ALLOC_BST, ALLOC_CELL, sizeof(nodeT));
 		t->data = data;
 		t->bf = BST_IN_BALANCE;
 		t->left = t->right = NULL;
@@ -335,11 +337,13 @@ bool BST<ElemType>::removeTargetNode(nodeT *  & t) {
 	nodeT *toDelete = t;
 	if (t->left == NULL) {          /* No left child, replace with right */
 		t = t->right;
+		AllocStatsNoteFree(ALLOC_BST, ALLOC_CELL, sizeof(nodeT));
 		delete toDelete;
 		numNodes--;
 		return true;
 	} else if (t->right == NULL) {  /* No right child, replace with left */
 		t = t->left;
+		AllocStatsNoteFree(ALLOC_BST, ALLOC_CELL, sizeof(nodeT));
 		delete toDelete;
 		numNodes--;
 		return true;
@@ -444,6 +448,67 @@ void BST<ElemType>::copyOtherEntries(const BST & constRhs) {
 	numNodes = rhs.numNodes;
 }
 
+/*
+ * Implementation notes: rebuildFromSorted, recBuildTree
+ * -----------------------------------------------------
+ * The recBuildTree method builds a perfectly balanced tree from the
+ * half-open index range [lo, hi) by choosing the middle element as
+ * the root and building the two halves recursively.  Because the
+ * halves differ in size by at most one, their heights differ by at
+ * most one as well, which means that the subtree heights returned
+ * through the reference parameter are enough to set the AVL balance
+ * factor in each node.
+ */
+
+template <typename ElemType>
+void BST<ElemType>::rebuildFromSorted(Vector<ElemType> & sorted) {
+	clear();
+	int height;
+	root = recBuildTree(sorted, 0, sorted.size(), height);
+	numNodes = sorted.size();
+	timestamp++;
+}
+
+template <typename ElemType>
+typename BST<ElemType>::nodeT *BST<ElemType>::recBuildTree(
+	                        Vector<ElemType> & sorted, int lo, int hi,
+	                        int & height) {
+	if (lo >= hi) {
+		height = 0;
+		return NULL;
+	}
+	int mid = (lo + hi) / 2;
+	int leftHeight, rightHeight;
+	nodeT *t = new nodeT;
+	AllocStatsNoteAlloc(ALLOC_BST, ALLOC_CELL, sizeof(nodeT));
+	t->data = sorted[mid];
+	t->left = recBuildTree(sorted, lo, mid, leftHeight);
+	t->right = recBuildTree(sorted, mid + 1, hi, rightHeight);
+	t->bf = rightHeight - leftHeight;
+	height = 1 + ((leftHeight > rightHeight) ? leftHeight : rightHeight);
+	return t;
+}
+
+template <typename ElemType>
+void BST<ElemType>::swap(BST & other) {
+	nodeT *tmpRoot = root;
+	root = other.root;
+	other.root = tmpRoot;
+	int tmpNodes = numNodes;
+	numNodes = other.numNodes;
+	other.numNodes = tmpNodes;
+	int (*tmpCmp)(ElemType, ElemType) = cmpFn;
+	cmpFn = other.cmpFn;
+	other.cmpFn = tmpCmp;
+	timestamp++;
+	other.timestamp++;
+}
+
+template <typename ElemType>
+long BST<ElemType>::getHeapBytes() {
+	return long(numNodes) * sizeof(nodeT);
+}
+
 /*
  * BST::Iterator class implementation
  */
@@ -521,7 +586,10 @@ void BST<ElemType>::Iterator::findLeftmostChild() {
 
 template <typename ElemType>
 ElemType BST<ElemType>::foreachHook(FE_State & fe) {
-	if (fe.state == 0) fe.iter = new Iterator(this);
+	if (fe.state == 0) {
+		fe.iter = new Iterator(this);
+		AllocStatsNoteIterator(ALLOC_BST, sizeof(Iterator));
+	}
 	if (((Iterator *) fe.iter)->hasNext()) {
 		fe.state = 1;
 		return ((Iterator *) fe.iter)->next();
@@ -56,6 +56,37 @@ public:
         const BST & operator=(const BST & rhs);
         BST(const BST & rhs);
 
+/*
+ * Bulk loading support
+ * --------------------
+ * The rebuildFromSorted method replaces the contents of the tree with
+ * the elements in the vector, which must already be in strictly
+ * increasing order according to the comparison function.  The tree
+ * is built directly in perfectly balanced form, so the operation runs
+ * in linear time instead of the O(N log N) required by repeated calls
+ * to add.  The Set class uses this method to implement its algebraic
+ * operations as linear merges.
+ */
+        void rebuildFromSorted(Vector<ElemType> & sorted);
+
+/*
+ * Constant-time exchange support
+ * ------------------------------
+ * The swap method exchanges the contents of this tree, including its
+ * comparison function, with those of another tree without copying
+ * any nodes.  Any iterators on either tree are invalidated.
+ */
+        void swap(BST & other);
+
+/*
+ * Memory accounting support
+ * -------------------------
+ * The getHeapBytes method returns the number of bytes of heap storage
+ * held by this tree in its nodes, not counting any storage that the elements
+ * themselves allocate.
+ */
+        long getHeapBytes();
+
 private:
 
 /* Type definition for node in the tree */
@@ -89,6 +120,8 @@ private:
         void rotateRight(nodeT * & t);
         void rotateLeft(nodeT * & t);
         void copyOtherEntries(const BST & other);
+        nodeT *recBuildTree(Vector<ElemType> & sorted, int lo, int hi,
+                            int & height);
 
 /* Template method prototypes */
 
@@ -56,13 +56,15 @@ int ArcCompare(ArcType *a1, ArcType *a2) {
  * ---------------------------------------
  * Even though the body of the Graph constructor is empty, important
  * work is done by the initializers, which ensure that the nodes and
- * arcs set are given the correct comparison functions.
+ * arcs set are given the correct comparison functions.  The copy
+ * constructor uses the same initializers.
  */
 
 template <typename NodeType,typename ArcType>
 Graph<NodeType,ArcType>::Graph() : nodes(NodeCompare<NodeType>),
                                    arcs(ArcCompare<NodeType,ArcType>) {
-	/* Empty */
+	version = 0;
+	markChanged();
 }
 
 /*
@@ -71,11 +73,13 @@ Graph<NodeType,ArcType>::Graph() : nodes(NodeCompare<NodeType>),
  * The destructor must free all heap storage used by this graph to
  * represent the nodes and arcs.  The clear metho must also reclaim
  * this memory, which means that the destructor can simply call
- * clear to do the work.
+ * clear to do the work.  The listeners are dropped first so that
+ * they are not told about the destruction of the graph.
  */
 
 template <typename NodeType,typename ArcType>
 Graph<NodeType,ArcType>::~Graph() {
+	listeners.clear();
 	clear();
 }
 
@@ -108,14 +112,21 @@ bool Graph<NodeType,ArcType>::isEmpty() {
 template <typename NodeType,typename ArcType>
 void Graph<NodeType,ArcType>::clear() {
 	foreach (NodeType *node in nodes) {
+		AllocStatsNoteFree(ALLOC_GRAPH, ALLOC_CELL, sizeof(NodeType));
 		delete node;
 	}
 	foreach (ArcType *arc in arcs) {
+		AllocStatsNoteFree(ALLOC_GRAPH, ALLOC_CELL, sizeof(ArcType));
 		delete arc;
 	}
 	arcs.clear();
 	nodes.clear();
 	nodeMap.clear();
+	nodeTable.clear();
+	markChanged();
+	for (int i = 0; i < listeners.size(); i++) {
+		listeners[i]->graphReset();
+	}
 }
 
 /*
@@ -124,15 +135,19 @@ void Graph<NodeType,ArcType>::clear() {
  * The addNode method appears in two forms: one that creates a node
  * from its name and one that assumes that the client has created
  * the new node.  In each case, the implementation must add the node
- * the set of nodes for the graph and add the name-to-node association
- * to the node map.
+ * the set of nodes for the graph, add the name-to-node association
+ * to the node map, and assign the node the next free index.  The
+ * first form calls markChanged before passing the node on, because
+ * the client fills in the other fields only after addNode returns, as
+ * described for GraphListener.
  */
 
 template <typename NodeType,typename ArcType>
 NodeType *Graph<NodeType,ArcType>::addNode(string name) {
 	NodeType *node = new NodeType();
-	node->arcs = Set<ArcType *>(ArcCompare<NodeType,ArcType>);
+	AllocStatsNoteAlloc(ALLOC_GRAPH, ALLOC_CELL, sizeof(NodeType));
 	node->name = name;
+	markChanged();
 	return addNode(node);
 }
 
@@ -143,6 +158,12 @@ NodeType *Graph<NodeType,ArcType>::addNode(NodeType *node) {
 	}
 	nodes.add(node);
 	nodeMap[node->name] = node;
+	node->index = nodeTable.size();
+	nodeTable.add(node);
+	markChanged();
+	for (int i = 0; i < listeners.size(); i++) {
+		listeners[i]->nodeAdded(node);
+	}
 	return node;
 }
 
@@ -150,9 +171,14 @@ NodeType *Graph<NodeType,ArcType>::addNode(NodeType *node) {
  * Implementation notes: removeNode
  * --------------------------------
  * The removeNode method must remove the specified node but must
- * also remove any arcs in the graph containing the node.  To avoid
- * changing the node set during iteration, this implementation creates
- * a vector of arcs that require deletion.
+ * also remove any arcs in the graph containing the node.  Those arcs
+ * are exactly the ones in the node's outgoing and incoming sets, so
+ * there is no need to look at the rest of the graph.  To avoid
+ * changing those sets during iteration, this implementation copies
+ * the arcs that require deletion into a vector.  A self-loop appears
+ * in both sets and is collected only once.  The last node in the
+ * index table moves into the position of the removed node, which
+ * keeps the indices dense.
  */
 
 template <typename NodeType,typename ArcType>
@@ -162,22 +188,37 @@ void Graph<NodeType,ArcType>::removeNode(string name) {
 
 template <typename NodeType,typename ArcType>
 void Graph<NodeType,ArcType>::removeNode(NodeType *node) {
-	Vector<ArcType *> toRemove;
-	foreach (ArcType *arc in arcs) {
-		if (arc->start == node || arc->finish == node) {
-			toRemove.add(arc);
-		}
+	Vector<ArcType *> toRemove(node->arcs.size() + node->incoming.size());
+	for (int i = 0; i < node->arcs.size(); i++) {
+		toRemove.add(node->arcs[i]);
 	}
-	foreach (ArcType *arc in toRemove) {
-		removeArc(arc);
+	for (int i = 0; i < node->incoming.size(); i++) {
+		ArcType *arc = node->incoming[i];
+		if (arc->start != node) toRemove.add(arc);
+	}
+	for (int i = 0; i < toRemove.size(); i++) {
+		removeArc(toRemove[i]);
+		AllocStatsNoteFree(ALLOC_GRAPH, ALLOC_CELL, sizeof(ArcType));
+		delete toRemove[i];
+	}
+	markChanged();
+	for (int i = 0; i < listeners.size(); i++) {
+		listeners[i]->nodeRemoved(node);
 	}
 	nodes.remove(node);
+	nodeMap.remove(node->name);
+	NodeType *last = nodeTable[nodeTable.size() - 1];
+	last->index = node->index;
+	nodeTable[node->index] = last;
+	nodeTable.removeAt(nodeTable.size() - 1);
+	AllocStatsNoteFree(ALLOC_GRAPH, ALLOC_CELL, sizeof(NodeType));
+	delete node;
 }
 
 /*
- * Implementation notes: getNode, nodeExists
- * -----------------------------------------
- * These methods provide access to the node map in the graph.
+ * Implementation notes: getNode, nodeExists, getNodeByIndex
+ * ---------------------------------------------------------
+ * These methods provide access to the node map and the index table.
  */
 
 template <typename NodeType,typename ArcType>
@@ -191,12 +232,63 @@ bool Graph<NodeType,ArcType>::nodeExists(string name) {
 	return nodeMap.containsKey(name);
 }
 
+template <typename NodeType,typename ArcType>
+NodeType *Graph<NodeType,ArcType>::getNodeByIndex(int index) {
+	return nodeTable[index];
+}
+
+/*
+ * Implementation notes: reorderNodes
+ * ----------------------------------
+ * The order is checked before anything changes, using the fact that a
+ * node belongs to this graph exactly when the index table holds it at
+ * its own index.  A second vector marks the nodes already seen, which
+ * catches duplicates.  The node and arc sets and the name map do not
+ * depend on the indices, so only the index table and the adjacency
+ * sets need to be rebuilt.
+ */
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::reorderNodes(Vector<NodeType *> & order) {
+	int nNodes = nodeTable.size();
+	if (order.size() != nNodes) {
+		Error("reorderNodes: The order must contain every node once");
+	}
+	Vector<bool> seen(nNodes);
+	for (int i = 0; i < nNodes; i++) {
+		seen.add(false);
+	}
+	for (int i = 0; i < nNodes; i++) {
+		NodeType *node = order[i];
+		int index = node->index;
+		if (index < 0 || index >= nNodes || nodeTable[index] != node
+		    || seen[index]) {
+			Error("reorderNodes: The order must contain every node once");
+		}
+		seen[index] = true;
+	}
+	for (int i = 0; i < nNodes; i++) {
+		order[i]->index = i;
+		nodeTable[i] = order[i];
+	}
+	Vector<ArcType *> buffer;
+	for (int i = 0; i < nNodes; i++) {
+		sortArcsByIndex(nodeTable[i]->arcs, true, buffer);
+		sortArcsByIndex(nodeTable[i]->incoming, false, buffer);
+	}
+	markChanged();
+	for (int i = 0; i < listeners.size(); i++) {
+		listeners[i]->graphReset();
+	}
+}
+
 /*
  * Implementation notes: addArc
  * ----------------------------
  * The addArc method appears in three forms, as described in the
  * interface.  The code for each form of the method, however, is
- * quite straightforward.
+ * quite straightforward.  The forms that create the arc call
+ * markChanged before passing it on, for the same reason as addNode.
  */
 
 template <typename NodeType,typename ArcType>
@@ -207,15 +299,22 @@ ArcType *Graph<NodeType,ArcType>::addArc(string s1, string s2) {
 template <typename NodeType,typename ArcType>
 ArcType *Graph<NodeType,ArcType>::addArc(NodeType *n1, NodeType *n2) {
 	ArcType *arc = new ArcType();
+	AllocStatsNoteAlloc(ALLOC_GRAPH, ALLOC_CELL, sizeof(ArcType));
 	arc->start = n1;
 	arc->finish = n2;
+	markChanged();
 	return addArc(arc);
 }
 
 template <typename NodeType,typename ArcType>
 ArcType *Graph<NodeType,ArcType>::addArc(ArcType *arc) {
 	arc->start->arcs.add(arc);
+	arc->finish->incoming.add(arc);
 	arcs.add(arc);
+	markChanged();
+	for (int i = 0; i < listeners.size(); i++) {
+		listeners[i]->arcAdded(arc);
+	}
 	return arc;
 }
 
@@ -223,11 +322,13 @@ ArcType *Graph<NodeType,ArcType>::addArc(ArcType *arc) {
  * Implementation notes: removeArc
  * -------------------------------
  * These methods remove arcs from the graph, which is ordinarily simply
- * a matter of removing the arc from two sets: the set of arcs in the
- * graph as a whole and the set of arcs in the starting node.  The
- * methods that remove an arc specified by its endpoints, however,
- * must take account of the fact that there might be more than one
- * such arc and delete all of them.
+ * a matter of removing the arc from three sets: the set of arcs in the
+ * graph as a whole, the set of arcs leaving the starting node, and the
+ * set of arcs entering the finishing node.  The methods that remove an
+ * arc specified by its endpoints, however, must take account of the
+ * fact that there might be more than one such arc and delete all of
+ * them.  Every such arc leaves n1, so only that node's arcs need to
+ * be examined.
  */
 
 template <typename NodeType,typename ArcType>
@@ -238,20 +339,24 @@ void Graph<NodeType,ArcType>::removeArc(string s1, string s2) {
 template <typename NodeType,typename ArcType>
 void Graph<NodeType,ArcType>::removeArc(NodeType *n1, NodeType *n2) {
 	Vector<ArcType *> toRemove;
-	foreach (ArcType *arc in arcs) {
-		if (arc->start == n1 && arc->finish == n2) {
-			toRemove.add(arc);
-		}
+	for (int i = 0; i < n1->arcs.size(); i++) {
+		ArcType *arc = n1->arcs[i];
+		if (arc->finish == n2) toRemove.add(arc);
 	}
-	foreach (ArcType *arc in toRemove) {
-		removeArc(arc);
+	for (int i = 0; i < toRemove.size(); i++) {
+		removeArc(toRemove[i]);
 	}
 }
 
 template <typename NodeType,typename ArcType>
 void Graph<NodeType,ArcType>::removeArc(ArcType *arc) {
 	arc->start->arcs.remove(arc);
+	arc->finish->incoming.remove(arc);
 	arcs.remove(arc);
+	markChanged();
+	for (int i = 0; i < listeners.size(); i++) {
+		listeners[i]->arcRemoved(arc);
+	}
 }
 
 /*
@@ -259,13 +364,16 @@ void Graph<NodeType,ArcType>::removeArc(ArcType *arc) {
  * ---------------------------------
  * Node n1 is connected to n2 if any of the arcs leaving n1 finish at n2.
  * The two versions of this method allow nodes to be specified either as
- * node pointers or by name.
+ * node pointers or by name.  The scan indexes the SmallSet directly,
+ * which avoids allocating the iterator that foreach would create.
  */
 
 template <typename NodeType,typename ArcType>
 bool Graph<NodeType,ArcType>::isConnected(NodeType *n1, NodeType *n2) {
-	foreach (ArcType *arc in n1->arcs) {
-		if (arc->finish == n2) return true;
+	SmallSet<ArcType *> & outgoing = n1->arcs;
+	int nArcs = outgoing.size();
+	for (int i = 0; i < nArcs; i++) {
+		if (outgoing[i]->finish == n2) return true;
 	}
 	return false;
 }
@@ -276,8 +384,8 @@ bool Graph<NodeType,ArcType>::isConnected(string s1, string s2) {
 }
 
 /*
- * Implementation notes: getNodeSet, getArcSet
- * -------------------------------------------
+ * Implementation notes: getNodeSet, getArcSet, getIncomingArcSet
+ * --------------------------------------------------------------
  * These methods simply return the set requested by the client.  The
  * sets are returned by reference for efficiency, because doing so
  * eliminates the need to copy the set.
@@ -294,27 +402,41 @@ Set<ArcType *> & Graph<NodeType,ArcType>::getArcSet() {
 }
 
 template <typename NodeType,typename ArcType>
-Set<ArcType *> & Graph<NodeType,ArcType>::getArcSet(NodeType *node) {
+SmallSet<ArcType *> & Graph<NodeType,ArcType>::getArcSet(NodeType *node) {
 	return node->arcs;
 }
 
 template <typename NodeType,typename ArcType>
-Set<ArcType *> & Graph<NodeType,ArcType>::getArcSet(string name) {
+SmallSet<ArcType *> & Graph<NodeType,ArcType>::getArcSet(string name) {
 	return getArcSet(getNode(name));
 }
 
+template <typename NodeType,typename ArcType>
+SmallSet<ArcType *> &
+                Graph<NodeType,ArcType>::getIncomingArcSet(NodeType *node) {
+	return node->incoming;
+}
+
+template <typename NodeType,typename ArcType>
+SmallSet<ArcType *> & Graph<NodeType,ArcType>::getIncomingArcSet(string name) {
+	return getIncomingArcSet(getNode(name));
+}
+
 /*
  * Implementation notes: getNeighbors
  * ----------------------------------
  * This implementation recomputes the set each time, which is reasonably
- * efficient if the degree of the node is small.
+ * efficient if the degree of the node is small.  Clients that do not
+ * need an actual set should use neighbors or forEachNeighbor instead,
+ * which avoid building and copying the set.
  */
 
 template <typename NodeType,typename ArcType>
 Set<NodeType *> Graph<NodeType,ArcType>::getNeighbors(NodeType *node) {
 	Set<NodeType *> nodes(NodeCompare<NodeType>);
-	foreach (ArcType *arc in node->arcs) {
-		nodes.add(arc->finish);
+	NeighborIterator iter = neighbors(node);
+	while (iter.hasNext()) {
+		nodes.add(iter.next());
 	}
 	return nodes;
 }
@@ -325,10 +447,319 @@ Set<NodeType *> Graph<NodeType,ArcType>::getNeighbors(string name) {
 }
 
 /*
- * Implementation notes: operator=, copy constructor
+ * Implementation notes: neighbors, forEachNeighbor
+ * ------------------------------------------------
+ * These methods avoid allocation by indexing the node's arcs in place.
+ * An arc contributes a neighbor only if no earlier arc in the same set
+ * finishes at the same node.  That test is quadratic in the degree of
+ * the node, which is cheaper than building a set for the small degrees
+ * that occur in practice.
+ */
+
+template <typename NodeType,typename ArcType>
+typename Graph<NodeType,ArcType>::NeighborIterator
+         Graph<NodeType,ArcType>::neighbors(NodeType *node) {
+	return NeighborIterator(&node->arcs);
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::forEachNeighbor(NodeType *node,
+                                              void (*fn)(NodeType *)) {
+	SmallSet<ArcType *> & outgoing = node->arcs;
+	int nArcs = outgoing.size();
+	for (int i = 0; i < nArcs; i++) {
+		if (isFirstArcToFinish(outgoing, i)) fn(outgoing[i]->finish);
+	}
+}
+
+template <typename NodeType,typename ArcType>
+template <typename ClientDataType>
+void Graph<NodeType,ArcType>::forEachNeighbor(NodeType *node,
+                               void (*fn)(NodeType *, ClientDataType &),
+                               ClientDataType & data) {
+	SmallSet<ArcType *> & outgoing = node->arcs;
+	int nArcs = outgoing.size();
+	for (int i = 0; i < nArcs; i++) {
+		if (isFirstArcToFinish(outgoing, i)) fn(outgoing[i]->finish, data);
+	}
+}
+
+/*
+ * Implementation notes: getVersion, getPreviousVersion, markChanged
+ * -----------------------------------------------------------------
+ * Version numbers come from a counter shared by every graph of the
+ * same type, which ensures that no two graphs ever have the same
+ * version.  The counter is incremented atomically, because threads
+ * may change different graphs at the same time.  The constructors and
+ * the methods that change the structure of the graph all call
+ * markChanged, and the methods that tell the listeners about a change
+ * call it just before they do so.
+ */
+
+template <typename NodeType,typename ArcType>
+long Graph<NodeType,ArcType>::lastVersion = 0;
+
+template <typename NodeType,typename ArcType>
+long Graph<NodeType,ArcType>::getVersion() {
+	return version;
+}
+
+template <typename NodeType,typename ArcType>
+long Graph<NodeType,ArcType>::getPreviousVersion() {
+	return previousVersion;
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::markChanged() {
+	previousVersion = version;
+	version = __sync_add_and_fetch(&lastVersion, 1);
+}
+
+/*
+ * Implementation notes: updateArcWeight
+ * -------------------------------------
+ * The version changes before the listeners are called, so that a
+ * listener that records the version after bringing its own data up to
+ * date records the new one.
+ */
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::updateArcWeight(ArcType *arc, double distance) {
+	double oldDistance = arc->distance;
+	arc->distance = distance;
+	markChanged();
+	for (int i = 0; i < listeners.size(); i++) {
+		listeners[i]->arcWeightChanged(arc, oldDistance);
+	}
+}
+
+/*
+ * Implementation notes: memoryStats
+ * ---------------------------------
+ * The sizes of the node and arc structures are known at compile time,
+ * so the only per-node work is adding up the heap storage of the arc
+ * sets and the lengths of the names.  A node set or arc set holds one
+ * pointer per element, and everything else in its tree nodes counts
+ * as AVL overhead.  Each name is stored twice, once in the node and
+ * once as a key in the node map.
+ */
+
+template <typename NodeType,typename ArcType>
+graphMemoryT Graph<NodeType,ArcType>::memoryStats() {
+	graphMemoryT stats;
+	stats.nNodes = nodeTable.size();
+	stats.nArcs = arcs.size();
+	stats.nodeBytes = long(stats.nNodes) * sizeof(NodeType);
+	stats.arcBytes = long(stats.nArcs) * sizeof(ArcType);
+	stats.adjacencyBytes = 0;
+	stats.nameBytes = 0;
+	for (int i = 0; i < stats.nNodes; i++) {
+		NodeType *node = nodeTable[i];
+		stats.adjacencyBytes += node->arcs.getHeapBytes()
+		                      + node->incoming.getHeapBytes();
+		stats.nameBytes += 2 * (node->name.length() + 1);
+	}
+	stats.setBytes = long(stats.nNodes) * sizeof(NodeType *)
+	               + long(stats.nArcs) * sizeof(ArcType *);
+	stats.avlOverheadBytes = nodes.getHeapBytes() + arcs.getHeapBytes()
+	                       - stats.setBytes;
+	stats.bucketBytes = nodeMap.getBucketBytes();
+	stats.cellBytes = nodeMap.getHeapBytes() - stats.bucketBytes;
+	stats.indexBytes = nodeTable.getHeapBytes() + listeners.getHeapBytes();
+	stats.totalBytes = stats.nodeBytes + stats.arcBytes
+	                 + stats.adjacencyBytes + stats.setBytes
+	                 + stats.avlOverheadBytes + stats.bucketBytes
+	                 + stats.cellBytes + stats.nameBytes + stats.indexBytes;
+	stats.bytesPerNode = (stats.nNodes == 0) ? 0
+	                   : double(stats.totalBytes) / stats.nNodes;
+	stats.bytesPerArc = (stats.nArcs == 0) ? 0
+	                  : double(stats.totalBytes) / stats.nArcs;
+	return stats;
+}
+
+/*
+ * Implementation notes: addListener, removeListener
  * -------------------------------------------------
+ * The listeners are kept in a vector, which the methods that change
+ * the graph walk after each change.  A graph rarely has more than one
+ * or two listeners, so removal uses a linear search.
+ */
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::addListener(GraphListener<NodeType,ArcType> *listener) {
+	listeners.add(listener);
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::removeListener(GraphListener<NodeType,ArcType> *listener) {
+	for (int i = 0; i < listeners.size(); i++) {
+		if (listeners[i] == listener) {
+			listeners.removeAt(i);
+			return;
+		}
+	}
+}
+
+/*
+ * Implementation notes: GraphListener
+ * -----------------------------------
+ * The methods of the base class do nothing, which allows subclasses to
+ * override only the ones they need.
+ */
+
+template <typename NodeType,typename ArcType>
+GraphListener<NodeType,ArcType>::~GraphListener() {
+	/* Empty */
+}
+
+template <typename NodeType,typename ArcType>
+void GraphListener<NodeType,ArcType>::nodeAdded(NodeType *) {
+	/* Empty */
+}
+
+template <typename NodeType,typename ArcType>
+void GraphListener<NodeType,ArcType>::nodeRemoved(NodeType *) {
+	/* Empty */
+}
+
+template <typename NodeType,typename ArcType>
+void GraphListener<NodeType,ArcType>::arcAdded(ArcType *) {
+	/* Empty */
+}
+
+template <typename NodeType,typename ArcType>
+void GraphListener<NodeType,ArcType>::arcRemoved(ArcType *) {
+	/* Empty */
+}
+
+template <typename NodeType,typename ArcType>
+void GraphListener<NodeType,ArcType>::arcWeightChanged(ArcType *, double) {
+	/* Empty */
+}
+
+template <typename NodeType,typename ArcType>
+void GraphListener<NodeType,ArcType>::graphReset() {
+	/* Empty */
+}
+
+/*
+ * Private method: isFirstArcToFinish
+ * Usage: if (isFirstArcToFinish(arcs, i)) . . .
+ * ---------------------------------------------
+ * Returns true if no arc before index i in the set finishes at the
+ * same node as the arc at index i.
+ */
+
+template <typename NodeType,typename ArcType>
+bool Graph<NodeType,ArcType>::isFirstArcToFinish(SmallSet<ArcType *> & arcs,
+                                                 int index) {
+	NodeType *finish = arcs[index]->finish;
+	for (int i = 0; i < index; i++) {
+		if (arcs[i]->finish == finish) return false;
+	}
+	return true;
+}
+
+/*
+ * Graph::NeighborIterator class implementation
+ * --------------------------------------------
+ * The iterator keeps a pointer to the arc set and the index of the
+ * next arc that leads to a neighbor not yet returned.
+ */
+
+template <typename NodeType,typename ArcType>
+Graph<NodeType,ArcType>::NeighborIterator::NeighborIterator() {
+	arcsp = NULL;
+}
+
+template <typename NodeType,typename ArcType>
+Graph<NodeType,ArcType>::NeighborIterator::NeighborIterator(
+                                         SmallSet<ArcType *> *arcsptr) {
+	arcsp = arcsptr;
+	curIndex = 0;
+	advanceToDistinctNeighbor();
+}
+
+template <typename NodeType,typename ArcType>
+bool Graph<NodeType,ArcType>::NeighborIterator::hasNext() {
+	if (arcsp == NULL) Error("hasNext called on uninitialized iterator");
+	return curIndex < arcsp->size();
+}
+
+template <typename NodeType,typename ArcType>
+NodeType *Graph<NodeType,ArcType>::NeighborIterator::next() {
+	if (!hasNext()) {
+		Error("Attempt to get next from iterator"
+		      " where hasNext() is false");
+	}
+	NodeType *result = (*arcsp)[curIndex]->finish;
+	curIndex++;
+	advanceToDistinctNeighbor();
+	return result;
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::NeighborIterator::advanceToDistinctNeighbor() {
+	while (curIndex < arcsp->size()
+	       && !isFirstArcToFinish(*arcsp, curIndex)) {
+		curIndex++;
+	}
+}
+
+/*
+ * Private method: sortArcsByIndex
+ * Usage: sortArcsByIndex(arcs, byFinish, buffer);
+ * -----------------------------------------------
+ * Sorts a node's arcs by the index of their finish nodes or, if
+ * byFinish is false, of their start nodes.  A SmallSet cannot be
+ * updated by index, so the arcs are sorted in the buffer, which the
+ * caller reuses from node to node, and added back to the emptied set.
+ * The sets are short, so insertion sort is the fastest choice, and it
+ * keeps parallel arcs in their original order.  Sets that are already
+ * in order are left alone.
+ */
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::sortArcsByIndex(SmallSet<ArcType *> & arcs,
+                                              bool byFinish,
+                                              Vector<ArcType *> & buffer) {
+	int nArcs = arcs.size();
+	bool sorted = true;
+	for (int i = 1; i < nArcs && sorted; i++) {
+		sorted = arcKey(arcs[i - 1], byFinish) <= arcKey(arcs[i], byFinish);
+	}
+	if (sorted) return;
+	while (!buffer.isEmpty()) {
+		buffer.removeAt(buffer.size() - 1);
+	}
+	for (int i = 0; i < nArcs; i++) {
+		ArcType *arc = arcs[i];
+		int key = arcKey(arc, byFinish);
+		buffer.add(arc);
+		int j = i;
+		while (j > 0 && arcKey(buffer[j - 1], byFinish) > key) {
+			buffer[j] = buffer[j - 1];
+			j--;
+		}
+		buffer[j] = arc;
+	}
+	arcs.clear();
+	for (int i = 0; i < nArcs; i++) {
+		arcs.add(buffer[i]);
+	}
+}
+
+template <typename NodeType,typename ArcType>
+int Graph<NodeType,ArcType>::arcKey(ArcType *arc, bool byFinish) {
+	return (byFinish) ? arc->finish->index : arc->start->index;
+}
+
+/*
+ * Implementation notes: operator=, copy constructor, swap
+ * -------------------------------------------------------
  * These methods ensure that copying a graph creates an entirely new
- * parallel structure of nodes and arcs.
+ * parallel structure of nodes and arcs.  The swap method simply
+ * exchanges the underlying collections.
  */
 
 template <typename NodeType,typename ArcType>
@@ -336,38 +767,130 @@ const Graph<NodeType,ArcType> &Graph<NodeType,ArcType>::operator=(const Graph &
 	if (this != &rhs) {
 		clear();
 		copyInternalData(rhs);
+		markChanged();
+		for (int i = 0; i < listeners.size(); i++) {
+			listeners[i]->graphReset();
+		}
 	}
 	return *this;
 }
 
 template <typename NodeType,typename ArcType>
-Graph<NodeType,ArcType>::Graph(const Graph & rhs) {
+Graph<NodeType,ArcType>::Graph(const Graph & rhs)
+                            : nodes(NodeCompare<NodeType>),
+                              arcs(ArcCompare<NodeType,ArcType>) {
+	version = 0;
 	copyInternalData(rhs);
+	markChanged();
+}
+
+template <typename NodeType,typename ArcType>
+void Graph<NodeType,ArcType>::swap(Graph & other) {
+	nodes.swap(other.nodes);
+	arcs.swap(other.arcs);
+	nodeMap.swap(other.nodeMap);
+	nodeTable.swap(other.nodeTable);
+	markChanged();
+	other.markChanged();
+	for (int i = 0; i < listeners.size(); i++) {
+		listeners[i]->graphReset();
+	}
+	for (int i = 0; i < other.listeners.size(); i++) {
+		other.listeners[i]->graphReset();
+	}
 }
 
 /* Private method: copyInternalData
  * --------------------------------
  * Common code factored out of the copy constructor and operator= to
  * copy the contents from the other graph.
+ *
+ * Implementation notes: The copy never looks nodes up by name.  Each
+ * new node takes the index of the node it copies, so the index table
+ * serves as a dense map from old nodes to new ones, and the endpoints
+ * of each copied arc are found by indexing that table.  The copied
+ * names share their character data with the originals in any string
+ * implementation that uses copy-on-write.  Because node names are
+ * unique, the new nodes sort in the same order as the old ones, and
+ * the node set can be built directly from the old set's ordering.
+ * The arcs are copied node by node to preserve the order of each
+ * adjacency list; the sorted sequence for the arc set is then formed
+ * by visiting the nodes in name order and sorting each node's few
+ * outgoing arcs, because ArcCompare orders arcs first by start node.
  */
 
 template <typename NodeType,typename ArcType>
-void Graph<NodeType,ArcType>::copyInternalData(const Graph & other) {
-	Set<NodeType *>nodes = other.nodes;
-	foreach (NodeType *oldNode in nodes) {
-		NodeType *newNode = new NodeType();
-		*newNode = *oldNode;
+void Graph<NodeType,ArcType>::copyInternalData(const Graph & constOther) {
+	Graph & other = const_cast<Graph &>(constOther);
+	int nNodes = other.nodeTable.size();
+	for (int i = 0; i < nNodes; i++) {
+		NodeType *newNode = new NodeType(*other.nodeTable[i]);
+		AllocStatsNoteAlloc(ALLOC_GRAPH, ALLOC_CELL, sizeof(NodeType));
 		newNode->arcs.clear();
-		addNode(newNode);
+		newNode->incoming.clear();
+		newNode->index = i;
+		nodeTable.add(newNode);
+		nodeMap[newNode->name] = newNode;
+	}
+	for (int i = 0; i < nNodes; i++) {
+		SmallSet<ArcType *> & oldArcs = other.nodeTable[i]->arcs;
+		for (int j = 0; j < oldArcs.size(); j++) {
+			ArcType *newArc = new ArcType(*oldArcs[j]);
+			AllocStatsNoteAlloc(ALLOC_GRAPH, ALLOC_CELL, sizeof(ArcType));
+			newArc->start = nodeTable[i];
+			newArc->finish = nodeTable[oldArcs[j]->finish->index];
+			newArc->start->arcs.add(newArc);
+			newArc->finish->incoming.add(newArc);
+		}
 	}
-	Set<ArcType *> arcs = other.arcs;
-	foreach (ArcType *oldArc in arcs) {
-		ArcType *newArc = new ArcType();
-		*newArc = *oldArc;
-		newArc->start = getNode(oldArc->start->name);
-		newArc->finish = getNode(oldArc->finish->name);
-		addArc(newArc);
+	Vector<NodeType *> sortedNodes(nNodes);
+	Vector<ArcType *> sortedArcs(other.arcs.size());
+	foreach (NodeType *oldNode in other.nodes) {
+		NodeType *newNode = nodeTable[oldNode->index];
+		sortedNodes.add(newNode);
+		int first = sortedArcs.size();
+		for (int j = 0; j < newNode->arcs.size(); j++) {
+			ArcType *arc = newNode->arcs[j];
+			int k = sortedArcs.size();
+			sortedArcs.add(arc);
+			while (k > first
+			       && ArcCompare<NodeType,ArcType>(sortedArcs[k-1], arc) > 0) {
+				sortedArcs[k] = sortedArcs[k-1];
+				k--;
+			}
+			sortedArcs[k] = arc;
+		}
+	}
+	nodes.rebuildFromSorted(sortedNodes);
+	arcs.rebuildFromSorted(sortedArcs);
+}
+
+/*
+ * Implementation notes: GraphMemoryToString
+ * -----------------------------------------
+ * This function is not a template, so it is declared inline to allow
+ * this file to be included by more than one source file.
+ */
+
+inline string GraphMemoryToString(graphMemoryT & stats) {
+	static const char *LABELS[] = {
+		"Nodes", "Arcs", "Adjacency sets", "Set elements", "AVL overhead",
+		"Map buckets", "Map cells", "Names", "Index tables"
+	};
+	long bytes[] = {
+		stats.nodeBytes, stats.arcBytes, stats.adjacencyBytes,
+		stats.setBytes, stats.avlOverheadBytes, stats.bucketBytes,
+		stats.cellBytes, stats.nameBytes, stats.indexBytes
+	};
+	ostringstream os;
+	for (int i = 0; i < int(sizeof bytes / sizeof bytes[0]); i++) {
+		if (bytes[i] != 0) os << LABELS[i] << ": " << bytes[i] << endl;
 	}
+	os << "Total: " << stats.totalBytes << " bytes for " << stats.nNodes
+	   << " nodes and " << stats.nArcs << " arcs ("
+	   << stats.bytesPerNode << " per node, " << stats.bytesPerArc
+	   << " per arc)";
+	return os.str();
 }
 
 #endif
@@ -10,17 +10,59 @@
 	Set<NodeType *> nodes;             /* The set of nodes in the graph */
 	Set<ArcType *> arcs;               /* The set of arcs in the graph  */
 	Map<NodeType *> nodeMap;           /* A map from names and nodes    */
+	Vector<NodeType *> nodeTable;      /* The nodes in index order      */
+	long version;                      /* The current version number    */
+	long previousVersion;              /* The version before that one   */
+	Vector<GraphListener<NodeType,ArcType> *> listeners;
+
+/* Class variables */
+
+	static long lastVersion;           /* The last version handed out   */
 
 /*
- * Functions: operator=, copy constructor
- * --------------------------------------
+ * Functions: operator=, copy constructor, swap
+ * --------------------------------------------
  * These functions are part of the public interface of the class but are
- * defined here to avoid adding confusion to the Graph class.
+ * defined here to avoid adding confusion to the Graph class.  Copying a
+ * graph creates an entirely new structure of nodes and arcs in time
+ * proportional to the size of the graph.  The swap method exchanges
+ * the contents of two graphs in constant time, which makes it possible
+ * to hand a graph to another owner without copying it:
+ *
+ *     Graph<nodeT,arcT> g;
+ *     g.swap(loadedGraph);
  */
 
 public:
 	const Graph & operator=(const Graph & rhs);
 	Graph(const Graph & rhs);
+	void swap(Graph & other);
+
+/*
+ * Class: Graph<NodeType,ArcType>::NeighborIterator
+ * ------------------------------------------------
+ * This nested class walks the arcs leaving a node and returns the
+ * finish node of each arc that is the first to reach that node.  It
+ * deliberately does not derive from FE_Iterator, because the foreach
+ * macro allocates its iterators on the heap.
+ */
+	class NeighborIterator {
+	public:
+		NeighborIterator();
+		bool hasNext();
+		NodeType *next();
+
+	private:
+		NeighborIterator(SmallSet<ArcType *> *arcsp);
+		SmallSet<ArcType *> *arcsp;
+		int curIndex;
+		void advanceToDistinctNeighbor();
+		friend class Graph;
+	};
 
 private:
 	void copyInternalData(const Graph & other);
+	static bool isFirstArcToFinish(SmallSet<ArcType *> & arcs, int index);
+	static void sortArcsByIndex(SmallSet<ArcType *> & arcs, bool byFinish,
+	                            Vector<ArcType *> & buffer);
+	static int arcKey(ArcType *arc, bool byFinish);
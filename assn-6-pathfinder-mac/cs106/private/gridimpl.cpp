@@ -36,6 +36,10 @@ Grid<ElemType>::Grid(int numRows, int numCols) {
 
 template <typename ElemType>
 Grid<ElemType>::~Grid() {
+	if (elements != NULL) {
+		AllocStatsNoteFree(ALLOC_GRID, ALLOC_STORAGE,
+		                   nRows * nCols * sizeof(ElemType));
+	}
 	delete[] elements;
 }
 
@@ -56,10 +60,16 @@ void Grid<ElemType>::resize(int numRows, int numCols) {
 		      + IntegerToString(numRows) + ", "
 		      + IntegerToString(numCols) + ")");
 	}
-	if (elements) delete[] elements;
+	if (elements) {
+		AllocStatsNoteFree(ALLOC_GRID, ALLOC_STORAGE,
+		                   nRows * nCols * sizeof(ElemType));
+		delete[] elements;
+	}
 	nRows = numRows;
 	nCols = numCols;
 	elements = new ElemType[nRows * nCols];
+	AllocStatsNoteAlloc(ALLOC_GRID, ALLOC_STORAGE,
+	                    nRows * nCols * sizeof(ElemType));
 	timestamp++;
 }
 
@@ -92,6 +102,10 @@ typename Grid<ElemType>::GridRow Grid<ElemType>::operator[](int row) {
 template <typename ElemType>
 const Grid<ElemType> & Grid<ElemType>::operator=(const Grid & rhs) {
 	if (this != &rhs) {
+		if (elements != NULL) {
+			AllocStatsNoteFree(ALLOC_GRID, ALLOC_STORAGE,
+			                   nRows * nCols * sizeof(ElemType));
+		}
 		delete[] elements;
 		copyContentsFrom(rhs);
 		timestamp = 0L;
@@ -120,6 +134,8 @@ void Grid<ElemType>::copyContentsFrom(const Grid & other) {
 	nRows = other.nRows;
 	nCols = other.nCols;
 	elements = new ElemType[nRows * nCols];
+	AllocStatsNoteAlloc(ALLOC_GRID, ALLOC_STORAGE,
+	                    nRows * nCols * sizeof(ElemType));
 	for (int i = 0; i < nRows * nCols; i++) {
 		elements[i] = other.elements[i];
 	}
@@ -201,7 +217,10 @@ ElemType Grid<ElemType>::Iterator::next() {
 
 template <typename ElemType>
 ElemType Grid<ElemType>::foreachHook(FE_State & fe) {
-	if (fe.state == 0) fe.iter = new Iterator(this);
+	if (fe.state == 0) {
+		fe.iter = new Iterator(this);
+		AllocStatsNoteIterator(ALLOC_GRID, sizeof(Iterator));
+	}
 	if (((Iterator *) fe.iter)->hasNext()) {
 		fe.state = 1;
 		return ((Iterator *) fe.iter)->next();
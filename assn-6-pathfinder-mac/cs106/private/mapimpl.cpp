@@ -60,6 +60,7 @@ void Map<ValueType>::remove(string key) {
 			buckets[hashCode] = found->next;
 		}
 		numEntries--;
+		AllocStatsNoteFree(ALLOC_MAP, ALLOC_CELL, sizeof(cellT));
 		delete found;
 	}
 	timestamp++;
@@ -93,6 +94,7 @@ ValueType & Map<ValueType>::operator[](string key) {
 		if (numEntries > buckets.size()*2) expandAndRehash();
 		hashCode = hash(key);
 		cp = new cellT;
+		AllocStatsNoteAlloc(ALLOC_MAP, ALLOC_CELL, sizeof(cellT));
 		cp->key = key;
 		cp->value = ValueType();
 		cp->next = buckets[hashCode];
@@ -119,6 +121,26 @@ Map<ValueType>::Map(const Map & rhs) {
 	timestamp = 0L;
 }
 
+template <typename ValueType>
+void Map<ValueType>::swap(Map & other) {
+	buckets.swap(other.buckets);
+	int tmp = numEntries;
+	numEntries = other.numEntries;
+	other.numEntries = tmp;
+	timestamp++;
+	other.timestamp++;
+}
+
+template <typename ValueType>
+long Map<ValueType>::getHeapBytes() {
+	return getBucketBytes() + long(numEntries) * sizeof(cellT);
+}
+
+template <typename ValueType>
+long Map<ValueType>::getBucketBytes() {
+	return buckets.getHeapBytes();
+}
+
 template <typename ValueType>
 void Map<ValueType>::add(string key, ValueType value) {
 	put(key, value);
@@ -169,6 +191,7 @@ void Map<ValueType>::deleteBuckets(Vector<cellT *> & b) {
 	for (int i = 0; i < b.size(); i++) {
 		while (b[i] != NULL) {
 			cellT *next = b[i]->next;
+			AllocStatsNoteFree(ALLOC_MAP, ALLOC_CELL, sizeof(cellT));
 			delete b[i];
 			b[i] = next;
 		}
@@ -341,7 +364,10 @@ void Map<ValueType>::Iterator::advanceToNextKey() {
 
 template <typename ValueType>
 string Map<ValueType>::foreachHook(FE_State & fe) {
-	if (fe.state == 0) fe.iter = new Iterator(this);
+	if (fe.state == 0) {
+		fe.iter = new Iterator(this);
+		AllocStatsNoteIterator(ALLOC_MAP, sizeof(Iterator));
+	}
 	if (((Iterator *) fe.iter)->hasNext()) {
 		fe.state = 1;
 		return ((Iterator *) fe.iter)->next();
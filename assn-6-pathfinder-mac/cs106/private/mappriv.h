@@ -66,6 +66,25 @@ public:
 	const Map & operator=(const Map & rhs);
 	Map(const Map & rhs);
 
+/*
+ * Constant-time exchange support
+ * ------------------------------
+ * The swap method exchanges the contents of two maps without copying
+ * any entries.  Any iterators on either map are invalidated.
+ */
+	void swap(Map & other);
+
+/*
+ * Memory accounting support
+ * -------------------------
+ * The getHeapBytes method returns the number of bytes of heap storage
+ * held by this map in its bucket array and cells, not counting any
+ * storage that the keys and values themselves allocate.  The
+ * getBucketBytes method returns the part used by the bucket array.
+ */
+	long getHeapBytes();
+	long getBucketBytes();
+
 private:
 	struct cellT {
 		string key;
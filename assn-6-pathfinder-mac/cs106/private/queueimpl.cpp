@@ -41,6 +41,7 @@ bool Queue<ElemType>::isEmpty() {
 template <typename ElemType>
 void Queue<ElemType>::enqueue(ElemType elem) {
 	cellT *newOne = new cellT;
+	AllocStatsNoteAlloc(ALLOC_QUEUE, ALLOC_CELL, sizeof(cellT));
 	newOne->elem = elem;
 	newOne->next = NULL;
 	if (head != NULL) {
@@ -58,6 +59,7 @@ ElemType Queue<ElemType>::dequeue() {
 	ElemType first = head->elem;
 	cellT *toDelete = head;
 	head = head->next;
+	AllocStatsNoteFree(ALLOC_QUEUE, ALLOC_CELL, sizeof(cellT));
 	delete toDelete;
 	count--;
 	return first;
@@ -79,6 +81,7 @@ template <typename ElemType>
 void Queue<ElemType>::deleteCells() {
 	while (head != NULL) {
 		cellT *next = head->next;
+		AllocStatsNoteFree(ALLOC_QUEUE, ALLOC_CELL, sizeof(cellT));
 		delete head;
 		head = next;
 	}
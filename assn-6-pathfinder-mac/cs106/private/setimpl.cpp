@@ -58,8 +58,14 @@ void Set<ElemType>::clear() {
  * Implementation notes: Set operations
  * ------------------------------------
  * The code for equals, isSubsetOf, unionWith, intersectWith, and subtract
- * is similar in structure.  Each one uses an iterator to walk over
- * one (or both) sets, doing add/remove/comparision.
+ * is similar in structure.  Because both sets are ordered by the same
+ * comparison function, their iterators deliver the elements in the same
+ * sorted order, which makes it possible to implement each operation as
+ * a single linear merge over the two sets.  The operations that modify
+ * the receiver collect the surviving elements in a vector and then
+ * rebuild the underlying tree directly in balanced form, so that each
+ * of them runs in O(N + M) time rather than performing an O(log N)
+ * add or remove for every element.
  */
 
 template <typename ElemType>
@@ -79,9 +85,16 @@ bool Set<ElemType>::isSubsetOf(Set & otherSet) {
 	if (cmpFn != otherSet.cmpFn) {
 		Error("isSubsetOf: sets have different comparison functions");
 	}
-	Iterator iter = iterator();
-	while (iter.hasNext()) {
-		if (!otherSet.contains(iter.next())) return false;
+	if (size() > otherSet.size()) return false;
+	Iterator thisItr = iterator(), otherItr = otherSet.iterator();
+	while (thisItr.hasNext()) {
+		ElemType elem = thisItr.next();
+		while (true) {
+			if (!otherItr.hasNext()) return false;
+			int sign = cmpFn(otherItr.next(), elem);
+			if (sign == 0) break;
+			if (sign > 0) return false;
+		}
 	}
 	return true;
 }
@@ -91,10 +104,7 @@ void Set<ElemType>::unionWith(Set & otherSet) {
 	if (cmpFn != otherSet.cmpFn) {
 		Error("unionWith: sets have different comparison functions");
 	}
-	Iterator iter = otherSet.iterator();
-	while (iter.hasNext()) {
-		add(iter.next());
-	}
+	mergeWith(otherSet, true, true, true);
 }
 
 /*
@@ -103,8 +113,9 @@ void Set<ElemType>::unionWith(Set & otherSet) {
  * The most obvious way to write this method (iterating over
  * one set and deleting members that are not in the second)
  * fails because you can't change the contents of a collection
- * over which you're iterating.  This code puts the elements
- * to be deleted in a vector and then deletes those.
+ * over which you're iterating.  The merge-based implementation
+ * avoids the problem entirely, because the tree is rebuilt only
+ * after both iterators have been exhausted.
  */
 
 template <typename ElemType>
@@ -113,15 +124,7 @@ void Set<ElemType>::intersectWith(Set & otherSet) {
 		Error("intersectWith:"
 		      " sets have different comparison functions");
 	}
-	Iterator iter = iterator();
-	Vector<ElemType> toDelete;
-	while (iter.hasNext()) {
-		ElemType elem = iter.next();
-		if (!otherSet.contains(elem)) toDelete.add(elem);
-	}
-	for (int i = 0; i < toDelete.size(); i++) {
-		remove(toDelete[i]);
-	}
+	mergeWith(otherSet, false, true, false);
 }
 
 template <typename ElemType>
@@ -137,10 +140,74 @@ void Set<ElemType>::subtract(Set & otherSet) {
 	if (cmpFn != otherSet.cmpFn) {
 		Error("subtract: sets have different comparison functions");
 	}
-	Iterator iter = otherSet.iterator();
-	while (iter.hasNext()) {
-		remove(iter.next());
+	mergeWith(otherSet, true, false, false);
+}
+
+/*
+ * Private method: mergeWith
+ * Usage: mergeWith(otherSet, keepThisOnly, keepCommon, keepOtherOnly);
+ * --------------------------------------------------------------------
+ * Walks the two sets in parallel and replaces the contents of this set
+ * with the elements selected by the three flags, which indicate whether
+ * to keep elements that appear only in this set, in both sets, or only
+ * in otherSet.  When an element appears in both sets, the copy from
+ * otherSet is kept if elements from otherSet are being added, which
+ * matches the overwriting behavior of add; otherwise the copy from this
+ * set is kept.
+ */
+
+template <typename ElemType>
+void Set<ElemType>::mergeWith(Set & otherSet, bool keepThisOnly,
+                              bool keepCommon, bool keepOtherOnly) {
+	Vector<ElemType> merged(size() + (keepOtherOnly ? otherSet.size() : 0));
+	Iterator thisItr = iterator(), otherItr = otherSet.iterator();
+	bool hasThis = thisItr.hasNext(), hasOther = otherItr.hasNext();
+	ElemType thisElem = (hasThis) ? thisItr.next() : ElemType();
+	ElemType otherElem = (hasOther) ? otherItr.next() : ElemType();
+	while (hasThis || hasOther) {
+		int sign;
+		if (!hasOther) {
+			sign = -1;
+		} else if (!hasThis) {
+			sign = +1;
+		} else {
+			sign = cmpFn(thisElem, otherElem);
+		}
+		if (sign < 0) {
+			if (keepThisOnly) merged.add(thisElem);
+		} else if (sign > 0) {
+			if (keepOtherOnly) merged.add(otherElem);
+		} else if (keepCommon) {
+			merged.add((keepOtherOnly) ? otherElem : thisElem);
+		}
+		if (sign <= 0) {
+			hasThis = thisItr.hasNext();
+			if (hasThis) thisElem = thisItr.next();
+		}
+		if (sign >= 0) {
+			hasOther = otherItr.hasNext();
+			if (hasOther) otherElem = otherItr.next();
+		}
 	}
+	bst.rebuildFromSorted(merged);
+}
+
+template <typename ElemType>
+void Set<ElemType>::rebuildFromSorted(Vector<ElemType> & sorted) {
+	bst.rebuildFromSorted(sorted);
+}
+
+template <typename ElemType>
+void Set<ElemType>::swap(Set & otherSet) {
+	bst.swap(otherSet.bst);
+	int (*tmpCmp)(ElemType, ElemType) = cmpFn;
+	cmpFn = otherSet.cmpFn;
+	otherSet.cmpFn = tmpCmp;
+}
+
+template <typename ElemType>
+long Set<ElemType>::getHeapBytes() {
+	return bst.getHeapBytes();
 }
 
 template <typename ElemType>
@@ -189,7 +256,10 @@ ElemType Set<ElemType>::Iterator::next() {
 
 template <typename ElemType>
 ElemType Set<ElemType>::foreachHook(FE_State & fe) {
-	if (fe.state == 0) fe.iter = new Iterator(this);
+	if (fe.state == 0) {
+		fe.iter = new Iterator(this);
+		AllocStatsNoteIterator(ALLOC_BST, sizeof(Iterator));
+	}
 	if (((Iterator *) fe.iter)->hasNext()) {
 		fe.state = 1;
 		return ((Iterator *) fe.iter)->next();
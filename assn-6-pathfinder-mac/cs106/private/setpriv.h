@@ -37,6 +37,35 @@ public:
 	friend class Iterator;
 	ElemType foreachHook(FE_State & _fe);
 
+/*
+ * Bulk loading support
+ * --------------------
+ * The rebuildFromSorted method replaces the contents of the set with
+ * the elements in the vector, which must already be in strictly
+ * increasing order according to the set's comparison function.  The
+ * operation runs in linear time, which makes it useful to classes
+ * such as Graph that construct large sets from data that is known
+ * to be sorted.
+ */
+	void rebuildFromSorted(Vector<ElemType> & sorted);
+
+/*
+ * Constant-time exchange support
+ * ------------------------------
+ * The swap method exchanges the contents and comparison functions of
+ * two sets without copying any elements.
+ */
+	void swap(Set & otherSet);
+
+/*
+ * Memory accounting support
+ * -------------------------
+ * The getHeapBytes method returns the number of bytes of heap storage
+ * held by this set in the nodes of its tree, not counting any storage
+ * that the elements themselves allocate.
+ */
+	long getHeapBytes();
+
 /*
  * Deep copying support
  * --------------------
@@ -55,3 +84,6 @@ public:
 private:
 	BST<ElemType> bst;
 	int (*cmpFn)(ElemType, ElemType);
+
+	void mergeWith(Set & otherSet, bool keepThisOnly, bool keepCommon,
+	               bool keepOtherOnly);
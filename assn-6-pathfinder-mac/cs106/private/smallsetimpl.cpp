@@ -0,0 +1,263 @@
+/*
+ * File: smallsetimpl.cpp
+ * ----------------------
+ * This file contains the implementation of the smallset.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.
+ */
+
+#ifdef _smallset_h
+
+/*
+ * SmallSet class implementation
+ * -----------------------------
+ * The elements pointer refers to the inlineElements array until the
+ * set grows beyond SMALLSET_INLINE_CAPACITY elements, at which point
+ * the contents are moved to a heap array that doubles in size as
+ * needed.  As in the Vector class, capacity (numAllocated) is tracked
+ * separately from size (numUsed).
+ */
+
+template <typename ElemType>
+SmallSet<ElemType>::SmallSet() {
+	elements = inlineElements;
+	numAllocated = SMALLSET_INLINE_CAPACITY;
+	numUsed = 0;
+	timestamp = 0L;
+}
+
+template <typename ElemType>
+SmallSet<ElemType>::~SmallSet() {
+	freeHeapStorage();
+}
+
+template <typename ElemType>
+inline int SmallSet<ElemType>::size() {
+	return numUsed;
+}
+
+template <typename ElemType>
+bool SmallSet<ElemType>::isEmpty() {
+	return numUsed == 0;
+}
+
+template <typename ElemType>
+void SmallSet<ElemType>::add(ElemType elem) {
+	if (indexOf(elem) != -1) return;
+	if (numUsed == numAllocated) enlargeCapacity();
+	elements[numUsed++] = elem;
+	timestamp++;
+}
+
+template <typename ElemType>
+void SmallSet<ElemType>::remove(ElemType elem) {
+	int index = indexOf(elem);
+	if (index == -1) return;
+	for (int i = index; i < numUsed - 1; i++) {
+		elements[i] = elements[i + 1];
+	}
+	numUsed--;
+	timestamp++;
+}
+
+template <typename ElemType>
+bool SmallSet<ElemType>::contains(ElemType elem) {
+	return indexOf(elem) != -1;
+}
+
+template <typename ElemType>
+inline ElemType SmallSet<ElemType>::operator[](int index) {
+	if (index < 0 || index >= numUsed) {
+		Error("Attempt to access index " + IntegerToString(index)
+		      + " in a SmallSet of size " + IntegerToString(numUsed) + ".");
+	}
+	return elements[index];
+}
+
+template <typename ElemType>
+void SmallSet<ElemType>::clear() {
+	freeHeapStorage();
+	numUsed = 0;
+	timestamp++;
+}
+
+template <typename ElemType>
+const SmallSet<ElemType> &SmallSet<ElemType>::operator=(const SmallSet & rhs) {
+	if (this != &rhs) {
+		clear();
+		copyInternalData(rhs);
+		timestamp = 0L;
+	}
+	return *this;
+}
+
+template <typename ElemType>
+SmallSet<ElemType>::SmallSet(const SmallSet & rhs) {
+	elements = inlineElements;
+	numAllocated = SMALLSET_INLINE_CAPACITY;
+	numUsed = 0;
+	copyInternalData(rhs);
+	timestamp = 0L;
+}
+
+template <typename ElemType>
+void SmallSet<ElemType>::mapAll(void (*fn)(ElemType)) {
+	long t0 = timestamp;
+	for (int i = 0; i < numUsed; i++) {
+		if (timestamp != t0) {
+			Error("SmallSet structure has been modified");
+		}
+		fn(elements[i]);
+	}
+}
+
+template <typename ElemType>
+template <typename ClientDataType>
+void SmallSet<ElemType>::mapAll(void (*fn)(ElemType, ClientDataType &),
+                                ClientDataType & data) {
+	long t0 = timestamp;
+	for (int i = 0; i < numUsed; i++) {
+		if (timestamp != t0) {
+			Error("SmallSet structure has been modified");
+		}
+		fn(elements[i], data);
+	}
+}
+
+/*
+ * SmallSet::Iterator class implementation
+ * ---------------------------------------
+ * The Iterator for SmallSet maintains a pointer to the original set and
+ * an index identifying the next element to return.
+ */
+
+template <typename ElemType>
+SmallSet<ElemType>::Iterator::Iterator() {
+	sp = NULL;
+}
+
+template <typename ElemType>
+typename SmallSet<ElemType>::Iterator SmallSet<ElemType>::iterator() {
+	return Iterator(this);
+}
+
+template <typename ElemType>
+SmallSet<ElemType>::Iterator::Iterator(SmallSet *setptr) {
+	sp = setptr;
+	curIndex = 0;
+	timestamp = sp->timestamp;
+}
+
+template <typename ElemType>
+bool SmallSet<ElemType>::Iterator::hasNext() {
+	if (sp == NULL) Error("hasNext called on uninitialized iterator");
+	if (timestamp != sp->timestamp) {
+		Error("SmallSet structure has been modified");
+	}
+	return curIndex < sp->numUsed;
+}
+
+template <typename ElemType>
+ElemType SmallSet<ElemType>::Iterator::next() {
+	if (sp == NULL) Error("next called on uninitialized iterator");
+	if (!hasNext()) {
+		Error("Attempt to get next from iterator"
+		      " where hasNext() is false");
+	}
+	return sp->elements[curIndex++];
+}
+
+template <typename ElemType>
+ElemType SmallSet<ElemType>::foreachHook(FE_State & fe) {
+	if (fe.state == 0) {
+		fe.iter = new Iterator(this);
+		AllocStatsNoteIterator(ALLOC_SMALLSET, sizeof(Iterator));
+	}
+	if (((Iterator *) fe.iter)->hasNext()) {
+		fe.state = 1;
+		return ((Iterator *) fe.iter)->next();
+	} else {
+		fe.state = 2;
+		return ElemType();
+	}
+}
+
+template <typename ElemType>
+long SmallSet<ElemType>::getHeapBytes() {
+	if (elements == inlineElements) return 0;
+	return long(numAllocated) * sizeof(ElemType);
+}
+
+/* Private method: indexOf
+ * -----------------------
+ * Returns the index of the element in this set, or -1 if the element
+ * does not appear.  This linear scan is the heart of the class.
+ */
+
+template <typename ElemType>
+int SmallSet<ElemType>::indexOf(ElemType & elem) {
+	for (int i = 0; i < numUsed; i++) {
+		if (elements[i] == elem) return i;
+	}
+	return -1;
+}
+
+/* Private method: enlargeCapacity
+ * -------------------------------
+ * Doubles the current capacity of the set, moving the elements out
+ * of the inline array the first time the set overflows.
+ */
+
+template <typename ElemType>
+void SmallSet<ElemType>::enlargeCapacity() {
+	int newCapacity = numAllocated * 2;
+	ElemType *newArray = new ElemType[newCapacity];
+	AllocStatsNoteAlloc(ALLOC_SMALLSET, ALLOC_STORAGE,
+	                    newCapacity * sizeof(ElemType));
+	for (int i = 0; i < numUsed; i++) {
+		newArray[i] = elements[i];
+	}
+	freeHeapStorage();
+	elements = newArray;
+	numAllocated = newCapacity;
+}
+
+/* Private method: freeHeapStorage
+ * -------------------------------
+ * Releases the heap array, if any, and points the set back at its
+ * inline storage.  The caller is responsible for numUsed.
+ */
+
+template <typename ElemType>
+void SmallSet<ElemType>::freeHeapStorage() {
+	if (elements != inlineElements) {
+		AllocStatsNoteFree(ALLOC_SMALLSET, ALLOC_STORAGE,
+		                   numAllocated * sizeof(ElemType));
+		delete[] elements;
+	}
+	elements = inlineElements;
+	numAllocated = SMALLSET_INLINE_CAPACITY;
+}
+
+/* Private method: copyInternalData
+ * --------------------------------
+ * Common code factored out of the copy constructor and operator= to
+ * copy the contents from the other set.  The receiver must be empty
+ * and using its inline storage.
+ */
+
+template <typename ElemType>
+void SmallSet<ElemType>::copyInternalData(const SmallSet & other) {
+	if (other.numUsed > SMALLSET_INLINE_CAPACITY) {
+		elements = new ElemType[other.numUsed];
+		AllocStatsNoteAlloc(ALLOC_SMALLSET, ALLOC_STORAGE,
+		                    other.numUsed * sizeof(ElemType));
+		numAllocated = other.numUsed;
+	}
+	for (int i = 0; i < other.numUsed; i++) {
+		elements[i] = other.elements[i];
+	}
+	numUsed = other.numUsed;
+}
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * File: smallsetpriv.h
+ * --------------------
+ * This file contains the private section of the smallset.h interface.
+ * This portion of the class definition is taken out of the smallset.h
+ * header so that the client need not have to see all of these
+ * details.
+ */
+
+public:
+
+/*
+ * Class: SmallSet<ElemType>::Iterator
+ * -----------------------------------
+ * This interface defines a nested class within the SmallSet template
+ * that provides iterator access to the SmallSet contents.
+ */
+	class Iterator : public FE_Iterator {
+	public:
+		Iterator();
+		bool hasNext();
+		ElemType next();
+
+	private:
+		Iterator(SmallSet *setptr);
+		SmallSet *sp;
+		int curIndex;
+		long timestamp;
+		friend class SmallSet;
+	};
+	friend class Iterator;
+	ElemType foreachHook(FE_State & _fe);
+
+/*
+ * Deep copying support
+ * --------------------
+ * This copy constructor and operator= are defined to make a
+ * deep copy, making it possible to pass/return sets by value
+ * and assign from one set to another.  The definitions are
+ * required because the elements pointer must refer to the
+ * inline storage of the new object rather than the old one.
+ */
+	const SmallSet & operator=(const SmallSet & rhs);
+	SmallSet(const SmallSet & rhs);
+
+/*
+ * Memory accounting support
+ * -------------------------
+ * The getHeapBytes method returns the number of bytes of heap storage
+ * held by this set, which is zero as long as the elements fit in the
+ * inline storage, not counting any storage that the elements
+ * themselves allocate.
+ */
+	long getHeapBytes();
+
+private:
+	ElemType inlineElements[SMALLSET_INLINE_CAPACITY];
+	ElemType *elements;      /* Either inlineElements or a heap array */
+	int numAllocated, numUsed;
+	long timestamp;
+
+	int indexOf(ElemType & elem);
+	void enlargeCapacity();
+	void freeHeapStorage();
+	void copyInternalData(const SmallSet & other);
@@ -20,6 +20,8 @@
 template <typename ElemType>
 Vector<ElemType>::Vector(int capacity) {
 	elements = new ElemType[capacity];
+	AllocStatsNoteAlloc(ALLOC_VECTOR, ALLOC_STORAGE,
+	                    capacity * sizeof(ElemType));
 	numAllocated = capacity;
 	numUsed = 0;
 	timestamp = 0L;
@@ -27,7 +29,11 @@ Vector<ElemType>::Vector(int capacity) {
 
 template <typename ElemType>
 Vector<ElemType>::~Vector() {
-	if (elements != NULL) delete[] elements;
+	if (elements != NULL) {
+		AllocStatsNoteFree(ALLOC_VECTOR, ALLOC_STORAGE,
+		                   numAllocated * sizeof(ElemType));
+		delete[] elements;
+	}
 }
 
 template <typename ElemType>
@@ -103,6 +109,10 @@ void Vector<ElemType>::removeAt(int index) {
 
 template <typename ElemType>
 void Vector<ElemType>::clear() {
+	if (elements != NULL) {
+		AllocStatsNoteFree(ALLOC_VECTOR, ALLOC_STORAGE,
+		                   numAllocated * sizeof(ElemType));
+	}
 	delete[] elements;
 	elements = NULL;
 	numUsed = numAllocated = 0;
@@ -125,6 +135,35 @@ Vector<ElemType>::Vector(const Vector & rhs) {
 	timestamp = 0L;
 }
 
+template <typename ElemType>
+void Vector<ElemType>::swap(Vector & other) {
+	ElemType *tmpElements = elements;
+	elements = other.elements;
+	other.elements = tmpElements;
+	int tmp = numAllocated;
+	numAllocated = other.numAllocated;
+	other.numAllocated = tmp;
+	tmp = numUsed;
+	numUsed = other.numUsed;
+	other.numUsed = tmp;
+	timestamp++;
+	other.timestamp++;
+}
+
+template <typename ElemType>
+void Vector<ElemType>::truncate(int n) {
+	if (n < 0 || n > numUsed) {
+		Error("Attempt to truncate Vector to a size outside its range");
+	}
+	numUsed = n;
+	timestamp++;
+}
+
+template <typename ElemType>
+long Vector<ElemType>::getHeapBytes() {
+	return (elements == NULL) ? 0 : long(numAllocated) * sizeof(ElemType);
+}
+
 template <typename ElemType>
 void Vector<ElemType>::mapAll(void (*fn)(ElemType)) {
 	long t0 = timestamp;
@@ -194,7 +233,10 @@ ElemType Vector<ElemType>::Iterator::next() {
 
 template <typename ElemType>
 ElemType Vector<ElemType>::foreachHook(FE_State & fe) {
-	if (fe.state == 0) fe.iter = new Iterator(this);
+	if (fe.state == 0) {
+		fe.iter = new Iterator(this);
+		AllocStatsNoteIterator(ALLOC_VECTOR, sizeof(Iterator));
+	}
 	if (((Iterator *) fe.iter)->hasNext()) {
 		fe.state = 1;
 		return ((Iterator *) fe.iter)->next();
@@ -212,11 +254,18 @@ ElemType Vector<ElemType>::foreachHook(FE_State & fe) {
 
 template <typename ElemType>
 void Vector<ElemType>::enlargeCapacity() {
+	int oldAllocated = numAllocated;
 	numAllocated = (numAllocated == 0 ? 10 : numAllocated*2);
 	ElemType *newArray = new ElemType[numAllocated];
+	AllocStatsNoteAlloc(ALLOC_VECTOR, ALLOC_STORAGE,
+	                    numAllocated * sizeof(ElemType));
 	for (int i = 0; i < numUsed; i++) {
 		newArray[i] = elements[i];
 	}
+	if (elements != NULL) {
+		AllocStatsNoteFree(ALLOC_VECTOR, ALLOC_STORAGE,
+		                   oldAllocated * sizeof(ElemType));
+	}
 	delete[] elements;
 	elements = newArray;
 }
@@ -230,6 +279,8 @@ void Vector<ElemType>::enlargeCapacity() {
 template <typename ElemType>
 void Vector<ElemType>::copyInternalData(const Vector & other) {
 	elements = new ElemType[other.numUsed];
+	AllocStatsNoteAlloc(ALLOC_VECTOR, ALLOC_STORAGE,
+	                    other.numUsed * sizeof(ElemType));
 	for (int i = 0; i < other.numUsed; i++) {
 		elements[i] = other.elements[i];
 	}
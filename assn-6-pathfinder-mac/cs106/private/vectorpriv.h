@@ -48,6 +48,37 @@ public:
 	const Vector & operator=(const Vector & rhs);
 	Vector(const Vector & rhs);
 
+/*
+ * Constant-time exchange support
+ * ------------------------------
+ * The swap method exchanges the contents of this vector with those of
+ * another vector without copying any elements.  Classes that hold a
+ * vector use it to hand their contents to another object cheaply.
+ * Any iterators on either vector are invalidated.
+ */
+	void swap(Vector & other);
+
+/*
+ * Storage reuse support
+ * ---------------------
+ * The truncate method removes every element at an index of n or more
+ * in constant time, leaving the storage allocated so that the vector
+ * can be refilled without allocating.  Unlike clear, which frees the
+ * storage, it suits working vectors that are emptied many times.  The
+ * removed elements are overwritten as the vector grows again.  Raises
+ * an error if n is outside the range [0, size()].
+ */
+	void truncate(int n);
+
+/*
+ * Memory accounting support
+ * -------------------------
+ * The getHeapBytes method returns the number of bytes of heap storage
+ * held by this vector, including unused capacity, not counting any
+ * storage that the elements themselves allocate.
+ */
+	long getHeapBytes();
+
 private:
 	ElemType *elements;
 	int numAllocated, numUsed;
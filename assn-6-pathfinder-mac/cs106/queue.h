@@ -11,6 +11,7 @@
 #define _queue_h
 
 #include "genlib.h"
+#include "allocstats.h"
 
 /*
  * Class: Queue
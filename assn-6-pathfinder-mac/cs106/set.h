@@ -13,6 +13,7 @@
 #include "cmpfn.h"
 #include "bst.h"
 #include "vector.h"
+#include "allocstats.h"
 #include "foreach.h"
 
 /*
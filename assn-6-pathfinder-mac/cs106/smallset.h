@@ -0,0 +1,190 @@
+/*
+ * File: smallset.h
+ * ----------------
+ * This interface file contains the SmallSet class template, a compact
+ * collection of distinct elements designed for sets that are usually
+ * very small, such as the arcs leaving a node in a road map.
+ */
+
+#ifndef _smallset_h
+#define _smallset_h
+
+#include "genlib.h"
+#include "strutils.h"
+#include "allocstats.h"
+#include "foreach.h"
+
+/*
+ * Class: SmallSet
+ * ---------------
+ * This interface defines a class template that stores a collection of
+ * distinct elements in a flat array.  The first few elements are stored
+ * inline in the SmallSet object itself, so that a set whose size never
+ * exceeds SMALLSET_INLINE_CAPACITY requires no heap storage at all.
+ * Larger sets spill over into a dynamically allocated array that grows
+ * in the same way as a Vector.
+ *
+ * Unlike Set, a SmallSet does not keep its elements in sorted order:
+ * elements appear in the order in which they were added, and the
+ * contains, add, and remove operations use a linear scan comparing
+ * elements with the built-in == operator.  For the handful of elements
+ * in a typical adjacency list, that scan is considerably faster than
+ * walking a balanced tree, and the elements are contiguous in memory.
+ * SmallSet is therefore a poor choice for large collections, for which
+ * the Set class remains the appropriate abstraction.
+ *
+ * The Graph class uses SmallSet to store the arcs that leave each node.
+ */
+
+const int SMALLSET_INLINE_CAPACITY = 4;
+
+template <typename ElemType>
+class SmallSet {
+
+public:
+
+/* Forward references */
+	class Iterator;
+
+/*
+ * Constructor: SmallSet
+ * Usage: SmallSet<arcT *> arcs;
+ * -----------------------------
+ * The constructor initializes an empty set that uses only its
+ * inline storage.
+ */
+	SmallSet();
+
+/*
+ * Destructor: ~SmallSet
+ * Usage: (usually implicit)
+ * -------------------------
+ * The destructor deallocates any heap storage used by this set.
+ */
+	~SmallSet();
+
+/*
+ * Method: size
+ * Usage: count = set.size();
+ * --------------------------
+ * This method returns the number of elements in this set.
+ */
+	int size();
+
+/*
+ * Method: isEmpty
+ * Usage: if (set.isEmpty())...
+ * ----------------------------
+ * This method returns true if this set contains no
+ * elements, false otherwise.
+ */
+	bool isEmpty();
+
+/*
+ * Method: add
+ * Usage: set.add(value);
+ * ----------------------
+ * This method adds an element to the end of this set.  If an equal
+ * value is already contained in the set, the set is unchanged.
+ */
+	void add(ElemType elem);
+
+/*
+ * Method: remove
+ * Usage: set.remove(value);
+ * -------------------------
+ * This method removes an element from this set.  If the
+ * element was not contained in the set, the set is unchanged.
+ * The remaining elements keep their relative order.
+ */
+	void remove(ElemType elem);
+
+/*
+ * Method: contains
+ * Usage: if (set.contains(value))...
+ * ----------------------------------
+ * Returns true if the element is in this set, false otherwise.
+ */
+	bool contains(ElemType elem);
+
+/*
+ * Method: operator[]
+ * Usage: elem = set[i];
+ * ---------------------
+ * Returns the element at the specified index, where elements are
+ * numbered from 0 in the order in which they were added.  Together
+ * with size, this method allows clients to scan the set without
+ * creating an iterator.  The result is a copy, which prevents clients
+ * from introducing duplicates by assigning through the index.  Raises
+ * an error if index is not within the range [0, size()-1].
+ */
+	ElemType operator[](int index);
+
+/*
+ * Method: clear
+ * Usage: set.clear();
+ * -------------------
+ * This method removes all elements from this set and returns
+ * the set to its inline storage.
+ */
+	void clear();
+
+/*
+ * SPECIAL NOTE: mapping/iteration support
+ * ---------------------------------------
+ * The SmallSet class supports both a mapping operation and an
+ * iterator which allow the client access to all elements one by one.
+ * In general, these are intended for _viewing_ elements and can behave
+ * unpredictably if you attempt to modify the set's contents during
+ * mapping/iteration.
+ */
+
+/*
+ * Method: mapAll
+ * Usage: set.mapAll(Print);
+ * -------------------------
+ * This method iterates through this set's contents
+ * and calls the function fn once for each element.
+ */
+	void mapAll(void (*fn)(ElemType elem));
+
+/*
+ * Method: mapAll
+ * Usage: set.mapAll(PrintToFile, outputStream);
+ * ---------------------------------------------
+ * This method iterates through this set's contents
+ * and calls the function fn once for each element, passing
+ * the element and the client's data. That data can be of whatever
+ * type is needed for the client's callback.
+ */
+	template <typename ClientDataType>
+	void mapAll(void (*fn)(ElemType elem, ClientDataType & data),
+	            ClientDataType & data);
+
+/*
+ * Method: iterator
+ * Usage: iter = set.iterator();
+ * -----------------------------
+ * This method creates an iterator that allows the client to
+ * iterate through the elements in this set.  The elements are
+ * returned in the order in which they were added, which makes it
+ * possible to use the foreach idiom:
+ *
+ *     foreach (arcT *arc in node->arcs) {
+ *         . . .
+ *     }
+ *
+ * To avoid exposing the details of the class, the definition of the
+ * Iterator class itself appears in the private/smallsetpriv.h file.
+ */
+	Iterator iterator();
+
+private:
+
+#include "private/smallsetpriv.h"
+
+};
+
+#include "private/smallsetimpl.cpp"
+
+#endif
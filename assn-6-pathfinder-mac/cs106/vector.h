@@ -12,6 +12,7 @@
 
 #include "genlib.h"
 #include "strutils.h"
+#include "allocstats.h"
 #include "foreach.h"
 
 /*
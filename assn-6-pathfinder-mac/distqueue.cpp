@@ -0,0 +1,303 @@
+/*
+ * File: distqueue.cpp
+ * -------------------
+ * This file implements the distqueue.h interface.
+ */
+
+#include <cmath>
+#include <climits>
+#include "genlib.h"
+#include "distqueue.h"
+
+/*
+ * Constant: DIAL_MAX_ARC
+ * ----------------------
+ * The longest arc for which ChooseQueueKind selects Dial's algorithm.
+ * Beyond this point the cyclic array has too many empty buckets to
+ * scan, and the radix heap is faster.
+ */
+
+const double DIAL_MAX_ARC = 1024;
+
+/* Private function prototypes */
+
+static queueKindT ChooseKind(bool integral, double maxArc, int nNodes);
+
+/*
+ * Implementation notes: ChooseQueueKind
+ * -------------------------------------
+ * The integer representations store priorities as unsigned long values,
+ * so they can be used only if no path in the graph can be longer than
+ * ULONG_MAX.  The longest possible simple path crosses every node once,
+ * which gives the bound checked here.
+ */
+
+queueKindT ChooseQueueKind(Graph<nodeT,arcT> & graph, double & maxArc) {
+	bool integral = true;
+	maxArc = 0;
+	for (int i = 0; i < graph.size(); i++) {
+		nodeT *node = graph.getNodeByIndex(i);
+		for (int j = 0; j < node->arcs.size(); j++) {
+			double d = node->arcs[j]->distance;
+			if (d < 0 || d != floor(d)) integral = false;
+			if (d > maxArc) maxArc = d;
+		}
+	}
+	return ChooseKind(integral, maxArc, graph.size());
+}
+
+queueKindT ChooseQueueKind(CompactGraph & compact, double & maxArc) {
+	maxArc = compact.getMaxArcDistance();
+	bool integral = compact.getWeightCoding() == INTEGER_WEIGHTS;
+	return ChooseKind(integral, maxArc, compact.size());
+}
+
+queueKindT ChooseQueueKind(GraphSnapshot & snapshot, double & maxArc) {
+	maxArc = snapshot.getMaxArcBound();
+	return ChooseKind(snapshot.isIntegral(), maxArc, snapshot.size());
+}
+
+/*
+ * Function: ChooseKind
+ * Usage: queueKindT kind = ChooseKind(integral, maxArc, nNodes);
+ * --------------------------------------------------------------
+ * Makes the choice described for ChooseQueueKind given whether every
+ * arc distance is an integer, the longest arc, and the number of nodes.
+ */
+
+static queueKindT ChooseKind(bool integral, double maxArc, int nNodes) {
+	if (!integral || maxArc * nNodes >= double(ULONG_MAX)) {
+		return BINARY_HEAP;
+	}
+	return (maxArc <= DIAL_MAX_ARC) ? DIAL_BUCKETS : RADIX_HEAP;
+}
+
+DistanceQueue::DistanceQueue() {
+	kind = BINARY_HEAP;
+	count = 0;
+	peak = 0;
+	nPushes = nPops = 0;
+	last = 0;
+}
+
+DistanceQueue::~DistanceQueue() {
+	/* Empty */
+}
+
+/*
+ * Implementation notes: setKind
+ * -----------------------------
+ * The radix heap needs one bucket for each possible bit position of
+ * the difference between a priority and the last priority dequeued,
+ * plus bucket 0 for priorities equal to that value.  Dial's algorithm
+ * needs maxArc + 1 buckets, because every pending priority lies in the
+ * range from the current minimum to that minimum plus maxArc.  If
+ * neither the representation nor the number of buckets changes, the
+ * existing buckets are reused.
+ */
+
+void DistanceQueue::setKind(queueKindT newKind, double maxArc) {
+	if (newKind == AUTO_QUEUE) {
+		Error("setKind: AUTO_QUEUE must be resolved by ChooseQueueKind");
+	}
+	int nBuckets = 0;
+	if (newKind == RADIX_HEAP) nBuckets = RADIX_BUCKETS;
+	if (newKind == DIAL_BUCKETS) nBuckets = int(maxArc) + 1;
+	if (newKind == kind && nBuckets == buckets.size()) {
+		clear();
+		return;
+	}
+	kind = newKind;
+	buckets = Vector< Vector<queueEntryT> >(nBuckets);
+	for (int i = 0; i < nBuckets; i++) {
+		buckets.add(Vector<queueEntryT>());
+	}
+	clear();
+}
+
+queueKindT DistanceQueue::getKind() {
+	return kind;
+}
+
+int DistanceQueue::size() {
+	return count;
+}
+
+bool DistanceQueue::isEmpty() {
+	return count == 0;
+}
+
+/*
+ * Implementation notes: clear
+ * ---------------------------
+ * Vector::clear releases the storage of the vector, so this method
+ * instead truncates the heap and the buckets to size 0.  Truncating
+ * takes constant time however many entries a search left behind, which
+ * matters when a search is stopped early with a full queue, and the
+ * vectors keep their capacity, which means that a queue reused for
+ * many searches stops allocating memory once it has grown to the size
+ * of the largest search.
+ */
+
+void DistanceQueue::clear() {
+	heap.truncate(0);
+	for (int i = 0; i < buckets.size(); i++) {
+		buckets[i].truncate(0);
+	}
+	count = 0;
+	peak = 0;
+	nPushes = nPops = 0;
+	last = 0;
+}
+
+void DistanceQueue::enqueue(int node, double dist) {
+	queueEntryT entry = { node, dist };
+	count++;
+	nPushes++;
+	if (count > peak) peak = count;
+	switch (kind) {
+	  case RADIX_HEAP:
+		buckets[radixBucket((unsigned long) dist)].add(entry);
+		break;
+	  case DIAL_BUCKETS:
+		buckets[((unsigned long) dist) % buckets.size()].add(entry);
+		break;
+	  default:
+		heapInsert(entry);
+		break;
+	}
+}
+
+queueEntryT DistanceQueue::dequeue() {
+	if (isEmpty()) Error("dequeue: Attempting to dequeue an empty queue");
+	count--;
+	nPops++;
+	switch (kind) {
+	  case RADIX_HEAP: return radixRemoveMin();
+	  case DIAL_BUCKETS: return dialRemoveMin();
+	  default: return heapRemoveMin();
+	}
+}
+
+long DistanceQueue::getPushCount() {
+	return nPushes;
+}
+
+long DistanceQueue::getPopCount() {
+	return nPops;
+}
+
+int DistanceQueue::getPeakSize() {
+	return peak;
+}
+
+/*
+ * Private methods: heapInsert, heapRemoveMin
+ * ------------------------------------------
+ * These methods maintain a binary min-heap of entries in a vector,
+ * ordered by priority.
+ */
+
+void DistanceQueue::heapInsert(queueEntryT entry) {
+	int index = heap.size();
+	heap.add(entry);
+	while (index > 0) {
+		int parent = (index - 1) / 2;
+		if (heap[parent].dist <= entry.dist) break;
+		heap[index] = heap[parent];
+		index = parent;
+	}
+	heap[index] = entry;
+}
+
+queueEntryT DistanceQueue::heapRemoveMin() {
+	queueEntryT result = heap[0];
+	queueEntryT lastEntry = heap[heap.size() - 1];
+	heap.removeAt(heap.size() - 1);
+	int n = heap.size();
+	if (n == 0) return result;
+	int index = 0;
+	while (true) {
+		int child = 2 * index + 1;
+		if (child >= n) break;
+		if (child + 1 < n && heap[child + 1].dist < heap[child].dist) child++;
+		if (lastEntry.dist <= heap[child].dist) break;
+		heap[index] = heap[child];
+		index = child;
+	}
+	heap[index] = lastEntry;
+	return result;
+}
+
+/*
+ * Private methods: radixBucket, radixRemoveMin
+ * --------------------------------------------
+ * A key belongs in bucket b if the highest bit in which it differs from
+ * last is bit b - 1, and in bucket 0 if it equals last.  To dequeue,
+ * the implementation finds the first nonempty bucket, makes its
+ * smallest key the new value of last, and redistributes the bucket's
+ * entries, all of which land in lower buckets because they agree with
+ * the new last in more of their high-order bits.  Since no entry goes
+ * back into the bucket being emptied, the entries are redistributed
+ * in place and the bucket is then truncated, which keeps its storage
+ * for later searches, as described for clear.
+ */
+
+int DistanceQueue::radixBucket(unsigned long key) {
+	unsigned long diff = key ^ last;
+	if (diff == 0) return 0;
+#ifdef __GNUC__
+	return RADIX_BUCKETS - 1 - __builtin_clzl(diff);
+#else
+	int bucket = 0;
+	while (diff != 0) {
+		bucket++;
+		diff >>= 1;
+	}
+	return bucket;
+#endif
+}
+
+queueEntryT DistanceQueue::radixRemoveMin() {
+	if (buckets[0].isEmpty()) {
+		int b = 1;
+		while (buckets[b].isEmpty()) {
+			b++;
+		}
+		Vector<queueEntryT> & entries = buckets[b];
+		unsigned long minKey = (unsigned long) entries[0].dist;
+		for (int i = 1; i < entries.size(); i++) {
+			unsigned long key = (unsigned long) entries[i].dist;
+			if (key < minKey) minKey = key;
+		}
+		last = minKey;
+		for (int i = 0; i < entries.size(); i++) {
+			buckets[radixBucket((unsigned long) entries[i].dist)].add(entries[i]);
+		}
+		entries.truncate(0);
+	}
+	Vector<queueEntryT> & bucket = buckets[0];
+	queueEntryT result = bucket[bucket.size() - 1];
+	bucket.removeAt(bucket.size() - 1);
+	return result;
+}
+
+/*
+ * Private method: dialRemoveMin
+ * -----------------------------
+ * The value of last is the current minimum priority.  Because every
+ * pending priority lies within maxArc of that value, the first nonempty
+ * bucket at or after last modulo the number of buckets holds the
+ * smallest pending priority.
+ */
+
+queueEntryT DistanceQueue::dialRemoveMin() {
+	int nBuckets = buckets.size();
+	while (buckets[last % nBuckets].isEmpty()) {
+		last++;
+	}
+	Vector<queueEntryT> & bucket = buckets[last % nBuckets];
+	queueEntryT result = bucket[bucket.size() - 1];
+	bucket.removeAt(bucket.size() - 1);
+	return result;
+}
@@ -0,0 +1,224 @@
+/*
+ * File: distqueue.h
+ * -----------------
+ * This file provides the interface to the DistanceQueue class, the
+ * priority queue used by the shortest-path engines.  Unlike PQueue,
+ * which is a general-purpose class that accepts any priorities in any
+ * order, a DistanceQueue exploits two properties of Dijkstra's
+ * algorithm: the elements are node indices, and the priorities are
+ * monotone, which means that no element is ever enqueued with a
+ * priority smaller than that of the most recently dequeued element.
+ */
+
+#ifndef _distqueue_h
+#define _distqueue_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+#include "compactgraph.h"
+#include "snapshot.h"
+
+/*
+ * Type: queueKindT
+ * ----------------
+ * This enumerated type identifies the representations available for
+ * a DistanceQueue:
+ *
+ *   BINARY_HEAP   A binary heap, which works for any nonnegative
+ *                 priorities and costs O(log N) per operation.
+ *   RADIX_HEAP    A radix heap, which requires integral priorities.
+ *                 Each element moves between buckets at most once
+ *                 per bit of the priority, and the bucket operations
+ *                 are simple vector appends.
+ *   DIAL_BUCKETS  Dial's algorithm, which requires integral priorities
+ *                 and a small maximum arc distance C.  The queue is a
+ *                 cyclic array of C + 1 buckets, which makes enqueue
+ *                 a constant-time operation.
+ *   AUTO_QUEUE    A request that the client choose the best of the
+ *                 above for a particular graph by calling
+ *                 ChooseQueueKind.
+ */
+
+enum queueKindT { BINARY_HEAP, RADIX_HEAP, DIAL_BUCKETS, AUTO_QUEUE };
+
+/*
+ * Type: queueEntryT
+ * -----------------
+ * This type is the value returned by dequeue, which consists of the
+ * node index and the priority with which it was enqueued.
+ */
+
+struct queueEntryT {
+	int node;
+	double dist;
+};
+
+/*
+ * Function: ChooseQueueKind
+ * Usage: queueKindT kind = ChooseQueueKind(graph, maxArc);
+ * --------------------------------------------------------
+ * Examines the arc distances in the graph and returns the fastest
+ * representation that can handle them.  If every distance is a
+ * nonnegative integer, the function returns DIAL_BUCKETS when the
+ * longest arc is short enough for Dial's algorithm and RADIX_HEAP
+ * otherwise; in all other cases it returns BINARY_HEAP.  The length
+ * of the longest arc is stored in the reference parameter maxArc,
+ * which is the value the client must pass to setKind.
+ */
+
+queueKindT ChooseQueueKind(Graph<nodeT,arcT> & graph, double & maxArc);
+
+/*
+ * Function: ChooseQueueKind
+ * Usage: queueKindT kind = ChooseQueueKind(compact, maxArc);
+ * ----------------------------------------------------------
+ * Makes the same choice for a CompactGraph, as described in
+ * compactgraph.h.  The coding of its distances already records whether
+ * they are all integers, so this form takes constant time.
+ */
+
+queueKindT ChooseQueueKind(CompactGraph & compact, double & maxArc);
+
+/*
+ * Function: ChooseQueueKind
+ * Usage: queueKindT kind = ChooseQueueKind(snapshot, maxArc);
+ * -----------------------------------------------------------
+ * Makes the same choice for a GraphSnapshot, as described in
+ * snapshot.h, in constant time.  The value stored in maxArc is the
+ * bound kept by the snapshot, which may exceed the longest arc.
+ */
+
+queueKindT ChooseQueueKind(GraphSnapshot & snapshot, double & maxArc);
+
+/*
+ * Class: DistanceQueue
+ * --------------------
+ * This class models a monotone priority queue of node indices.  The
+ * lowest priority is dequeued first.  Elements with equal priorities
+ * are not guaranteed to come out in any particular order.
+ */
+
+class DistanceQueue {
+public:
+
+/*
+ * Constructor: DistanceQueue
+ * Usage: DistanceQueue queue;
+ * ---------------------------
+ * Initializes an empty queue that uses a binary heap.
+ */
+	DistanceQueue();
+
+/*
+ * Destructor: ~DistanceQueue
+ * Usage: (usually implicit)
+ * -------------------------
+ * The destructor deallocates storage associated with this queue.
+ */
+	~DistanceQueue();
+
+/*
+ * Method: setKind
+ * Usage: queue.setKind(kind, maxArc);
+ * -----------------------------------
+ * Empties the queue and selects its representation.  The maxArc
+ * parameter is the length of the longest arc in the graph, which
+ * determines the number of buckets used by DIAL_BUCKETS.  Passing
+ * AUTO_QUEUE is an error, since the choice depends on the graph.
+ * If the representation does not change, the queue keeps the storage
+ * it has already allocated.
+ */
+	void setKind(queueKindT kind, double maxArc = 0);
+
+/*
+ * Method: getKind
+ * Usage: queueKindT kind = queue.getKind();
+ * -----------------------------------------
+ * Returns the representation currently in use.
+ */
+	queueKindT getKind();
+
+/*
+ * Methods: size, isEmpty, clear
+ * Usage: int n = queue.size();
+ *        if (queue.isEmpty()) . . .
+ *        queue.clear();
+ * ---------------------------------
+ * These methods return the number of entries in the queue, test
+ * whether it is empty, and remove all of its entries.  Clearing the
+ * queue also resets the monotone lower bound on priorities and the
+ * operation counts to 0 but does not release the queue's storage, so
+ * that it can be reused.
+ */
+	int size();
+	bool isEmpty();
+	void clear();
+
+/*
+ * Method: enqueue
+ * Usage: queue.enqueue(node, dist);
+ * ---------------------------------
+ * Adds the node index to the queue with the specified priority, which
+ * must not be smaller than the priority of the last entry dequeued.
+ * A node may be enqueued more than once; each entry is dequeued
+ * separately.
+ */
+	void enqueue(int node, double dist);
+
+/*
+ * Method: dequeue
+ * Usage: queueEntryT entry = queue.dequeue();
+ * -------------------------------------------
+ * Removes and returns an entry with the lowest priority.
+ */
+	queueEntryT dequeue();
+
+/*
+ * Methods: getPushCount, getPopCount, getPeakSize
+ * Usage: long pushes = queue.getPushCount();
+ *        long pops = queue.getPopCount();
+ *        int peak = queue.getPeakSize();
+ * ------------------------------------------
+ * These methods return the number of calls to enqueue and dequeue and
+ * the largest number of entries the queue has held since it was last
+ * cleared.  The search engines report them in a searchStatsT record,
+ * as described in searchstats.h.
+ */
+	long getPushCount();
+	long getPopCount();
+	int getPeakSize();
+
+private:
+
+/* Constants */
+
+	static const int RADIX_BUCKETS = 8 * sizeof(unsigned long) + 1;
+
+/* Instance variables */
+
+	queueKindT kind;
+	int count;                             /* Number of entries       */
+	int peak;                              /* Largest count so far    */
+	long nPushes, nPops;                   /* Operation counts        */
+	unsigned long last;                    /* Lower bound on priority */
+	Vector<queueEntryT> heap;              /* Used by BINARY_HEAP     */
+	Vector< Vector<queueEntryT> > buckets; /* Used by the others      */
+
+/* Private methods */
+
+	void heapInsert(queueEntryT entry);
+	queueEntryT heapRemoveMin();
+	int radixBucket(unsigned long key);
+	queueEntryT radixRemoveMin();
+	queueEntryT dialRemoveMin();
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(DistanceQueue)
+
+};
+
+#endif
@@ -0,0 +1,191 @@
+/*
+ * File: dynamictree.cpp
+ * ---------------------
+ * This file implements the dynamictree.h interface.
+ */
+
+#include "genlib.h"
+#include "dynamictree.h"
+#include "sssp.h"
+
+DynamicTree::DynamicTree() {
+	graph = NULL;
+	forgetSource();
+}
+
+DynamicTree::DynamicTree(Graph<nodeT,arcT> & graph, nodeT *source) {
+	this->graph = NULL;
+	attach(graph, source);
+}
+
+DynamicTree::~DynamicTree() {
+	detach();
+}
+
+void DynamicTree::attach(Graph<nodeT,arcT> & graph, nodeT *source) {
+	detach();
+	this->graph = &graph;
+	this->source = source;
+	DijkstraTree(graph, source, dist, parent);
+	graphVersion = graph.getVersion();
+	graph.addListener(this);
+}
+
+void DynamicTree::detach() {
+	if (graph != NULL) graph->removeListener(this);
+	graph = NULL;
+	forgetSource();
+}
+
+nodeT *DynamicTree::getSource() {
+	return source;
+}
+
+double DynamicTree::getDistance(nodeT *node) {
+	if (source == NULL) Error("DynamicTree: The tree has no source");
+	update();
+	return dist[node->index];
+}
+
+/*
+ * Implementation notes: getPath
+ * -----------------------------
+ * The parent arcs lead backward from the node to the source, so the
+ * path is collected in reverse order and then turned around.
+ */
+
+Vector<arcT *> DynamicTree::getPath(nodeT *node) {
+	if (source == NULL) Error("DynamicTree: The tree has no source");
+	update();
+	Vector<arcT *> reversed;
+	for (arcT *arc = parent[node->index]; arc != NULL;
+	     arc = parent[arc->start->index]) {
+		reversed.add(arc);
+	}
+	Vector<arcT *> path(reversed.size());
+	for (int i = reversed.size() - 1; i >= 0; i--) {
+		path.add(reversed[i]);
+	}
+	return path;
+}
+
+int DynamicTree::getRepairCount() {
+	return nRepairs;
+}
+
+searchStatsT DynamicTree::getLastRepair() {
+	return lastRepair;
+}
+
+/*
+ * Implementation notes: listener methods
+ * --------------------------------------
+ * Each method that brings the tree up to date first calls adoptVersion,
+ * which leaves the tree to be computed again instead if the graph has
+ * changed without telling it.  A new node has no arcs yet, so it
+ * cannot be reached.  A node that is
+ * about to be removed has already lost its arcs, each of which was
+ * repaired as it went, so it too is unreachable unless it is the
+ * source.  The graph fills the hole it leaves with the node that has
+ * the highest index, and the tree moves that node's entries to match.
+ */
+
+void DynamicTree::nodeAdded(nodeT *node) {
+	if (!adoptVersion()) return;
+	dist.add(UNREACHABLE);
+	parent.add(NULL);
+}
+
+void DynamicTree::nodeRemoved(nodeT *node) {
+	if (source == NULL) return;
+	if (node == source) {
+		forgetSource();
+		return;
+	}
+	if (!adoptVersion()) return;
+	int last = dist.size() - 1;
+	dist[node->index] = dist[last];
+	parent[node->index] = parent[last];
+	dist.removeAt(last);
+	parent.removeAt(last);
+}
+
+void DynamicTree::arcAdded(arcT *arc) {
+	repair(arc, UNREACHABLE);
+}
+
+void DynamicTree::arcRemoved(arcT *arc) {
+	repair(arc, arc->distance);
+}
+
+void DynamicTree::arcWeightChanged(arcT *arc, double oldDistance) {
+	repair(arc, oldDistance);
+}
+
+void DynamicTree::graphReset() {
+	forgetSource();
+}
+
+/*
+ * Private method: repair
+ * Usage: repair(arc, oldDistance);
+ * --------------------------------
+ * Brings the tree up to date after a change to arc by calling
+ * RepairTree, unless the tree has no source or is already out of date.
+ */
+
+void DynamicTree::repair(arcT *arc, double oldDistance) {
+	if (!adoptVersion()) return;
+	RepairTree(*graph, dist, parent, arc, oldDistance, &lastRepair);
+	nRepairs++;
+}
+
+/*
+ * Private method: adoptVersion
+ * Usage: if (adoptVersion()) . . .
+ * --------------------------------
+ * Called by a listener method before it brings the tree up to date.
+ * If the tree has a source and matched the graph just before the
+ * change being reported, the tree records the new version and the
+ * method returns true.  Otherwise the method returns false, and a tree
+ * with a source is left for update to compute again.
+ */
+
+bool DynamicTree::adoptVersion() {
+	if (source == NULL || graphVersion != graph->getPreviousVersion()) {
+		return false;
+	}
+	graphVersion = graph->getVersion();
+	return true;
+}
+
+/*
+ * Private method: update
+ * Usage: update();
+ * ----------------
+ * Computes the tree again by calling DijkstraTree if the graph has
+ * changed since the tree last matched it.
+ */
+
+void DynamicTree::update() {
+	if (graphVersion != graph->getVersion()) {
+		DijkstraTree(*graph, source, dist, parent);
+		graphVersion = graph->getVersion();
+	}
+}
+
+/*
+ * Private method: forgetSource
+ * Usage: forgetSource();
+ * ----------------------
+ * Empties the tree and leaves it without a source.
+ */
+
+void DynamicTree::forgetSource() {
+	source = NULL;
+	dist.clear();
+	parent.clear();
+	nRepairs = 0;
+	ClearSearchStats(lastRepair);
+	graphVersion = 0;
+}
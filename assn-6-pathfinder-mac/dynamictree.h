@@ -0,0 +1,150 @@
+/*
+ * File: dynamictree.h
+ * -------------------
+ * This file provides the interface to the DynamicTree class, which
+ * keeps the shortest-path tree from one source node correct while the
+ * arc distances of the graph change.  Traffic reports change only a
+ * few arcs at a time, and most such changes affect the paths to only
+ * a small part of the map, if they affect any at all.  Rather than
+ * recomputing the tree after each change, a DynamicTree repairs the
+ * part of it that the change affects, as described for RepairTree in
+ * sssp.h.
+ */
+
+#ifndef _dynamictree_h
+#define _dynamictree_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+#include "searchstats.h"
+
+/*
+ * Class: DynamicTree
+ * ------------------
+ * This class holds the shortest-path tree from a source node.  Once
+ * the tree is attached to a graph, it registers itself as a listener
+ * and repairs itself whenever an arc is added or removed or the graph's
+ * updateArcWeight method changes the distance of an arc.  A change the
+ * tree is not told about, such as a distance assigned to the field
+ * directly and followed by a call to the graph's markChanged method,
+ * still gives the graph a new version, as described in graph.h, and
+ * the tree computes itself again in full the next time it is used.
+ * The same happens after an arc is added by giving its endpoints,
+ * since its distance is not yet known when the tree is told, as
+ * described for GraphListener in graph.h.  A change that is not
+ * followed by markChanged goes unseen.
+ */
+
+class DynamicTree : public GraphListener<nodeT,arcT> {
+public:
+
+/*
+ * Constructor: DynamicTree
+ * Usage: DynamicTree tree;
+ *        DynamicTree tree(graph, source);
+ * ---------------------------------------
+ * Creates a shortest-path tree.  The second form attaches the tree to
+ * the graph, as described for the attach method.
+ */
+	DynamicTree();
+	DynamicTree(Graph<nodeT,arcT> & graph, nodeT *source);
+
+/*
+ * Destructor: ~DynamicTree
+ * Usage: (usually implicit)
+ * -------------------------
+ * Detaches the tree from its graph and frees its storage.
+ */
+	virtual ~DynamicTree();
+
+/*
+ * Methods: attach, detach
+ * Usage: tree.attach(graph, source);
+ *        tree.detach();
+ * ---------------------------------
+ * The attach method computes the tree of shortest paths from source
+ * to every node of the graph by calling DijkstraTree and registers the
+ * tree as a listener.  The graph must outlive the tree or be detached
+ * from it first.  The detach method unregisters the tree and empties
+ * it.
+ */
+	void attach(Graph<nodeT,arcT> & graph, nodeT *source);
+	void detach();
+
+/*
+ * Method: getSource
+ * Usage: nodeT *source = tree.getSource();
+ * ----------------------------------------
+ * Returns the source of the tree, or NULL if the tree is not attached.
+ * A tree whose source is removed from the graph, or whose graph is
+ * cleared, assigned, swapped, or reordered, has no source until it is
+ * attached again.
+ */
+	nodeT *getSource();
+
+/*
+ * Methods: getDistance, getPath
+ * Usage: double dist = tree.getDistance(node);
+ *        Vector<arcT *> path = tree.getPath(node);
+ * ------------------------------------------------
+ * These methods return the length of the shortest path from the source
+ * to node, or UNREACHABLE if there is none, and the arcs on that path
+ * in order.  The path is empty if node is the source or cannot be
+ * reached.  Calling either method on a tree with no source is an
+ * error.
+ */
+	double getDistance(nodeT *node);
+	Vector<arcT *> getPath(nodeT *node);
+
+/*
+ * Methods: getRepairCount, getLastRepair
+ * Usage: int n = tree.getRepairCount();
+ *        searchStatsT stats = tree.getLastRepair();
+ * -------------------------------------------------
+ * These methods return the number of repairs made since the tree was
+ * attached and the work done by the most recent one, in the form
+ * described in searchstats.h.  A change that does not affect the tree
+ * still counts as a repair, one that settles no nodes.  Computing the
+ * tree again in full does not.
+ */
+	int getRepairCount();
+	searchStatsT getLastRepair();
+
+/* Methods called by the graph, as described in graph.h */
+
+	virtual void nodeAdded(nodeT *node);
+	virtual void nodeRemoved(nodeT *node);
+	virtual void arcAdded(arcT *arc);
+	virtual void arcRemoved(arcT *arc);
+	virtual void arcWeightChanged(arcT *arc, double oldDistance);
+	virtual void graphReset();
+
+private:
+
+/* Instance variables */
+
+	Graph<nodeT,arcT> *graph;   /* The graph to which the tree is attached */
+	nodeT *source;              /* The source, or NULL if there is none    */
+	Vector<double> dist;        /* Distance to each node, as in sssp.h     */
+	Vector<arcT *> parent;      /* Last arc on the path to each node       */
+	int nRepairs;               /* Repairs since the tree was attached     */
+	searchStatsT lastRepair;    /* Work done by the most recent repair     */
+	long graphVersion;          /* The version the tree last matched       */
+
+/* Private methods */
+
+	void repair(arcT *arc, double oldDistance);
+	bool adoptVersion();
+	void update();
+	void forgetSource();
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(DynamicTree)
+
+};
+
+#endif
@@ -12,7 +12,7 @@
 #define _graphtypes_h
 
 #include "point.h"
-#include "set.h"
+#include "smallset.h"
 
 /* Forward references to nodeT and arcT */
 
@@ -23,12 +23,18 @@ struct arcT;
  * Type: nodeT
  * -----------
  * This type represents an individual node and consists of the
- * name of the node and the set of arcs that leave this node.
+ * name of the node, the set of arcs that leave this node, and the
+ * set of arcs that enter it, which the Graph class maintains along
+ * with the node's position in the graph's dense numbering.  Most
+ * nodes in a road map have only a few arcs, so they are kept in a
+ * SmallSet, which stores them inline without any heap allocation.
  */
 
 struct nodeT {
 	string name;
-	Set<arcT *> arcs;
+	SmallSet<arcT *> arcs;
+	SmallSet<arcT *> incoming;
+	int index;
 	pointT loc;
 };
 
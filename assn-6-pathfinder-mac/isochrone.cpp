@@ -0,0 +1,152 @@
+/*
+ * File: isochrone.cpp
+ * -------------------
+ * This file implements the isochrone.h interface.
+ */
+
+#include "genlib.h"
+#include "isochrone.h"
+
+Isochrone::Isochrone() {
+	graph = NULL;
+	limit = -1;
+	relaxed = 0;
+	stats = NULL;
+	control = NULL;
+	stopped = false;
+	clock = 0;
+}
+
+Isochrone::~Isochrone() {
+	/* Empty */
+}
+
+void Isochrone::start(Graph<nodeT,arcT> & graph, nodeT *source, double limit) {
+	Vector<nodeT *> sources;
+	sources.add(source);
+	start(graph, sources, limit);
+}
+
+/*
+ * Implementation notes: start
+ * ---------------------------
+ * The sources all enter the queue at distance 0, which is equivalent to
+ * searching from a single node joined to each of them by an arc of
+ * length 0.  Resetting the workspace takes constant time, however much
+ * the previous search left in the queue, so no step of a search looks
+ * at nodes outside the region it reaches.
+ */
+
+void Isochrone::start(Graph<nodeT,arcT> & graph, Vector<nodeT *> & sources,
+                      double limit) {
+	if (stats != NULL) {
+		ClearSearchStats(*stats);
+		clock = SearchClock();
+	}
+	this->graph = &graph;
+	this->limit = limit;
+	relaxed = 0;
+	stopped = false;
+	if (control != NULL) control->begin();
+	space.reset(graph);
+	if (limit >= 0) {
+		for (int i = 0; i < sources.size(); i++) {
+			int index = sources[i]->index;
+			if (space.getDistance(index) != 0) {
+				space.setDistance(index, 0, NULL);
+				space.getQueue().enqueue(index, 0);
+			}
+		}
+	}
+	if (stats != NULL) {
+		double now = SearchClock();
+		stats->setupTime = now - clock;
+		clock = now;
+	}
+}
+
+/*
+ * Implementation notes: next
+ * --------------------------
+ * This method performs the steps of Dijkstra's algorithm up to the next
+ * node it settles.  Tentative distances beyond the limit are never
+ * entered in the queue, so every entry that is still current when it
+ * is dequeued belongs to a node within the limit.  The control is
+ * checked after a node has been settled and its arcs relaxed, so that
+ * node is still returned; the stopped flag then ends the search at the
+ * next call without disturbing the counts kept by the workspace.
+ */
+
+bool Isochrone::next(nodeT * & node, double & dist) {
+	DistanceQueue & queue = space.getQueue();
+	while (!stopped && !queue.isEmpty()) {
+		queueEntryT entry = queue.dequeue();
+		if (space.isSettled(entry.node)) continue;
+		space.settle(entry.node);
+		node = graph->getNodeByIndex(entry.node);
+		dist = entry.dist;
+		relaxed += node->arcs.size();
+		for (int i = 0; i < node->arcs.size(); i++) {
+			arcT *arc = node->arcs[i];
+			int finish = arc->finish->index;
+			double newDist = dist + arc->distance;
+			if (newDist <= limit && newDist < space.getDistance(finish)) {
+				space.setDistance(finish, newDist, arc);
+				queue.enqueue(finish, newDist);
+			}
+		}
+		if (control != NULL
+		    && space.getSettledCount() % SEARCH_CHECK_INTERVAL == 0
+		    && control->check(dist)) {
+			stopped = true;
+		}
+		return true;
+	}
+	if (stats != NULL) {
+		space.fillStats(*stats);
+		stats->relaxed = relaxed;
+		stats->searchTime = SearchClock() - clock;
+	}
+	return false;
+}
+
+void Isochrone::mapReachable(Graph<nodeT,arcT> & graph, nodeT *source,
+                             double limit,
+                             void (*fn)(nodeT *node, double dist)) {
+	start(graph, source, limit);
+	nodeT *node;
+	double dist;
+	while (next(node, dist)) {
+		fn(node, dist);
+	}
+}
+
+void Isochrone::mapReachable(Graph<nodeT,arcT> & graph,
+                             Vector<nodeT *> & sources, double limit,
+                             void (*fn)(nodeT *node, double dist)) {
+	start(graph, sources, limit);
+	nodeT *node;
+	double dist;
+	while (next(node, dist)) {
+		fn(node, dist);
+	}
+}
+
+arcT *Isochrone::getParentArc(nodeT *node) {
+	if (!space.isSettled(node->index)) {
+		Error("getParentArc: Node has not been settled");
+	}
+	return space.getParentArc(node->index);
+}
+
+int Isochrone::getSettledCount() {
+	return space.getSettledCount();
+}
+
+void Isochrone::setStats(searchStatsT & stats) {
+	this->stats = &stats;
+}
+
+void Isochrone::setControl(SearchControl & control) {
+	this->control = &control;
+}
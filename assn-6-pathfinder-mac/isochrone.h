@@ -0,0 +1,174 @@
+/*
+ * File: isochrone.h
+ * -----------------
+ * This file provides the interface to the Isochrone class, which finds
+ * every node within a given distance of one or more sources.  Such
+ * queries describe the area served from a point, and the nodes they
+ * return mark the boundary of what can be reached within a budget.
+ * Unlike the functions in sssp.h, the search stops at the budget, so
+ * its cost depends only on the size of the region it reaches.
+ */
+
+#ifndef _isochrone_h
+#define _isochrone_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+#include "searchspace.h"
+#include "searchcontrol.h"
+
+/*
+ * Class: Isochrone
+ * ----------------
+ * This class runs distance-bounded searches.  The nodes are reported
+ * in order of increasing distance as the search settles them, either
+ * one at a time through the next method or by calling a function for
+ * each one, so a client can start drawing or aggregating the results
+ * before the search is complete.  Each Isochrone keeps the workspace
+ * of its searches, so a client that runs many queries should reuse a
+ * single object rather than creating a new one for each query.
+ */
+
+class Isochrone {
+public:
+
+/*
+ * Constructor: Isochrone
+ * Usage: Isochrone iso;
+ * ---------------------
+ * Creates an Isochrone with no search in progress.
+ */
+	Isochrone();
+
+/*
+ * Destructor: ~Isochrone
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees the workspace used by the searches.
+ */
+	~Isochrone();
+
+/*
+ * Method: start
+ * Usage: iso.start(graph, source, limit);
+ *        iso.start(graph, sources, limit);
+ * ----------------------------------------
+ * Begins a search for the nodes whose distance from source, or from
+ * the nearest of the sources, is at most limit.  The search does no
+ * work until the client asks for the nodes.  The graph must not change
+ * while the search is in progress.
+ */
+	void start(Graph<nodeT,arcT> & graph, nodeT *source, double limit);
+	void start(Graph<nodeT,arcT> & graph, Vector<nodeT *> & sources,
+	           double limit);
+
+/*
+ * Method: next
+ * Usage: while (iso.next(node, dist)) . . .
+ * -----------------------------------------
+ * Settles the next node of the current search and stores it and its
+ * distance in the reference parameters.  The method returns false
+ * when no node within the limit remains, or when the control set by
+ * setControl has stopped the search.
+ */
+	bool next(nodeT * & node, double & dist);
+
+/*
+ * Method: mapReachable
+ * Usage: iso.mapReachable(graph, source, limit, fn);
+ *        iso.mapReachable(graph, source, limit, fn, data);
+ *        iso.mapReachable(graph, sources, limit, fn);
+ *        iso.mapReachable(graph, sources, limit, fn, data);
+ * -------------------------------------------------------
+ * Runs a complete search and calls fn(node, dist) or
+ * fn(node, dist, data) for each node within the limit as it is
+ * settled, in order of increasing distance.
+ */
+	void mapReachable(Graph<nodeT,arcT> & graph, nodeT *source, double limit,
+	                  void (*fn)(nodeT *node, double dist));
+	void mapReachable(Graph<nodeT,arcT> & graph, Vector<nodeT *> & sources,
+	                  double limit, void (*fn)(nodeT *node, double dist));
+
+	template <typename ClientDataType>
+	void mapReachable(Graph<nodeT,arcT> & graph, nodeT *source, double limit,
+	                  void (*fn)(nodeT *node, double dist, ClientDataType & data),
+	                  ClientDataType & data);
+
+	template <typename ClientDataType>
+	void mapReachable(Graph<nodeT,arcT> & graph, Vector<nodeT *> & sources,
+	                  double limit,
+	                  void (*fn)(nodeT *node, double dist, ClientDataType & data),
+	                  ClientDataType & data);
+
+/*
+ * Method: getParentArc
+ * Usage: arcT *arc = iso.getParentArc(node);
+ * ------------------------------------------
+ * Returns the last arc on the shortest path to a node that the current
+ * search has settled, or NULL if the node is a source.  Following the
+ * parent arcs back from any settled node leads to the source nearest
+ * to it, which makes it easy to draw the tree of the service area or
+ * to assign each node to its source.
+ */
+	arcT *getParentArc(nodeT *node);
+
+/*
+ * Method: getSettledCount
+ * Usage: int n = iso.getSettledCount();
+ * -------------------------------------
+ * Returns the number of nodes the current search has settled so far.
+ */
+	int getSettledCount();
+
+/*
+ * Method: setStats
+ * Usage: iso.setStats(stats);
+ * ---------------------------
+ * Asks every later search to report its work in the stats record, as
+ * described in searchstats.h.  The setup time is recorded by start,
+ * and the other fields when next returns false.  The search time runs
+ * from the end of start to that call, so it includes the time that
+ * the client spends between calls to next.  No path is read back, so
+ * the path time is always 0.
+ */
+	void setStats(searchStatsT & stats);
+
+/*
+ * Method: setControl
+ * Usage: iso.setControl(control);
+ * -------------------------------
+ * Places every later search under control, as described in
+ * searchcontrol.h.  The control is checked every SEARCH_CHECK_INTERVAL
+ * settled nodes.  If it stops a search, next returns false from then
+ * on; every node closer than the bound reported by the control has
+ * already been returned.
+ */
+	void setControl(SearchControl & control);
+
+private:
+
+/* Instance variables */
+
+	Graph<nodeT,arcT> *graph;   /* The graph being searched             */
+	double limit;               /* The largest distance reported        */
+	SearchSpace space;          /* Workspace reused by every search     */
+	long relaxed;               /* Arcs relaxed by the current search   */
+	searchStatsT *stats;        /* Record set by setStats, or NULL      */
+	SearchControl *control;     /* Control set by setControl, or NULL   */
+	bool stopped;               /* True if the control stopped a search */
+	double clock;               /* Time at which the last phase began   */
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(Isochrone)
+
+};
+
+/* Include the implementation of the template methods */
+
+#include "isochroneimpl.cpp"
+
+#endif
@@ -0,0 +1,37 @@
+/*
+ * File: isochroneimpl.cpp
+ * -----------------------
+ * This file implements the template versions of mapReachable.  C++
+ * requires that this code be available at the time the interface is
+ * read, but clients are not expected to look at this code.
+ */
+
+#ifdef _isochrone_h
+
+template <typename ClientDataType>
+void Isochrone::mapReachable(Graph<nodeT,arcT> & graph, nodeT *source,
+                  double limit,
+                  void (*fn)(nodeT *node, double dist, ClientDataType & data),
+                  ClientDataType & data) {
+	start(graph, source, limit);
+	nodeT *node;
+	double dist;
+	while (next(node, dist)) {
+		fn(node, dist, data);
+	}
+}
+
+template <typename ClientDataType>
+void Isochrone::mapReachable(Graph<nodeT,arcT> & graph,
+                  Vector<nodeT *> & sources, double limit,
+                  void (*fn)(nodeT *node, double dist, ClientDataType & data),
+                  ClientDataType & data) {
+	start(graph, sources, limit);
+	nodeT *node;
+	double dist;
+	while (next(node, dist)) {
+		fn(node, dist, data);
+	}
+}
+
+#endif
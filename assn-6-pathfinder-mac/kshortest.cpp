@@ -0,0 +1,333 @@
+/*
+ * File: kshortest.cpp
+ * -------------------
+ * This file implements the kshortest.h interface.
+ */
+
+#include "genlib.h"
+#include "kshortest.h"
+#include "searchspace.h"
+#include "sssp.h"
+
+/*
+ * Implementation notes: KShortestPaths
+ * ------------------------------------
+ * Yen's algorithm finds each new path as a deviation from one that has
+ * already been accepted.  For each spur node on an accepted path, it
+ * keeps the root of the path up to that node and searches for the best
+ * way on to the finish that leaves the root at a new arc and never
+ * returns to the root.  The best of all these candidates is the next
+ * path.  This implementation adds the usual refinements:
+ *
+ *  1. Following Lawler, a path is only spurred from its deviation
+ *     node onward, since the spurs from nodes before that point were
+ *     already tried when its parent was accepted.  The candidates then
+ *     partition the remaining paths, so no candidate is found twice.
+ *
+ *  2. The graph is never changed.  The root nodes are masked with a
+ *     vector of flags, and the arcs leaving the spur node along other
+ *     accepted paths with the same root are skipped by the search.
+ *
+ *  3. A single backward search from the finish gives the exact
+ *     distance from every node to the finish, together with the first
+ *     arc of a shortest path.  If that path from the spur node avoids
+ *     the masked nodes and arcs, it is the spur path and no search is
+ *     needed.  Otherwise the spur path is found by A* with those
+ *     distances as the estimates, which remain lower bounds when nodes
+ *     and arcs are masked and lead the search almost straight to the
+ *     finish.  Nodes that cannot reach the finish are never expanded.
+ *
+ *  4. A candidate stores only its spur and the number of arcs it
+ *     shares with its parent, so the prefixes are not copied until a
+ *     candidate is accepted.
+ *
+ * A control is passed to the backward search and checked by each A*
+ * search.  Once it has stopped the computation, no more candidates are
+ * accepted or spurred.
+ */
+
+/*
+ * Type: candidateT
+ * ----------------
+ * This type describes a candidate path, which follows the first
+ * devIndex arcs of the accepted path with index parent and then the
+ * arcs in spur.
+ */
+
+struct candidateT {
+	int parent;
+	int devIndex;
+	Vector<arcT *> spur;
+	double dist;
+};
+
+/*
+ * Type: spurStateT
+ * ----------------
+ * This structure holds the data used by the spur searches.  The toFinish
+ * and next vectors hold the reverse shortest-path tree of the finish,
+ * blocked marks the nodes of the current root, and blockedArcs lists
+ * the arcs that may not leave the spur node.  If the client asked for
+ * statistics, stats points to the record to which each spur search
+ * adds its counts.  The control is the client's, or NULL, and
+ * lastDist is the length of the last path accepted, which is the bound
+ * given to the control if it stops a spur search.
+ */
+
+struct spurStateT {
+	Graph<nodeT,arcT> *graph;
+	nodeT *finish;
+	Vector<double> toFinish;
+	Vector<arcT *> next;
+	Vector<bool> blocked;
+	Vector<arcT *> blockedArcs;
+	SearchSpace space;
+	searchStatsT *stats;
+	SearchControl *control;
+	double lastDist;
+};
+
+/* Prototypes */
+
+static void SpurFromPath(spurStateT & state, Vector< Vector<arcT *> > & accepted,
+                         Vector<int> & deviations, int k,
+                         Vector<candidateT> & candidates);
+static bool FindSpur(spurStateT & state, nodeT *spurNode,
+                     Vector<arcT *> & spur, double & spurDist);
+static bool ArcBlocked(spurStateT & state, arcT *arc);
+static int SharedPrefix(Vector<arcT *> & p1, Vector<arcT *> & p2);
+
+Vector<Path> KShortestPaths(Graph<nodeT,arcT> & graph,
+                            nodeT *start, nodeT *finish, int k,
+                            ComponentIndex *components,
+                            searchStatsT *stats, SearchControl *control) {
+	Vector<Path> result;
+	double clock = 0;
+	if (stats != NULL) {
+		ClearSearchStats(*stats);
+		clock = SearchClock();
+	}
+	if (control != NULL) control->begin();
+	if (k <= 0) return result;
+	if (components != NULL && !components->sameComponent(start, finish)) {
+		if (stats != NULL) stats->setupTime = SearchClock() - clock;
+		return result;
+	}
+	spurStateT state;
+	state.graph = &graph;
+	state.finish = finish;
+	state.stats = stats;
+	state.control = control;
+	state.lastDist = 0;
+	searchStatsT treeStats;
+	ReverseDijkstraTree(graph, finish, state.toFinish, state.next, AUTO_QUEUE,
+	                    (stats == NULL) ? NULL : &treeStats, control);
+	if (stats != NULL) {
+		*stats = treeStats;
+		stats->setupTime = SearchClock() - clock;
+		stats->searchTime = 0;
+		clock = SearchClock();
+	}
+	if (control != NULL && control->isStopped()) return result;
+	if (state.toFinish[start->index] == UNREACHABLE) return result;
+	state.blocked = Vector<bool>(graph.size());
+	for (int i = 0; i < graph.size(); i++) {
+		state.blocked.add(false);
+	}
+	Vector< Vector<arcT *> > accepted;
+	Vector<int> deviations;
+	Vector<candidateT> candidates;
+	candidateT first;
+	first.parent = -1;
+	first.devIndex = 0;
+	first.dist = state.toFinish[start->index];
+	for (nodeT *node = start; node != finish; node = state.next[node->index]->finish) {
+		first.spur.add(state.next[node->index]);
+	}
+	candidates.add(first);
+	while (accepted.size() < k && !candidates.isEmpty()) {
+		if (control != NULL && control->isStopped()) break;
+		int best = 0;
+		for (int i = 1; i < candidates.size(); i++) {
+			if (candidates[i].dist < candidates[best].dist) best = i;
+		}
+		candidateT & chosen = candidates[best];
+		Vector<arcT *> arcs(chosen.devIndex + chosen.spur.size());
+		for (int i = 0; i < chosen.devIndex; i++) {
+			arcs.add(accepted[chosen.parent][i]);
+		}
+		for (int i = 0; i < chosen.spur.size(); i++) {
+			arcs.add(chosen.spur[i]);
+		}
+		accepted.add(arcs);
+		deviations.add(chosen.devIndex);
+		state.lastDist = chosen.dist;
+		candidates[best] = candidates[candidates.size() - 1];
+		candidates.removeAt(candidates.size() - 1);
+		if (accepted.size() < k) {
+			SpurFromPath(state, accepted, deviations, accepted.size() - 1,
+			             candidates);
+		}
+	}
+	if (stats != NULL) {
+		double now = SearchClock();
+		stats->searchTime = now - clock;
+		clock = now;
+	}
+	for (int i = 0; i < accepted.size(); i++) {
+		Path path;
+		path.SetMap(graph);
+		path.SetRoute(start, accepted[i]);
+		result.add(path);
+	}
+	if (stats != NULL) stats->pathTime = SearchClock() - clock;
+	return result;
+}
+
+/*
+ * Function: SpurFromPath
+ * Usage: SpurFromPath(state, accepted, deviations, k, candidates);
+ * ----------------------------------------------------------------
+ * Adds the candidates that deviate from accepted path k at or after
+ * its deviation node.  At each spur node, the arcs that leave it along
+ * any accepted path with the same root are blocked; those are exactly
+ * the paths that share at least that many arcs with path k.
+ */
+
+static void SpurFromPath(spurStateT & state, Vector< Vector<arcT *> > & accepted,
+                         Vector<int> & deviations, int k,
+                         Vector<candidateT> & candidates) {
+	Vector<arcT *> & path = accepted[k];
+	Vector<int> shared(accepted.size());
+	for (int j = 0; j < accepted.size(); j++) {
+		shared.add(SharedPrefix(accepted[j], path));
+	}
+	double rootDist = 0;
+	for (int i = 0; i < deviations[k]; i++) {
+		state.blocked[path[i]->start->index] = true;
+		rootDist += path[i]->distance;
+	}
+	for (int i = deviations[k]; i < path.size(); i++) {
+		if (state.control != NULL && state.control->isStopped()) break;
+		nodeT *spurNode = path[i]->start;
+		state.blockedArcs.clear();
+		for (int j = 0; j < accepted.size(); j++) {
+			if (shared[j] >= i && accepted[j].size() > i) {
+				state.blockedArcs.add(accepted[j][i]);
+			}
+		}
+		candidateT candidate;
+		double spurDist;
+		if (FindSpur(state, spurNode, candidate.spur, spurDist)) {
+			candidate.parent = k;
+			candidate.devIndex = i;
+			candidate.dist = rootDist + spurDist;
+			candidates.add(candidate);
+		}
+		state.blocked[spurNode->index] = true;
+		rootDist += path[i]->distance;
+	}
+	for (int i = 0; i < path.size(); i++) {
+		state.blocked[path[i]->start->index] = false;
+	}
+}
+
+/*
+ * Function: FindSpur
+ * Usage: if (FindSpur(state, spurNode, spur, spurDist)) . . .
+ * -----------------------------------------------------------
+ * Finds the shortest path from spurNode to the finish that avoids the
+ * blocked nodes and does not begin with a blocked arc.  If there is
+ * one, the function stores its arcs in spur and its length in spurDist
+ * and returns true.  The tree path is tried first; A* is run only if
+ * that path runs into the root.
+ */
+
+static bool FindSpur(spurStateT & state, nodeT *spurNode,
+                     Vector<arcT *> & spur, double & spurDist) {
+	spur.clear();
+	if (state.toFinish[spurNode->index] == UNREACHABLE) return false;
+	bool treeOK = !ArcBlocked(state, state.next[spurNode->index]);
+	for (nodeT *node = spurNode; treeOK && node != state.finish;
+	     node = state.next[node->index]->finish) {
+		if (node != spurNode && state.blocked[node->index]) treeOK = false;
+	}
+	if (treeOK) {
+		for (nodeT *node = spurNode; node != state.finish;
+		     node = state.next[node->index]->finish) {
+			spur.add(state.next[node->index]);
+		}
+		spurDist = state.toFinish[spurNode->index];
+		return true;
+	}
+	SearchSpace & space = state.space;
+	space.reset(state.graph->size(), BINARY_HEAP);
+	DistanceQueue & queue = space.getQueue();
+	int goal = state.finish->index;
+	space.setDistance(spurNode->index, 0, NULL);
+	queue.enqueue(spurNode->index, state.toFinish[spurNode->index]);
+	long relaxed = 0;
+	while (!queue.isEmpty()) {
+		queueEntryT entry = queue.dequeue();
+		if (space.isSettled(entry.node)) continue;
+		space.settle(entry.node);
+		if (entry.node == goal) break;
+		if (state.control != NULL
+		    && space.getSettledCount() % SEARCH_CHECK_INTERVAL == 0
+		    && state.control->check(state.lastDist)) break;
+		nodeT *node = state.graph->getNodeByIndex(entry.node);
+		double nodeDist = space.getDistance(entry.node);
+		relaxed += node->arcs.size();
+		for (int i = 0; i < node->arcs.size(); i++) {
+			arcT *arc = node->arcs[i];
+			int next = arc->finish->index;
+			if (state.blocked[next] || state.toFinish[next] == UNREACHABLE) continue;
+			if (node == spurNode && ArcBlocked(state, arc)) continue;
+			double newDist = nodeDist + arc->distance;
+			if (newDist < space.getDistance(next)) {
+				space.setDistance(next, newDist, arc);
+				queue.enqueue(next, newDist + state.toFinish[next]);
+			}
+		}
+	}
+	if (state.stats != NULL) {
+		searchStatsT spurStats;
+		ClearSearchStats(spurStats);
+		space.fillStats(spurStats);
+		spurStats.relaxed = relaxed;
+		AddSearchStats(*state.stats, spurStats);
+	}
+	if (!space.isSettled(goal)) return false;
+	spurDist = space.getDistance(goal);
+	Vector<arcT *> reversed;
+	for (arcT *arc = space.getParentArc(goal); arc != NULL;
+	     arc = space.getParentArc(arc->start->index)) {
+		reversed.add(arc);
+	}
+	for (int i = reversed.size() - 1; i >= 0; i--) {
+		spur.add(reversed[i]);
+	}
+	return true;
+}
+
+static bool ArcBlocked(spurStateT & state, arcT *arc) {
+	for (int i = 0; i < state.blockedArcs.size(); i++) {
+		if (state.blockedArcs[i] == arc) return true;
+	}
+	return false;
+}
+
+/*
+ * Function: SharedPrefix
+ * Usage: int n = SharedPrefix(p1, p2);
+ * ------------------------------------
+ * Returns the number of arcs at the start of p1 and p2 that are equal.
+ */
+
+static int SharedPrefix(Vector<arcT *> & p1, Vector<arcT *> & p2) {
+	int n = 0;
+	while (n < p1.size() && n < p2.size() && p1[n] == p2[n]) {
+		n++;
+	}
+	return n;
+}
@@ -0,0 +1,59 @@
+/*
+ * File: kshortest.h
+ * -----------------
+ * This interface exports a function that finds alternatives to the
+ * shortest path between two nodes.  The alternatives are loopless,
+ * which means that no path visits the same node twice, and they are
+ * ranked by distance, so the first is always the path that the Path
+ * class itself would find.
+ */
+
+#ifndef _kshortest_h
+#define _kshortest_h
+
+#include "genlib.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+#include "path.h"
+#include "components.h"
+#include "searchstats.h"
+#include "searchcontrol.h"
+
+/*
+ * Function: KShortestPaths
+ * Usage: Vector<Path> paths = KShortestPaths(graph, start, finish, k);
+ *        Vector<Path> paths = KShortestPaths(graph, start, finish, k,
+ *                                            components);
+ *        Vector<Path> paths = KShortestPaths(graph, start, finish, k,
+ *                                            components, &stats);
+ *        Vector<Path> paths = KShortestPaths(graph, start, finish, k,
+ *                                            components, &stats, &control);
+ * --------------------------------------------------------------------------
+ * Returns the k shortest loopless paths from start to finish in order
+ * of increasing distance, using Yen's algorithm.  If the graph has
+ * fewer than k such paths, the result contains all of them, and it is
+ * empty if finish cannot be reached at all.  Each Path in the result
+ * already holds its route, so calling its methods never searches the
+ * graph again.  The graph is not modified, and all arc distances must
+ * be nonnegative.  If the client supplies a ComponentIndex for the
+ * graph, a start and finish in different components are rejected
+ * without any search.  If the client supplies a searchStatsT record,
+ * it receives the combined work of all the searches, as described in
+ * searchstats.h; the backward search from the finish counts as setup.
+ *
+ * If the client supplies a SearchControl, as described in
+ * searchcontrol.h, and it stops the computation, the result holds the
+ * paths accepted before that point, which are still the shortest ones
+ * in order.  The bound reported by the control is then the length of
+ * the last of them, since no path left out can be shorter, or a lower
+ * bound on the length of the shortest path if none was found.
+ */
+
+Vector<Path> KShortestPaths(Graph<nodeT,arcT> & graph,
+                            nodeT *start, nodeT *finish, int k,
+                            ComponentIndex *components = NULL,
+                            searchStatsT *stats = NULL,
+                            SearchControl *control = NULL);
+
+#endif
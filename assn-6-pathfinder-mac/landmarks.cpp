@@ -0,0 +1,432 @@
+/*
+ * File: landmarks.cpp
+ * -------------------
+ * This file implements the landmarks.h interface.
+ */
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include "genlib.h"
+#include "landmarks.h"
+#include "distqueue.h"
+#include "sssp.h"
+#include "parallel.h"
+#include "random.h"
+
+/*
+ * Constant: TABLE_HEADER
+ * ----------------------
+ * The first word in every landmark table file.
+ */
+
+const string TABLE_HEADER = "LANDMARKS";
+
+/*
+ * Type: tableStateT
+ * -----------------
+ * This structure holds the data shared by the threads that compute the
+ * backward tables.  Each thread writes only the tables of the landmarks
+ * assigned to it.
+ */
+
+struct tableStateT {
+	Graph<nodeT,arcT> *graph;
+	Vector<nodeT *> *landmarks;
+	Vector< Vector<double> > *tables;
+};
+
+/* Prototypes */
+
+static void SearchFrom(Graph<nodeT,arcT> & graph, nodeT *root, bool backward,
+                       Vector<double> & dist, Vector<int> *parent,
+                       Vector<int> *order);
+static void ComputeBackwardTables(int thread, int nThreads,
+                                  tableStateT & state);
+static double TotalArcDistance(Graph<nodeT,arcT> & graph);
+
+Landmarks::Landmarks() {
+	graphVersion = 0;
+}
+
+Landmarks::~Landmarks() {
+	/* Empty */
+}
+
+/*
+ * Implementation notes: select
+ * ----------------------------
+ * Both selection strategies depend on the forward tables of the
+ * landmarks already chosen, so the forward tables are computed one
+ * at a time as the landmarks are chosen.  The backward tables are
+ * needed only for queries and are computed in parallel at the end.
+ */
+
+void Landmarks::select(Graph<nodeT,arcT> & graph, int count,
+                       landmarkSelectionT method, int nThreads) {
+	if (nThreads <= 0) nThreads = GetProcessorCount();
+	clear();
+	if (count > graph.size()) count = graph.size();
+	while (landmarks.size() < count) {
+		nodeT *node = NULL;
+		if (method == AVOID_LANDMARKS) node = chooseAvoid(graph);
+		if (node == NULL) node = chooseFarthest(graph);
+		if (node == NULL) break;
+		landmarks.add(node);
+		fromLandmark.add(Vector<double>());
+		SearchFrom(graph, node, false,
+		           fromLandmark[fromLandmark.size() - 1], NULL, NULL);
+	}
+	for (int i = 0; i < landmarks.size(); i++) {
+		toLandmark.add(Vector<double>());
+	}
+	tableStateT state;
+	state.graph = &graph;
+	state.landmarks = &landmarks;
+	state.tables = &toLandmark;
+	if (nThreads > landmarks.size()) nThreads = landmarks.size();
+	RunInParallel(nThreads, ComputeBackwardTables, state);
+	graphVersion = graph.getVersion();
+}
+
+void Landmarks::prepare(Graph<nodeT,arcT> & graph, string mapFile) {
+	string filename = getTableFileName(mapFile);
+	if (load(graph, filename)) return;
+	select(graph);
+	save(graph, filename);
+}
+
+/*
+ * Implementation notes: load, save
+ * --------------------------------
+ * The file begins with a header line giving the number of landmarks,
+ * the numbers of nodes and arcs, and the sum of the arc distances,
+ * which together serve to detect a file that belongs to some other
+ * version of the map.  The names of the landmarks follow, one per
+ * line, and then two lines for each node: its name, and its distances
+ * from and to each landmark.  Names are stored on lines of their own
+ * because they may contain spaces.
+ */
+
+bool Landmarks::load(Graph<nodeT,arcT> & graph, string filename) {
+	ifstream infile(filename.c_str());
+	if (infile.fail()) return false;
+	string line, header;
+	int count, nNodes, nArcs;
+	double total;
+	getline(infile, line);
+	istringstream headerStream(line);
+	headerStream >> header >> count >> nNodes >> nArcs >> total;
+	if (headerStream.fail() || header != TABLE_HEADER) return false;
+	if (nNodes != graph.size() || nArcs != graph.getArcSet().size()) return false;
+	if (fabs(total - TotalArcDistance(graph)) > 1e-9 * (1 + fabs(total))) {
+		return false;
+	}
+	Vector<nodeT *> newLandmarks;
+	for (int i = 0; i < count; i++) {
+		if (!getline(infile, line) || !graph.nodeExists(line)) return false;
+		newLandmarks.add(graph.getNode(line));
+	}
+	Vector< Vector<double> > newFrom, newTo;
+	for (int i = 0; i < count; i++) {
+		newFrom.add(Vector<double>(nNodes));
+		newTo.add(Vector<double>(nNodes));
+		for (int j = 0; j < nNodes; j++) {
+			newFrom[i].add(UNREACHABLE);
+			newTo[i].add(UNREACHABLE);
+		}
+	}
+	for (int j = 0; j < nNodes; j++) {
+		if (!getline(infile, line) || !graph.nodeExists(line)) return false;
+		int index = graph.getNode(line)->index;
+		if (!getline(infile, line)) return false;
+		istringstream distStream(line);
+		for (int i = 0; i < count; i++) {
+			distStream >> newFrom[i][index];
+		}
+		for (int i = 0; i < count; i++) {
+			distStream >> newTo[i][index];
+		}
+		if (distStream.fail()) return false;
+	}
+	landmarks.swap(newLandmarks);
+	fromLandmark.swap(newFrom);
+	toLandmark.swap(newTo);
+	graphVersion = graph.getVersion();
+	return true;
+}
+
+void Landmarks::save(Graph<nodeT,arcT> & graph, string filename) {
+	if (!isCurrent(graph)) Error("save: Landmark tables are out of date");
+	ofstream outfile(filename.c_str());
+	if (outfile.fail()) Error("save: Can't open " + filename);
+	outfile.precision(17);
+	int count = landmarks.size();
+	outfile << TABLE_HEADER << " " << count << " " << graph.size() << " "
+	        << graph.getArcSet().size() << " " << TotalArcDistance(graph) << endl;
+	for (int i = 0; i < count; i++) {
+		outfile << landmarks[i]->name << endl;
+	}
+	for (int j = 0; j < graph.size(); j++) {
+		outfile << graph.getNodeByIndex(j)->name << endl;
+		for (int i = 0; i < count; i++) {
+			outfile << fromLandmark[i][j] << " ";
+		}
+		for (int i = 0; i < count; i++) {
+			outfile << toLandmark[i][j] << ((i + 1 < count) ? " " : "");
+		}
+		outfile << endl;
+	}
+}
+
+/*
+ * Implementation notes: getTableFileName
+ * --------------------------------------
+ * The table file has the same name as the map file with its extension
+ * replaced by .landmarks, so that USA.txt is paired with USA.landmarks.
+ */
+
+string Landmarks::getTableFileName(string mapFile) {
+	string::size_type dot = mapFile.rfind('.');
+	string::size_type slash = mapFile.rfind('/');
+	if (dot == string::npos || (slash != string::npos && dot < slash)) {
+		return mapFile + ".landmarks";
+	}
+	return mapFile.substr(0, dot) + ".landmarks";
+}
+
+int Landmarks::size() {
+	return landmarks.size();
+}
+
+nodeT *Landmarks::getLandmark(int i) {
+	return landmarks[i];
+}
+
+bool Landmarks::isCurrent(Graph<nodeT,arcT> & graph) {
+	return graphVersion == graph.getVersion();
+}
+
+/*
+ * Implementation notes: lowerBound
+ * --------------------------------
+ * A difference involving a node that cannot reach or be reached from
+ * a landmark says nothing about the distance, so such terms are
+ * skipped.  Because of those, and because the bound for a node and
+ * itself must be 0, the result is never less than 0.
+ */
+
+double Landmarks::lowerBound(int from, int to) {
+	double bound = 0;
+	for (int i = 0; i < landmarks.size(); i++) {
+		Vector<double> & fromL = fromLandmark[i];
+		Vector<double> & toL = toLandmark[i];
+		if (fromL[to] != UNREACHABLE && fromL[from] != UNREACHABLE) {
+			double d = fromL[to] - fromL[from];
+			if (d > bound) bound = d;
+		}
+		if (toL[from] != UNREACHABLE && toL[to] != UNREACHABLE) {
+			double d = toL[from] - toL[to];
+			if (d > bound) bound = d;
+		}
+	}
+	return bound;
+}
+
+/*
+ * Private method: chooseFarthest
+ * Usage: nodeT *node = chooseFarthest(graph);
+ * -------------------------------------------
+ * Returns the node whose distance from the nearest existing landmark
+ * is largest, or NULL if every node is already a landmark.  A node that
+ * no landmark can reach counts as infinitely far away, which spreads
+ * the landmarks over every part of a graph that is not connected.  The
+ * first landmark is the node farthest from the node with index 0.
+ */
+
+nodeT *Landmarks::chooseFarthest(Graph<nodeT,arcT> & graph) {
+	Vector<double> nearest;
+	if (landmarks.isEmpty()) {
+		SearchFrom(graph, graph.getNodeByIndex(0), false, nearest, NULL, NULL);
+	} else {
+		nearest = fromLandmark[0];
+		for (int i = 1; i < landmarks.size(); i++) {
+			for (int j = 0; j < nearest.size(); j++) {
+				if (fromLandmark[i][j] < nearest[j]) nearest[j] = fromLandmark[i][j];
+			}
+		}
+	}
+	for (int i = 0; i < landmarks.size(); i++) {
+		nearest[landmarks[i]->index] = -1;
+	}
+	int best = -1;
+	for (int j = 0; j < nearest.size(); j++) {
+		if (nearest[j] >= 0 && (best == -1 || nearest[j] > nearest[best])) best = j;
+	}
+	return (best == -1) ? NULL : graph.getNodeByIndex(best);
+}
+
+/*
+ * Private method: chooseAvoid
+ * Usage: nodeT *node = chooseAvoid(graph);
+ * ----------------------------------------
+ * Implements the avoid heuristic.  The method grows a shortest-path
+ * tree from a randomly chosen root r and gives each node v the weight
+ * d(r, v) minus the current lower bound on that distance, which
+ * measures how badly the existing landmarks serve v.  The size of a
+ * node is the total weight of its subtree, or 0 if the subtree already
+ * contains a landmark.  Starting at the root, the method repeatedly
+ * moves to the child of largest size, and the leaf at which it stops
+ * becomes the new landmark.  Only the forward tables are used for the
+ * lower bounds, since the backward tables are not yet available.  The
+ * method returns NULL if every subtree contains a landmark.
+ */
+
+nodeT *Landmarks::chooseAvoid(Graph<nodeT,arcT> & graph) {
+	nodeT *root = graph.getNodeByIndex(RandomInteger(0, graph.size() - 1));
+	Vector<double> dist;
+	Vector<int> parent, order;
+	SearchFrom(graph, root, false, dist, &parent, &order);
+	int n = graph.size();
+	Vector<double> size(n);
+	Vector<bool> hasLandmark(n);
+	Vector<int> bestChild(n);
+	for (int j = 0; j < n; j++) {
+		size.add(0);
+		hasLandmark.add(false);
+		bestChild.add(-1);
+	}
+	for (int i = 0; i < landmarks.size(); i++) {
+		hasLandmark[landmarks[i]->index] = true;
+	}
+	for (int k = order.size() - 1; k >= 0; k--) {
+		int v = order[k];
+		double bound = 0;
+		for (int i = 0; i < landmarks.size(); i++) {
+			double d = fromLandmark[i][v] - fromLandmark[i][root->index];
+			if (fromLandmark[i][v] != UNREACHABLE
+			    && fromLandmark[i][root->index] != UNREACHABLE && d > bound) {
+				bound = d;
+			}
+		}
+		size[v] += dist[v] - bound;
+		int p = parent[v];
+		if (p != -1) {
+			size[p] += size[v];
+			if (hasLandmark[v]) hasLandmark[p] = true;
+		}
+	}
+	for (int k = order.size() - 1; k >= 0; k--) {
+		int v = order[k];
+		if (hasLandmark[v]) size[v] = 0;
+	}
+	for (int k = 1; k < order.size(); k++) {
+		int v = order[k];
+		int p = parent[v];
+		if (size[v] > 0 && (bestChild[p] == -1 || size[v] > size[bestChild[p]])) {
+			bestChild[p] = v;
+		}
+	}
+	int v = root->index;
+	if (size[v] <= 0) return NULL;
+	while (bestChild[v] != -1) {
+		v = bestChild[v];
+	}
+	return graph.getNodeByIndex(v);
+}
+
+void Landmarks::clear() {
+	landmarks.clear();
+	fromLandmark.clear();
+	toLandmark.clear();
+	graphVersion = 0;
+}
+
+/*
+ * Function: SearchFrom
+ * Usage: SearchFrom(graph, root, backward, dist, parent, order);
+ * --------------------------------------------------------------
+ * Runs Dijkstra's algorithm from root and fills in dist with the
+ * distance from root to every node or, if backward is true, from every
+ * node to root, by following the incoming arcs.  If the parent and
+ * order pointers are not NULL, the function also stores the index of
+ * each node's parent in the shortest-path tree, which is -1 for the
+ * root and unreached nodes, and the indices of the reached nodes in
+ * the order in which they were settled.
+ */
+
+static void SearchFrom(Graph<nodeT,arcT> & graph, nodeT *root, bool backward,
+                       Vector<double> & dist, Vector<int> *parent,
+                       Vector<int> *order) {
+	int n = graph.size();
+	dist = Vector<double>(n);
+	for (int j = 0; j < n; j++) {
+		dist.add(UNREACHABLE);
+	}
+	if (parent != NULL) {
+		*parent = Vector<int>(n);
+		for (int j = 0; j < n; j++) {
+			parent->add(-1);
+		}
+	}
+	if (order != NULL) order->clear();
+	double maxArc;
+	DistanceQueue queue;
+	queueKindT kind = ChooseQueueKind(graph, maxArc);
+	queue.setKind(kind, maxArc);
+	dist[root->index] = 0;
+	queue.enqueue(root->index, 0);
+	while (!queue.isEmpty()) {
+		queueEntryT entry = queue.dequeue();
+		if (entry.dist > dist[entry.node]) continue;
+		if (order != NULL) order->add(entry.node);
+		nodeT *node = graph.getNodeByIndex(entry.node);
+		SmallSet<arcT *> & arcs = (backward) ? node->incoming : node->arcs;
+		for (int i = 0; i < arcs.size(); i++) {
+			arcT *arc = arcs[i];
+			int next = ((backward) ? arc->start : arc->finish)->index;
+			double newDist = entry.dist + arc->distance;
+			if (newDist < dist[next]) {
+				dist[next] = newDist;
+				if (parent != NULL) (*parent)[next] = entry.node;
+				queue.enqueue(next, newDist);
+			}
+		}
+	}
+}
+
+/*
+ * Function: ComputeBackwardTables
+ * Usage: RunInParallel(nThreads, ComputeBackwardTables, state);
+ * -------------------------------------------------------------
+ * Computes the backward tables for every landmark whose position in the
+ * list is congruent to thread modulo nThreads.
+ */
+
+static void ComputeBackwardTables(int thread, int nThreads,
+                                  tableStateT & state) {
+	Vector<nodeT *> & landmarks = *state.landmarks;
+	for (int i = thread; i < landmarks.size(); i += nThreads) {
+		SearchFrom(*state.graph, landmarks[i], true, (*state.tables)[i],
+		           NULL, NULL);
+	}
+}
+
+/*
+ * Function: TotalArcDistance
+ * Usage: double total = TotalArcDistance(graph);
+ * ----------------------------------------------
+ * Returns the sum of the arc distances in the graph, which the table
+ * files use to check that they match the graph.
+ */
+
+static double TotalArcDistance(Graph<nodeT,arcT> & graph) {
+	double total = 0;
+	for (int j = 0; j < graph.size(); j++) {
+		nodeT *node = graph.getNodeByIndex(j);
+		for (int i = 0; i < node->arcs.size(); i++) {
+			total += node->arcs[i]->distance;
+		}
+	}
+	return total;
+}
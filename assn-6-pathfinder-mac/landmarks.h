@@ -0,0 +1,183 @@
+/*
+ * File: landmarks.h
+ * -----------------
+ * This file provides the interface to the Landmarks class, which
+ * supports goal-directed search by the ALT method (A*, landmarks, and
+ * the triangle inequality).  A small number of nodes are chosen as
+ * landmarks, and the distances from each landmark to every node and
+ * from every node to each landmark are computed in advance.  For any
+ * landmark L, the triangle inequality implies that
+ *
+ *     d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L)
+ *
+ * so the largest of these differences over all the landmarks is a
+ * lower bound on the remaining distance from v to the target t.  A*
+ * search guided by that bound settles far fewer nodes than Dijkstra's
+ * algorithm, and unlike a bound based on screen coordinates it remains
+ * accurate on maps whose arc distances have nothing to do with the
+ * positions of the nodes.
+ */
+
+#ifndef _landmarks_h
+#define _landmarks_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+
+/*
+ * Type: landmarkSelectionT
+ * ------------------------
+ * This type identifies the strategies for choosing landmarks:
+ *
+ *   FARTHEST_LANDMARKS  Each new landmark is the node farthest from the
+ *                       landmarks already chosen.
+ *   AVOID_LANDMARKS     The avoid heuristic of Goldberg and Werneck,
+ *                       which grows a shortest-path tree from a node
+ *                       far from the existing landmarks and chooses a
+ *                       leaf in the part of the tree where the current
+ *                       lower bounds are weakest.
+ */
+
+enum landmarkSelectionT { FARTHEST_LANDMARKS, AVOID_LANDMARKS };
+
+/*
+ * Constant: DEFAULT_LANDMARK_COUNT
+ * --------------------------------
+ * The number of landmarks used when the client does not specify one.
+ */
+
+const int DEFAULT_LANDMARK_COUNT = 8;
+
+/*
+ * Class: Landmarks
+ * ----------------
+ * This class chooses landmarks for a graph, holds their distance
+ * tables, and computes lower bounds from them.  The tables describe
+ * the graph as it was when they were computed or loaded, and the
+ * isCurrent method reports whether the graph has changed since then.
+ */
+
+class Landmarks {
+public:
+
+/*
+ * Constructor: Landmarks
+ * Usage: Landmarks landmarks;
+ * ---------------------------
+ * Creates an empty set of landmarks, for which every lower bound is 0.
+ */
+	Landmarks();
+
+/*
+ * Destructor: ~Landmarks
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees the storage used by the distance tables.
+ */
+	~Landmarks();
+
+/*
+ * Method: select
+ * Usage: landmarks.select(graph);
+ *        landmarks.select(graph, count, method, nThreads);
+ * --------------------------------------------------------
+ * Chooses count landmarks using the specified strategy and computes
+ * their distance tables.  Choosing the landmarks requires one search
+ * per landmark, which must be done in order; the backward tables are
+ * then computed in parallel on nThreads threads, or one per processor
+ * if nThreads is 0.
+ */
+	void select(Graph<nodeT,arcT> & graph,
+	            int count = DEFAULT_LANDMARK_COUNT,
+	            landmarkSelectionT method = AVOID_LANDMARKS,
+	            int nThreads = 0);
+
+/*
+ * Method: prepare
+ * Usage: landmarks.prepare(graph, mapFile);
+ * -----------------------------------------
+ * Reads the landmark tables stored beside the specified map file, as
+ * named by getTableFileName.  If that file does not exist or does not
+ * match the graph, this method calls select with the default
+ * arguments and writes the new tables to the file, so that the next
+ * program that loads the same map can skip the computation.
+ */
+	void prepare(Graph<nodeT,arcT> & graph, string mapFile);
+
+/*
+ * Methods: load, save
+ * Usage: if (landmarks.load(graph, filename)) . . .
+ *        landmarks.save(graph, filename);
+ * ---------------------------------------------------
+ * These methods read and write the landmark tables for the graph as a
+ * text file.  The load method returns false, leaving the landmarks
+ * unchanged, if the file cannot be opened or describes a different
+ * graph.  The save method requires that the tables be current.
+ */
+	bool load(Graph<nodeT,arcT> & graph, string filename);
+	void save(Graph<nodeT,arcT> & graph, string filename);
+
+/*
+ * Method: getTableFileName
+ * Usage: string filename = Landmarks::getTableFileName(mapFile);
+ * --------------------------------------------------------------
+ * Returns the name of the file used by prepare to hold the landmark
+ * tables for the specified map file.
+ */
+	static string getTableFileName(string mapFile);
+
+/*
+ * Methods: size, getLandmark
+ * Usage: int n = landmarks.size();
+ *        nodeT *node = landmarks.getLandmark(i);
+ * ----------------------------------------------
+ * These methods return the number of landmarks and the landmark with
+ * the specified position in the list.
+ */
+	int size();
+	nodeT *getLandmark(int i);
+
+/*
+ * Method: isCurrent
+ * Usage: if (landmarks.isCurrent(graph)) . . .
+ * --------------------------------------------
+ * Returns true if the tables were computed or loaded for this graph
+ * and the graph has not changed since.  Lower bounds computed from
+ * tables that are not current may be too large.
+ */
+	bool isCurrent(Graph<nodeT,arcT> & graph);
+
+/*
+ * Method: lowerBound
+ * Usage: double bound = landmarks.lowerBound(from, to);
+ * -----------------------------------------------------
+ * Returns a lower bound on the length of the shortest path between the
+ * nodes with the specified indices.
+ */
+	double lowerBound(int from, int to);
+
+private:
+
+/* Instance variables */
+
+	Vector<nodeT *> landmarks;
+	Vector< Vector<double> > fromLandmark;  /* d(L, v) for landmark L */
+	Vector< Vector<double> > toLandmark;    /* d(v, L) for landmark L */
+	long graphVersion;
+
+/* Private methods */
+
+	nodeT *chooseFarthest(Graph<nodeT,arcT> & graph);
+	nodeT *chooseAvoid(Graph<nodeT,arcT> & graph);
+	void clear();
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(Landmarks)
+
+};
+
+#endif
@@ -0,0 +1,295 @@
+/*
+ * File: manytomany.cpp
+ * --------------------
+ * This file implements the manytomany.h interface.
+ */
+
+#include "genlib.h"
+#include "manytomany.h"
+#include "searchspace.h"
+#include "parallel.h"
+
+/*
+ * Type: tableStateT
+ * -----------------
+ * This structure holds the data shared by the threads.  The roots are
+ * the nodes from which the searches start and the goals are the nodes
+ * on the other list; isGoal is indexed by node index and is read but
+ * never written by the threads.  Each search fills in one row of the
+ * table if it runs forward and one column if it runs backward, so no
+ * two threads ever write to the same entry.  The rootGoals vector
+ * gives the number of distinct goals each search can reach, which is
+ * nGoals unless a ComponentIndex rules some of them out.  If the client
+ * asked for statistics, each thread adds the work of its searches to
+ * its own entry in threadStats, which are combined at the end.  The
+ * control is the client's, or NULL, and is shared by all the threads.
+ */
+
+struct tableStateT {
+	Graph<nodeT,arcT> *graph;
+	Vector<nodeT *> *roots;
+	Vector<nodeT *> *goals;
+	bool backward;
+	Vector<bool> isGoal;
+	int nGoals;
+	Vector<int> rootGoals;
+	Grid<double> *table;
+	Grid< Vector<arcT *> > *paths;
+	Vector<searchStatsT> threadStats;
+	SearchControl *control;
+};
+
+/* Prototypes */
+
+static void ComputeTable(Graph<nodeT,arcT> & graph,
+                         Vector<nodeT *> & sources, Vector<nodeT *> & targets,
+                         Grid<double> & table, Grid< Vector<arcT *> > *paths,
+                         int nThreads, ComponentIndex *components,
+                         searchStatsT *stats, SearchControl *control);
+static void CountRootGoals(tableStateT & state, ComponentIndex *components);
+static void SearchFromRoots(int thread, int nThreads, tableStateT & state);
+static long SearchFromRoot(tableStateT & state, nodeT *root, int nGoals,
+                           SearchSpace & space);
+static Vector<arcT *> RecoverPath(tableStateT & state, nodeT *goal,
+                                  SearchSpace & space);
+
+void ManyToManyDistances(Graph<nodeT,arcT> & graph,
+                         Vector<nodeT *> & sources, Vector<nodeT *> & targets,
+                         Grid<double> & table, int nThreads,
+                         ComponentIndex *components, searchStatsT *stats,
+                         SearchControl *control) {
+	ComputeTable(graph, sources, targets, table, NULL, nThreads, components,
+	             stats, control);
+}
+
+void ManyToManyPaths(Graph<nodeT,arcT> & graph,
+                     Vector<nodeT *> & sources, Vector<nodeT *> & targets,
+                     Grid<double> & table, Grid< Vector<arcT *> > & paths,
+                     int nThreads, ComponentIndex *components,
+                     searchStatsT *stats, SearchControl *control) {
+	paths.resize(sources.size(), targets.size());
+	ComputeTable(graph, sources, targets, table, &paths, nThreads, components,
+	             stats, control);
+}
+
+/*
+ * Function: ComputeTable
+ * Usage: ComputeTable(graph, sources, targets, table, paths, nThreads,
+ *                     components, stats, control);
+ * ---------------------------------------------------------------------
+ * Does the work for both of the exported functions.  The goal nodes
+ * are counted without duplicates, because each search stops when it
+ * has settled that many goals.
+ */
+
+static void ComputeTable(Graph<nodeT,arcT> & graph,
+                         Vector<nodeT *> & sources, Vector<nodeT *> & targets,
+                         Grid<double> & table, Grid< Vector<arcT *> > *paths,
+                         int nThreads, ComponentIndex *components,
+                         searchStatsT *stats, SearchControl *control) {
+	double clock = 0;
+	if (stats != NULL) {
+		ClearSearchStats(*stats);
+		clock = SearchClock();
+	}
+	if (nThreads <= 0) nThreads = GetProcessorCount();
+	if (control != NULL) control->begin();
+	table.resize(sources.size(), targets.size());
+	tableStateT state;
+	state.graph = &graph;
+	state.control = control;
+	state.backward = targets.size() < sources.size();
+	state.roots = (state.backward) ? &targets : &sources;
+	state.goals = (state.backward) ? &sources : &targets;
+	state.table = &table;
+	state.paths = paths;
+	state.isGoal = Vector<bool>(graph.size());
+	for (int i = 0; i < graph.size(); i++) {
+		state.isGoal.add(false);
+	}
+	state.nGoals = 0;
+	for (int i = 0; i < state.goals->size(); i++) {
+		int index = (*state.goals)[i]->index;
+		if (!state.isGoal[index]) {
+			state.isGoal[index] = true;
+			state.nGoals++;
+		}
+	}
+	if (state.nGoals == 0) return;
+	CountRootGoals(state, components);
+	if (nThreads > state.roots->size()) nThreads = state.roots->size();
+	if (stats != NULL) {
+		for (int t = 0; t < nThreads; t++) {
+			searchStatsT empty;
+			ClearSearchStats(empty);
+			state.threadStats.add(empty);
+		}
+		double now = SearchClock();
+		stats->setupTime = now - clock;
+		clock = now;
+	}
+	RunInParallel(nThreads, SearchFromRoots, state);
+	if (stats != NULL) {
+		for (int t = 0; t < nThreads; t++) {
+			AddSearchStats(*stats, state.threadStats[t]);
+		}
+		stats->searchTime = SearchClock() - clock;
+	}
+}
+
+/*
+ * Function: CountRootGoals
+ * Usage: CountRootGoals(state, components);
+ * -----------------------------------------
+ * Fills in state.rootGoals.  The component labels are looked up here,
+ * before the threads start, because lookups in a ComponentIndex update
+ * its internal links and so cannot be made from several threads.
+ */
+
+static void CountRootGoals(tableStateT & state, ComponentIndex *components) {
+	Vector<nodeT *> & roots = *state.roots;
+	state.rootGoals = Vector<int>(roots.size());
+	if (components == NULL) {
+		for (int r = 0; r < roots.size(); r++) {
+			state.rootGoals.add(state.nGoals);
+		}
+		return;
+	}
+	Vector<int> goalsIn(state.graph->size());
+	for (int i = 0; i < state.graph->size(); i++) {
+		goalsIn.add(0);
+	}
+	for (int i = 0; i < state.graph->size(); i++) {
+		if (state.isGoal[i]) {
+			goalsIn[components->getComponent(state.graph->getNodeByIndex(i))]++;
+		}
+	}
+	for (int r = 0; r < roots.size(); r++) {
+		state.rootGoals.add(goalsIn[components->getComponent(roots[r])]);
+	}
+}
+
+/*
+ * Function: SearchFromRoots
+ * Usage: RunInParallel(nThreads, SearchFromRoots, state);
+ * -------------------------------------------------------
+ * Runs the searches for every root whose position in the list is
+ * congruent to thread modulo nThreads, reusing a single SearchSpace.
+ * A root whose component contains no goals is skipped, leaving its
+ * entries UNREACHABLE and its paths empty, and so is every root that
+ * comes up after the control has stopped a search.  The threadStats
+ * vector is empty unless the client asked for statistics.
+ */
+
+static void SearchFromRoots(int thread, int nThreads, tableStateT & state) {
+	SearchSpace space;
+	Vector<nodeT *> & roots = *state.roots;
+	Vector<nodeT *> & goals = *state.goals;
+	for (int r = thread; r < roots.size(); r += nThreads) {
+		bool searched = state.rootGoals[r] > 0;
+		if (state.control != NULL && state.control->isStopped()) {
+			searched = false;
+		}
+		if (searched) {
+			long relaxed = SearchFromRoot(state, roots[r], state.rootGoals[r],
+			                              space);
+			if (!state.threadStats.isEmpty()) {
+				searchStatsT rootStats;
+				ClearSearchStats(rootStats);
+				space.fillStats(rootStats);
+				rootStats.relaxed = relaxed;
+				AddSearchStats(state.threadStats[thread], rootStats);
+			}
+		}
+		for (int g = 0; g < goals.size(); g++) {
+			int index = goals[g]->index;
+			double dist = (searched && space.isSettled(index))
+			            ? space.getDistance(index) : UNREACHABLE;
+			int row = (state.backward) ? g : r;
+			int col = (state.backward) ? r : g;
+			state.table->setAt(row, col, dist);
+			if (state.paths != NULL) {
+				Vector<arcT *> path;
+				if (searched) path = RecoverPath(state, goals[g], space);
+				state.paths->setAt(row, col, path);
+			}
+		}
+	}
+}
+
+/*
+ * Function: SearchFromRoot
+ * Usage: long relaxed = SearchFromRoot(state, root, nGoals, space);
+ * -----------------------------------------------------------------
+ * Runs Dijkstra's algorithm from root, stopping when nGoals goals have
+ * been settled, and returns the number of arcs it relaxed.  A backward
+ * search follows the incoming arcs of each node, so the distance it
+ * computes for a node is the distance from that node to the root.  In
+ * either direction, the parent arc of a node is the arc by which the
+ * search reached it.
+ */
+
+static long SearchFromRoot(tableStateT & state, nodeT *root, int nGoals,
+                           SearchSpace & space) {
+	space.reset(*state.graph);
+	DistanceQueue & queue = space.getQueue();
+	space.setDistance(root->index, 0, NULL);
+	queue.enqueue(root->index, 0);
+	int goalsLeft = nGoals;
+	long relaxed = 0;
+	while (!queue.isEmpty()) {
+		queueEntryT entry = queue.dequeue();
+		if (space.isSettled(entry.node)) continue;
+		space.settle(entry.node);
+		if (state.isGoal[entry.node] && --goalsLeft == 0) break;
+		if (state.control != NULL
+		    && space.getSettledCount() % SEARCH_CHECK_INTERVAL == 0
+		    && state.control->check(0)) break;
+		nodeT *node = state.graph->getNodeByIndex(entry.node);
+		SmallSet<arcT *> & arcs = (state.backward) ? node->incoming : node->arcs;
+		relaxed += arcs.size();
+		for (int i = 0; i < arcs.size(); i++) {
+			arcT *arc = arcs[i];
+			nodeT *next = (state.backward) ? arc->start : arc->finish;
+			double newDist = entry.dist + arc->distance;
+			if (newDist < space.getDistance(next->index)) {
+				space.setDistance(next->index, newDist, arc);
+				queue.enqueue(next->index, newDist);
+			}
+		}
+	}
+	return relaxed;
+}
+
+/*
+ * Function: RecoverPath
+ * Usage: Vector<arcT *> path = RecoverPath(state, goal, space);
+ * -------------------------------------------------------------
+ * Returns the arcs of the path found between the root and goal, in
+ * order from the source to the target.  After a forward search, the
+ * parent arcs lead from the goal back to the root, so the path is
+ * reversed.  After a backward search, they lead from the goal, which
+ * is the source, forward to the root.
+ */
+
+static Vector<arcT *> RecoverPath(tableStateT & state, nodeT *goal,
+                                  SearchSpace & space) {
+	Vector<arcT *> path;
+	if (!space.isSettled(goal->index)) return path;
+	if (state.backward) {
+		for (arcT *arc = space.getParentArc(goal->index); arc != NULL;
+		     arc = space.getParentArc(arc->finish->index)) {
+			path.add(arc);
+		}
+	} else {
+		Vector<arcT *> reversed;
+		for (arcT *arc = space.getParentArc(goal->index); arc != NULL;
+		     arc = space.getParentArc(arc->start->index)) {
+			reversed.add(arc);
+		}
+		for (int i = reversed.size() - 1; i >= 0; i--) {
+			path.add(reversed[i]);
+		}
+	}
+	return path;
+}
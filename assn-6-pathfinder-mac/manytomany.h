@@ -0,0 +1,98 @@
+/*
+ * File: manytomany.h
+ * ------------------
+ * This interface exports functions that compute a table of shortest
+ * path distances between every node in a list of sources and every
+ * node in a list of targets, which is the form in which distances are
+ * needed for problems such as assigning customers to depots.  Instead
+ * of running a separate search for each of the N x M pairs, these
+ * functions run one search for each node on the shorter of the two
+ * lists and stop each search as soon as it has settled every node on
+ * the other list.  The searches are independent, so they are divided
+ * among several threads.
+ */
+
+#ifndef _manytomany_h
+#define _manytomany_h
+
+#include "genlib.h"
+#include "vector.h"
+#include "grid.h"
+#include "graph.h"
+#include "graphtypes.h"
+#include "components.h"
+#include "searchstats.h"
+#include "searchcontrol.h"
+
+/*
+ * Function: ManyToManyDistances
+ * Usage: ManyToManyDistances(graph, sources, targets, table);
+ *        ManyToManyDistances(graph, sources, targets, table, nThreads);
+ *        ManyToManyDistances(graph, sources, targets, table, nThreads,
+ *                            components);
+ *        ManyToManyDistances(graph, sources, targets, table, nThreads,
+ *                            components, &stats);
+ *        ManyToManyDistances(graph, sources, targets, table, nThreads,
+ *                            components, &stats, &control);
+ * ---------------------------------------------------------------------
+ * Fills in table so that table[i][j] is the length of the shortest
+ * path from sources[i] to targets[j], or UNREACHABLE if there is no
+ * such path.  The table is resized to have one row for each source
+ * and one column for each target.  If there are fewer targets than
+ * sources, the searches start at the targets and follow the arcs
+ * backward.  If nThreads is omitted or is 0, the function uses one
+ * thread per processor.
+ *
+ * If the client supplies a ComponentIndex for the graph, each search
+ * stops when it has settled the goals in its own component, instead of
+ * exploring that whole component in search of goals it cannot reach,
+ * and a search whose component contains no goals is never run.
+ *
+ * If the client supplies a searchStatsT record, it receives the total
+ * work of all the searches, as described in searchstats.h.  The search
+ * time is the elapsed time of the threads, including the time spent
+ * filling in the table.
+ *
+ * If the client supplies a SearchControl, as described in
+ * searchcontrol.h, every thread checks it during its searches and no
+ * thread starts another search once it has stopped one.  Every entry
+ * of the table that is not UNREACHABLE is then still exact, but an
+ * entry may be UNREACHABLE only because its search did not finish.
+ * Since some searches may not have started at all, the bound reported
+ * by the control is 0.
+ */
+
+void ManyToManyDistances(Graph<nodeT,arcT> & graph,
+                         Vector<nodeT *> & sources, Vector<nodeT *> & targets,
+                         Grid<double> & table, int nThreads = 0,
+                         ComponentIndex *components = NULL,
+                         searchStatsT *stats = NULL,
+                         SearchControl *control = NULL);
+
+/*
+ * Function: ManyToManyPaths
+ * Usage: ManyToManyPaths(graph, sources, targets, table, paths);
+ *        ManyToManyPaths(graph, sources, targets, table, paths, nThreads);
+ *        ManyToManyPaths(graph, sources, targets, table, paths, nThreads,
+ *                        components);
+ *        ManyToManyPaths(graph, sources, targets, table, paths, nThreads,
+ *                        components, &stats);
+ *        ManyToManyPaths(graph, sources, targets, table, paths, nThreads,
+ *                        components, &stats, &control);
+ * ------------------------------------------------------------------------
+ * Computes the same table as ManyToManyDistances and also fills in
+ * paths so that paths[i][j] holds the arcs of a shortest path from
+ * sources[i] to targets[j] in order.  That vector is empty if the two
+ * nodes are the same or no path exists.  Storing every path takes
+ * space proportional to the total length of the paths, so clients
+ * that need only a few paths should use Path for those instead.
+ */
+
+void ManyToManyPaths(Graph<nodeT,arcT> & graph,
+                     Vector<nodeT *> & sources, Vector<nodeT *> & targets,
+                     Grid<double> & table, Grid< Vector<arcT *> > & paths,
+                     int nThreads = 0, ComponentIndex *components = NULL,
+                     searchStatsT *stats = NULL,
+                     SearchControl *control = NULL);
+
+#endif
@@ -0,0 +1,643 @@
+/*
+ * File: mapgen.cpp
+ * ----------------
+ * This file implements the mapgen.h interface.
+ */
+
+#include <cmath>
+#include <climits>
+#include <fstream>
+#include "genlib.h"
+#include "allocstats.h"
+#include "mapgen.h"
+#include "parallel.h"
+#include "random.h"
+#include "strutils.h"
+
+/*
+ * Constants
+ * ---------
+ * NODE_SPACING is the distance between neighboring grid intersections,
+ * and the generated nodes are spread out so that each covers about that
+ * much space.  CHUNK_SIZE is the number of nodes generated from each
+ * random stream, which fixes how the map depends on the seed.  The
+ * remaining constants control the shapes described in mapgen.h; the
+ * cost of each road is its length times a random detour factor between
+ * 1 and MAX_DETOUR, and on highway maps times LOCAL_COST divided by
+ * HIGHWAY_SPEEDUP once for each level of highway.
+ */
+
+const int NODE_SPACING = 10;
+const int CHUNK_SIZE = 16384;
+const double MAX_DETOUR = 1.3;
+const double MISSING_BLOCK_CHANCE = 0.1;
+const double DIAGONAL_CHANCE = 0.05;
+const int GEOMETRIC_NEIGHBORS = 3;
+const int HIGHWAY_SPACING = 8;
+const double LOCAL_COST = 4;
+const double HIGHWAY_SPEEDUP = 2;
+const char BINARY_MAGIC[8] = { 'P', 'F', 'R', 'O', 'A', 'D', 'S', '1' };
+
+/*
+ * Type: streamT
+ * -------------
+ * The functions in random.h share a single generator, which cannot be
+ * used from several threads and whose sequence would depend on how the
+ * work was divided among them.  Each chunk of the map therefore draws
+ * its numbers from a stream of its own, which is a 32-bit xorshift
+ * generator seeded from random.h by the calling thread.
+ */
+
+struct streamT {
+	unsigned long state;
+};
+
+/*
+ * Type: genStateT
+ * ---------------
+ * This structure holds the data shared by the threads that generate a
+ * map.  Each chunk has two seeds, one for placing its nodes and one for
+ * building their roads, and collects its roads in its own vector so
+ * that the threads never write to the same storage.  On a geometric
+ * map, the nodes in cell c of a grid that covers the map are numbered
+ * from cellStart[c] up to cellStart[c + 1], and neighbors holds
+ * GEOMETRIC_NEIGHBORS entries for each node, with -1 for a missing
+ * neighbor.
+ */
+
+struct genStateT {
+	roadMapT *map;
+	roadShapeT shape;
+	int nNodes;
+	int width;
+	int nChunks;
+	Vector<unsigned long> seeds;
+	Vector< Vector<roadT> > chunkRoads;
+	int nCells;
+	Vector<int> cellStart;
+	Vector<int> neighbors;
+};
+
+/*
+ * Type: textStateT
+ * ----------------
+ * This structure holds the data shared by the threads that format the
+ * lines of a text map.  Chunk c of the output holds the lines for the
+ * nodes or roads with indices from c * CHUNK_SIZE up to the next chunk.
+ */
+
+struct textStateT {
+	roadMapT *map;
+	int nNodeChunks;
+	Vector<string> chunks;
+};
+
+/* Prototypes */
+
+static void PlaceNodes(int thread, int nThreads, genStateT & state);
+static void FindNeighbors(int thread, int nThreads, genStateT & state);
+static void BuildRoads(int thread, int nThreads, genStateT & state);
+static void BuildGridRoads(genStateT & state, int i, streamT & stream,
+                           Vector<roadT> & roads);
+static void BuildGeometricRoads(genStateT & state, int i, streamT & stream,
+                                Vector<roadT> & roads);
+static void BucketNodes(genStateT & state);
+static int CellOf(genStateT & state, pointT loc);
+static void AddRoad(genStateT & state, int start, int finish, double cost,
+                    streamT & stream, Vector<roadT> & roads);
+static bool IsNeighbor(genStateT & state, int i, int j);
+static void AddRoadArc(Graph<nodeT,arcT> & graph, nodeT *start, nodeT *finish,
+                       double distance);
+static void FormatLines(int thread, int nThreads, textStateT & state);
+static unsigned long NextRandom(streamT & stream);
+static double StreamReal(streamT & stream, double low, double high);
+static int StreamInteger(streamT & stream, int low, int high);
+static bool StreamChance(streamT & stream, double p);
+
+/*
+ * Implementation notes: GenerateRoads
+ * -----------------------------------
+ * The map is built in phases, each of which divides the chunks among
+ * the threads: the nodes are placed, the nearest neighbors of each node
+ * are found on a geometric map, and the roads of each chunk are built.
+ * All the seeds are drawn before the first phase, and the roads of the
+ * chunks are joined in order at the end, so neither the number of
+ * threads nor the order in which they run can change the result.
+ */
+
+void GenerateRoads(roadMapT & map, roadShapeT shape, int nNodes,
+                   int nThreads) {
+	if (nNodes < 0) Error("GenerateRoads: Number of nodes must not be negative");
+	if (nThreads <= 0) nThreads = GetProcessorCount();
+	genStateT state;
+	state.map = &map;
+	state.shape = shape;
+	state.nNodes = nNodes;
+	state.width = int(ceil(sqrt(double(nNodes))));
+	state.nChunks = (nNodes + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	for (int i = 0; i < 2 * state.nChunks; i++) {
+		state.seeds.add(RandomInteger(1, INT_MAX));
+	}
+	map.locs = Vector<pointT>(nNodes);
+	pointT origin = { 0, 0 };
+	for (int i = 0; i < nNodes; i++) {
+		map.locs.add(origin);
+	}
+	for (int c = 0; c < state.nChunks; c++) {
+		state.chunkRoads.add(Vector<roadT>());
+	}
+	if (nThreads > state.nChunks) nThreads = state.nChunks;
+	RunInParallel(nThreads, PlaceNodes, state);
+	if (shape == GEOMETRIC_ROADS) {
+		BucketNodes(state);
+		for (int i = 0; i < nNodes * GEOMETRIC_NEIGHBORS; i++) {
+			state.neighbors.add(-1);
+		}
+		RunInParallel(nThreads, FindNeighbors, state);
+	}
+	RunInParallel(nThreads, BuildRoads, state);
+	int nRoads = 0;
+	for (int c = 0; c < state.nChunks; c++) {
+		nRoads += state.chunkRoads[c].size();
+	}
+	map.roads = Vector<roadT>(nRoads);
+	for (int c = 0; c < state.nChunks; c++) {
+		Vector<roadT> & roads = state.chunkRoads[c];
+		for (int i = 0; i < roads.size(); i++) {
+			map.roads.add(roads[i]);
+		}
+		roads.clear();
+	}
+}
+
+/*
+ * Implementation notes: BuildGraph
+ * --------------------------------
+ * Each node and arc is filled in before it is passed to the graph, as
+ * NewNode and NewArcs in pathfinder.cpp do, so that the listeners of
+ * the graph see the location of every node and the distance of every
+ * arc.  The records are charged to the graph's allocation counts, as
+ * allocstats.h asks of clients that allocate their own.
+ */
+
+void BuildGraph(roadMapT & map, Graph<nodeT,arcT> & graph) {
+	graph.clear();
+	for (int i = 0; i < map.locs.size(); i++) {
+		nodeT *node = new nodeT;
+		AllocStatsNoteAlloc(ALLOC_GRAPH, ALLOC_CELL, sizeof(nodeT));
+		node->name = "n" + IntegerToString(i);
+		node->loc = map.locs[i];
+		graph.addNode(node);
+	}
+	for (int i = 0; i < map.roads.size(); i++) {
+		nodeT *n1 = graph.getNodeByIndex(map.roads[i].start);
+		nodeT *n2 = graph.getNodeByIndex(map.roads[i].finish);
+		AddRoadArc(graph, n1, n2, map.roads[i].distance);
+		AddRoadArc(graph, n2, n1, map.roads[i].distance);
+	}
+}
+
+void WriteTextMap(roadMapT & map, string filename, string imageName,
+                  int nThreads) {
+	if (nThreads <= 0) nThreads = GetProcessorCount();
+	ofstream outfile(filename.c_str());
+	if (outfile.fail()) Error("WriteTextMap: Can't open " + filename);
+	textStateT state;
+	state.map = &map;
+	state.nNodeChunks = (map.locs.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	int nChunks = state.nNodeChunks
+	            + (map.roads.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	for (int c = 0; c < nChunks; c++) {
+		state.chunks.add("");
+	}
+	if (nThreads > nChunks) nThreads = nChunks;
+	if (nThreads > 0) RunInParallel(nThreads, FormatLines, state);
+	outfile << imageName << endl << "NODES" << endl;
+	for (int c = 0; c < nChunks; c++) {
+		if (c == state.nNodeChunks) outfile << "ARCS" << endl;
+		outfile << state.chunks[c];
+	}
+	if (nChunks == state.nNodeChunks) outfile << "ARCS" << endl;
+	if (outfile.fail()) Error("WriteTextMap: Error writing " + filename);
+}
+
+/*
+ * Implementation notes: WriteBinaryMap, ReadBinaryMap
+ * ---------------------------------------------------
+ * The file begins with eight identifying bytes followed by the numbers
+ * of nodes and roads.  The coordinates of the nodes come next, and then
+ * the endpoints and distance of each road.  ReadBinaryMap checks the
+ * counts against the size of the file before it allocates anything,
+ * so that a damaged file is rejected instead of exhausting memory.
+ */
+
+void WriteBinaryMap(roadMapT & map, string filename) {
+	ofstream outfile(filename.c_str(), ios::binary);
+	if (outfile.fail()) Error("WriteBinaryMap: Can't open " + filename);
+	int nNodes = map.locs.size();
+	int nRoads = map.roads.size();
+	outfile.write(BINARY_MAGIC, sizeof BINARY_MAGIC);
+	outfile.write((char *) &nNodes, sizeof nNodes);
+	outfile.write((char *) &nRoads, sizeof nRoads);
+	for (int i = 0; i < nNodes; i++) {
+		outfile.write((char *) &map.locs[i].x, sizeof map.locs[i].x);
+		outfile.write((char *) &map.locs[i].y, sizeof map.locs[i].y);
+	}
+	for (int i = 0; i < nRoads; i++) {
+		roadT & road = map.roads[i];
+		outfile.write((char *) &road.start, sizeof road.start);
+		outfile.write((char *) &road.finish, sizeof road.finish);
+		outfile.write((char *) &road.distance, sizeof road.distance);
+	}
+	if (outfile.fail()) Error("WriteBinaryMap: Error writing " + filename);
+}
+
+bool ReadBinaryMap(roadMapT & map, string filename) {
+	ifstream infile(filename.c_str(), ios::binary);
+	if (infile.fail()) return false;
+	char magic[sizeof BINARY_MAGIC];
+	int nNodes, nRoads;
+	infile.read(magic, sizeof magic);
+	infile.read((char *) &nNodes, sizeof nNodes);
+	infile.read((char *) &nRoads, sizeof nRoads);
+	if (infile.fail() || nNodes < 0 || nRoads < 0) return false;
+	for (int i = 0; i < int(sizeof magic); i++) {
+		if (magic[i] != BINARY_MAGIC[i]) return false;
+	}
+	pointT loc;
+	roadT road;
+	long nodeBytes = sizeof loc.x + sizeof loc.y;
+	long roadBytes = sizeof road.start + sizeof road.finish
+	               + sizeof road.distance;
+	long start = infile.tellg();
+	infile.seekg(0, ios::end);
+	long remaining = long(infile.tellg()) - start;
+	infile.seekg(start);
+	if (infile.fail() || nNodes > remaining / nodeBytes
+	    || nRoads > (remaining - nNodes * nodeBytes) / roadBytes) {
+		return false;
+	}
+	roadMapT result;
+	result.locs = Vector<pointT>(nNodes);
+	result.roads = Vector<roadT>(nRoads);
+	for (int i = 0; i < nNodes; i++) {
+		infile.read((char *) &loc.x, sizeof loc.x);
+		infile.read((char *) &loc.y, sizeof loc.y);
+		result.locs.add(loc);
+	}
+	for (int i = 0; i < nRoads; i++) {
+		infile.read((char *) &road.start, sizeof road.start);
+		infile.read((char *) &road.finish, sizeof road.finish);
+		infile.read((char *) &road.distance, sizeof road.distance);
+		if (road.start < 0 || road.start >= nNodes
+		    || road.finish < 0 || road.finish >= nNodes) return false;
+		result.roads.add(road);
+	}
+	if (infile.fail()) return false;
+	map.locs.swap(result.locs);
+	map.roads.swap(result.roads);
+	return true;
+}
+
+/*
+ * Function: PlaceNodes
+ * Usage: RunInParallel(nThreads, PlaceNodes, state);
+ * --------------------------------------------------
+ * Chooses the locations of the nodes in every chunk whose number is
+ * congruent to thread modulo nThreads.  On the grid shapes, node i sits
+ * near the intersection in row i / width and column i % width; on a
+ * geometric map, the nodes are spread uniformly over a square of the
+ * same size.
+ */
+
+static void PlaceNodes(int thread, int nThreads, genStateT & state) {
+	int side = state.width * NODE_SPACING;
+	for (int c = thread; c < state.nChunks; c += nThreads) {
+		streamT stream;
+		stream.state = state.seeds[2 * c];
+		int end = (c + 1) * CHUNK_SIZE;
+		if (end > state.nNodes) end = state.nNodes;
+		for (int i = c * CHUNK_SIZE; i < end; i++) {
+			pointT & loc = state.map->locs[i];
+			if (state.shape == GEOMETRIC_ROADS) {
+				loc.x = StreamInteger(stream, 0, side - 1);
+				loc.y = StreamInteger(stream, 0, side - 1);
+			} else {
+				loc.x = (i % state.width) * NODE_SPACING
+				      + StreamInteger(stream, 0, NODE_SPACING / 2);
+				loc.y = (i / state.width) * NODE_SPACING
+				      + StreamInteger(stream, 0, NODE_SPACING / 2);
+			}
+		}
+	}
+}
+
+/*
+ * Function: FindNeighbors
+ * Usage: RunInParallel(nThreads, FindNeighbors, state);
+ * -----------------------------------------------------
+ * Finds the GEOMETRIC_NEIGHBORS nodes nearest to each node in the
+ * chunks assigned to this thread.  As in SpatialIndex, the search looks
+ * at rings of cells around the node's own cell and stops once the
+ * neighbors it has found are closer than any node in the next ring.
+ * Ties are broken by index, so the result does not depend on the order
+ * in which the cells are examined.
+ */
+
+static void FindNeighbors(int thread, int nThreads, genStateT & state) {
+	const int k = GEOMETRIC_NEIGHBORS;
+	for (int c = thread; c < state.nChunks; c += nThreads) {
+		int end = (c + 1) * CHUNK_SIZE;
+		if (end > state.nNodes) end = state.nNodes;
+		for (int i = c * CHUNK_SIZE; i < end; i++) {
+			pointT loc = state.map->locs[i];
+			int best[GEOMETRIC_NEIGHBORS];
+			double bestDist[GEOMETRIC_NEIGHBORS];
+			int nFound = 0;
+			int cell = CellOf(state, loc);
+			int row = cell / state.nCells;
+			int col = cell % state.nCells;
+			for (int radius = 0; radius < state.nCells; radius++) {
+				for (int r = row - radius; r <= row + radius; r++) {
+					if (r < 0 || r >= state.nCells) continue;
+					bool edgeRow = (r == row - radius || r == row + radius);
+					int step = (edgeRow || radius == 0) ? 1 : 2 * radius;
+					for (int cc = col - radius; cc <= col + radius; cc += step) {
+						if (cc < 0 || cc >= state.nCells) continue;
+						int index = r * state.nCells + cc;
+						for (int j = state.cellStart[index];
+						     j < state.cellStart[index + 1]; j++) {
+							if (j == i) continue;
+							double dx = state.map->locs[j].x - loc.x;
+							double dy = state.map->locs[j].y - loc.y;
+							double d = dx * dx + dy * dy;
+							int pos = nFound;
+							while (pos > 0 && (bestDist[pos - 1] > d
+							       || (bestDist[pos - 1] == d && best[pos - 1] > j))) {
+								pos--;
+							}
+							if (pos == k) continue;
+							if (nFound < k) nFound++;
+							for (int q = nFound - 1; q > pos; q--) {
+								best[q] = best[q - 1];
+								bestDist[q] = bestDist[q - 1];
+							}
+							best[pos] = j;
+							bestDist[pos] = d;
+						}
+					}
+				}
+				double bound = double(radius) * NODE_SPACING;
+				if (nFound == k && bestDist[k - 1] < bound * bound) break;
+			}
+			for (int q = 0; q < nFound; q++) {
+				state.neighbors[i * k + q] = best[q];
+			}
+		}
+	}
+}
+
+/*
+ * Function: BuildRoads
+ * Usage: RunInParallel(nThreads, BuildRoads, state);
+ * --------------------------------------------------
+ * Builds the roads that start at the nodes in the chunks assigned to
+ * this thread, storing them in the vector for each chunk.
+ */
+
+static void BuildRoads(int thread, int nThreads, genStateT & state) {
+	for (int c = thread; c < state.nChunks; c += nThreads) {
+		streamT stream;
+		stream.state = state.seeds[2 * c + 1];
+		Vector<roadT> & roads = state.chunkRoads[c];
+		int end = (c + 1) * CHUNK_SIZE;
+		if (end > state.nNodes) end = state.nNodes;
+		for (int i = c * CHUNK_SIZE; i < end; i++) {
+			if (state.shape == GEOMETRIC_ROADS) {
+				BuildGeometricRoads(state, i, stream, roads);
+			} else {
+				BuildGridRoads(state, i, stream, roads);
+			}
+		}
+	}
+}
+
+/*
+ * Function: BuildGridRoads
+ * Usage: BuildGridRoads(state, i, stream, roads);
+ * -----------------------------------------------
+ * Adds the streets that lead from node i to the intersections to its
+ * right and below it, and to its lower right if there is a diagonal.
+ * On a highway map, a node whose row and column are both multiples of
+ * HIGHWAY_SPACING also gets highways to the next such nodes to the
+ * right and below, and the same holds for each higher level.
+ */
+
+static void BuildGridRoads(genStateT & state, int i, streamT & stream,
+                           Vector<roadT> & roads) {
+	int n = state.nNodes;
+	int width = state.width;
+	int row = i / width;
+	int col = i % width;
+	double cost = (state.shape == HIGHWAY_ROADS) ? LOCAL_COST : 1;
+	bool right = col + 1 < width && i + 1 < n;
+	bool down = i + width < n;
+	if (right && !StreamChance(stream, MISSING_BLOCK_CHANCE)) {
+		AddRoad(state, i, i + 1, cost, stream, roads);
+	}
+	if (down && !StreamChance(stream, MISSING_BLOCK_CHANCE)) {
+		AddRoad(state, i, i + width, cost, stream, roads);
+	}
+	if (right && i + width + 1 < n && StreamChance(stream, DIAGONAL_CHANCE)) {
+		AddRoad(state, i, i + width + 1, cost, stream, roads);
+	}
+	if (state.shape != HIGHWAY_ROADS) return;
+	for (int span = HIGHWAY_SPACING; span < width; span *= HIGHWAY_SPACING) {
+		if (row % span != 0 || col % span != 0) break;
+		cost /= HIGHWAY_SPEEDUP;
+		if (col + span < width && i + span < n) {
+			AddRoad(state, i, i + span, cost, stream, roads);
+		}
+		if (i + span * width < n) {
+			AddRoad(state, i, i + span * width, cost, stream, roads);
+		}
+	}
+}
+
+/*
+ * Function: BuildGeometricRoads
+ * Usage: BuildGeometricRoads(state, i, stream, roads);
+ * ----------------------------------------------------
+ * Adds a road from node i to each of its nearest neighbors.  A road
+ * between two nodes that are each among the other's neighbors is added
+ * only by the node with the smaller index.
+ */
+
+static void BuildGeometricRoads(genStateT & state, int i, streamT & stream,
+                                Vector<roadT> & roads) {
+	for (int q = 0; q < GEOMETRIC_NEIGHBORS; q++) {
+		int j = state.neighbors[i * GEOMETRIC_NEIGHBORS + q];
+		if (j == -1) break;
+		if (i < j || !IsNeighbor(state, j, i)) {
+			AddRoad(state, i, j, 1, stream, roads);
+		}
+	}
+}
+
+/*
+ * Function: BucketNodes
+ * Usage: BucketNodes(state);
+ * --------------------------
+ * Sorts the nodes of a geometric map into square cells of width
+ * NODE_SPACING, which hold one node each on average, and renumbers them
+ * in order of their cells, so that the nodes in cell c are numbered
+ * from cellStart[c] up to cellStart[c + 1].  Without the renumbering,
+ * nodes with nearby numbers would lie far apart, and on large maps the
+ * neighbor search would spend most of its time waiting for memory.
+ */
+
+static void BucketNodes(genStateT & state) {
+	state.nCells = (state.width > 0) ? state.width : 1;
+	int nCells = state.nCells * state.nCells;
+	state.cellStart = Vector<int>(nCells + 1);
+	for (int c = 0; c <= nCells; c++) {
+		state.cellStart.add(0);
+	}
+	for (int i = 0; i < state.nNodes; i++) {
+		state.cellStart[CellOf(state, state.map->locs[i]) + 1]++;
+	}
+	for (int c = 0; c < nCells; c++) {
+		state.cellStart[c + 1] += state.cellStart[c];
+	}
+	Vector<int> next(nCells);
+	for (int c = 0; c < nCells; c++) {
+		next.add(state.cellStart[c]);
+	}
+	Vector<pointT> locs = state.map->locs;
+	for (int i = 0; i < state.nNodes; i++) {
+		state.map->locs[next[CellOf(state, locs[i])]++] = locs[i];
+	}
+}
+
+static int CellOf(genStateT & state, pointT loc) {
+	int row = loc.y / NODE_SPACING;
+	int col = loc.x / NODE_SPACING;
+	if (row >= state.nCells) row = state.nCells - 1;
+	if (col >= state.nCells) col = state.nCells - 1;
+	return row * state.nCells + col;
+}
+
+/*
+ * Function: AddRoad
+ * Usage: AddRoad(state, start, finish, cost, stream, roads);
+ * ----------------------------------------------------------
+ * Adds a road whose distance is the straight-line distance between its
+ * endpoints times cost and a random detour factor, rounded to a whole
+ * number that is at least 1.
+ */
+
+static void AddRoad(genStateT & state, int start, int finish, double cost,
+                    streamT & stream, Vector<roadT> & roads) {
+	pointT p1 = state.map->locs[start];
+	pointT p2 = state.map->locs[finish];
+	double dx = p1.x - p2.x;
+	double dy = p1.y - p2.y;
+	double length = sqrt(dx * dx + dy * dy) * cost
+	              * StreamReal(stream, 1, MAX_DETOUR);
+	roadT road;
+	road.start = start;
+	road.finish = finish;
+	road.distance = floor(length + 0.5);
+	if (road.distance < 1) road.distance = 1;
+	roads.add(road);
+}
+
+static bool IsNeighbor(genStateT & state, int i, int j) {
+	for (int q = 0; q < GEOMETRIC_NEIGHBORS; q++) {
+		if (state.neighbors[i * GEOMETRIC_NEIGHBORS + q] == j) return true;
+	}
+	return false;
+}
+
+/*
+ * Function: AddRoadArc
+ * Usage: AddRoadArc(graph, start, finish, distance);
+ * --------------------------------------------------
+ * Creates an arc with the specified endpoints and distance and adds it
+ * to the graph.
+ */
+
+static void AddRoadArc(Graph<nodeT,arcT> & graph, nodeT *start, nodeT *finish,
+                       double distance) {
+	arcT *arc = new arcT;
+	AllocStatsNoteAlloc(ALLOC_GRAPH, ALLOC_CELL, sizeof(arcT));
+	arc->start = start;
+	arc->finish = finish;
+	arc->distance = distance;
+	graph.addArc(arc);
+}
+
+/*
+ * Function: FormatLines
+ * Usage: RunInParallel(nThreads, FormatLines, state);
+ * ---------------------------------------------------
+ * Formats the lines of the text map for the chunks assigned to this
+ * thread.  The node chunks come first, followed by the road chunks.
+ */
+
+static void FormatLines(int thread, int nThreads, textStateT & state) {
+	roadMapT & map = *state.map;
+	for (int c = thread; c < state.chunks.size(); c += nThreads) {
+		string text;
+		if (c < state.nNodeChunks) {
+			int end = (c + 1) * CHUNK_SIZE;
+			if (end > map.locs.size()) end = map.locs.size();
+			for (int i = c * CHUNK_SIZE; i < end; i++) {
+				text += "n" + IntegerToString(i) + " "
+				      + IntegerToString(map.locs[i].x) + " "
+				      + IntegerToString(map.locs[i].y) + "\n";
+			}
+		} else {
+			int first = (c - state.nNodeChunks) * CHUNK_SIZE;
+			int end = first + CHUNK_SIZE;
+			if (end > map.roads.size()) end = map.roads.size();
+			for (int i = first; i < end; i++) {
+				roadT & road = map.roads[i];
+				text += "n" + IntegerToString(road.start) + " n"
+				      + IntegerToString(road.finish) + " "
+				      + IntegerToString(int(road.distance)) + "\n";
+			}
+		}
+		state.chunks[c] = text;
+	}
+}
+
+/*
+ * Functions: NextRandom, StreamReal, StreamInteger, StreamChance
+ * --------------------------------------------------------------
+ * These functions draw from a stream in the same way as the functions
+ * of the same names in random.h.  NextRandom returns a number between
+ * 1 and 2^32 - 1, and the others scale it to the requested range.
+ */
+
+static unsigned long NextRandom(streamT & stream) {
+	unsigned long x = stream.state;
+	x ^= (x << 13) & 0xffffffffUL;
+	x ^= x >> 17;
+	x ^= (x << 5) & 0xffffffffUL;
+	stream.state = x;
+	return x;
+}
+
+static double StreamReal(streamT & stream, double low, double high) {
+	return low + (high - low) * (NextRandom(stream) / 4294967296.0);
+}
+
+static int StreamInteger(streamT & stream, int low, int high) {
+	int k = low + int(StreamReal(stream, 0, high - low + 1.0));
+	return (k > high) ? high : k;
+}
+
+static bool StreamChance(streamT & stream, double p) {
+	return StreamReal(stream, 0, 1) < p;
+}
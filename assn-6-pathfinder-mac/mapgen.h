@@ -0,0 +1,129 @@
+/*
+ * File: mapgen.h
+ * --------------
+ * This interface exports functions that generate synthetic road maps
+ * for testing how the Pathfinder algorithms scale.  The maps that come
+ * with the assignment have at most a few hundred nodes, which is far
+ * too few to show the asymptotic behavior of the search engines, so
+ * these functions build maps with anywhere from a thousand to ten
+ * million nodes whose structure resembles that of real road networks.
+ *
+ * A generated map is kept in a compact roadMapT structure rather than
+ * in a Graph, because a Graph with millions of named nodes would need
+ * far more memory than the generator itself.  The map can be written
+ * in the text format read by the Pathfinder application, written and
+ * read in a much faster binary format, or turned into a Graph.
+ */
+
+#ifndef _mapgen_h
+#define _mapgen_h
+
+#include "genlib.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+#include "point.h"
+
+/*
+ * Type: roadShapeT
+ * ----------------
+ * This type identifies the kinds of maps the generator can build:
+ *
+ *   GRID_ROADS       A grid of streets whose intersections are moved
+ *                    by a random amount, with about one block in ten
+ *                    missing and an occasional diagonal street.
+ *   GEOMETRIC_ROADS  Nodes scattered at random, each joined to its
+ *                    three nearest neighbors.  These maps have the
+ *                    irregular degrees of rural networks and usually
+ *                    contain some small islands.
+ *   HIGHWAY_ROADS    A grid of slow local streets overlaid with faster
+ *                    highways joining every eighth intersection, and
+ *                    faster still every sixty-fourth, which gives the
+ *                    map the hierarchy of a real road network.
+ */
+
+enum roadShapeT { GRID_ROADS, GEOMETRIC_ROADS, HIGHWAY_ROADS };
+
+/*
+ * Type: roadT
+ * -----------
+ * This type represents a road between the nodes with indices start and
+ * finish.  Roads can be traveled in both directions, so each road
+ * becomes a pair of arcs in a Graph, just as in the map files.
+ */
+
+struct roadT {
+	int start, finish;
+	double distance;
+};
+
+/*
+ * Type: roadMapT
+ * --------------
+ * This type holds a generated map.  The nodes are numbered from 0, and
+ * locs[i] is the location of node i.  Every distance is a positive
+ * integer, which the text format requires.
+ */
+
+struct roadMapT {
+	Vector<pointT> locs;
+	Vector<roadT> roads;
+};
+
+/*
+ * Function: GenerateRoads
+ * Usage: GenerateRoads(map, shape, nNodes);
+ *        GenerateRoads(map, shape, nNodes, nThreads);
+ * ---------------------------------------------------
+ * Replaces the contents of map with a new map of the specified shape
+ * and number of nodes.  The work is divided among nThreads threads, or
+ * one per processor if nThreads is 0.  The map is determined entirely
+ * by the state of the random number generator in random.h, so calling
+ * SetRandomSeed with the same seed before GenerateRoads produces the
+ * same map every time, whatever the number of threads.
+ */
+
+void GenerateRoads(roadMapT & map, roadShapeT shape, int nNodes,
+                   int nThreads = 0);
+
+/*
+ * Function: BuildGraph
+ * Usage: BuildGraph(map, graph);
+ * ------------------------------
+ * Replaces the contents of graph with the nodes and roads of map.  The
+ * nodes are named n0, n1, n2, and so on, and each road becomes two arcs.
+ */
+
+void BuildGraph(roadMapT & map, Graph<nodeT,arcT> & graph);
+
+/*
+ * Function: WriteTextMap
+ * Usage: WriteTextMap(map, filename, imageName);
+ *        WriteTextMap(map, filename, imageName, nThreads);
+ * ------------------------------------------------------
+ * Writes map to the specified file in the NODES/ARCS format used by the
+ * Pathfinder application, naming the nodes as BuildGraph does.  The
+ * first line of the file names the background image.  The lines are
+ * formatted on nThreads threads, or one per processor if nThreads is 0.
+ */
+
+void WriteTextMap(roadMapT & map, string filename, string imageName,
+                  int nThreads = 0);
+
+/*
+ * Functions: WriteBinaryMap, ReadBinaryMap
+ * Usage: WriteBinaryMap(map, filename);
+ *        if (ReadBinaryMap(map, filename)) . . .
+ * ----------------------------------------------
+ * These functions write and read map in a binary format that stores the
+ * numbers exactly as they are held in memory, which makes reading a
+ * large map many times faster than parsing the text format.  The file
+ * uses the byte order of the machine that wrote it.  ReadBinaryMap
+ * returns false, leaving map unchanged, if the file cannot be opened or
+ * is not a valid map file.
+ */
+
+void WriteBinaryMap(roadMapT & map, string filename);
+bool ReadBinaryMap(roadMapT & map, string filename);
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * File: mst.cpp
+ * -------------
+ * This file implements the mst.h interface.
+ */
+
+#include "genlib.h"
+#include "mst.h"
+#include "distqueue.h"
+
+/* Private function prototypes */
+
+static int FindRoot(Vector<int> & parent, int index);
+
+/*
+ * Implementation notes: MinimumSpanningForest
+ * -------------------------------------------
+ * Kruskal's algorithm considers the arcs in order of increasing
+ * distance and keeps each arc whose endpoints are not yet joined by the
+ * arcs kept so far.  The arcs are ordered by a DistanceQueue holding
+ * their positions in the arcs vector, which on the integer distances of
+ * the map files sorts them with buckets in linear time.  Which nodes
+ * are already joined is recorded in a union-find structure like the
+ * one in ComponentIndex, and the loop stops as soon as the forest has
+ * one arc fewer than the graph has nodes.
+ */
+
+double MinimumSpanningForest(Graph<nodeT,arcT> & graph, Vector<arcT *> & tree) {
+	tree.clear();
+	int n = graph.size();
+	Vector<arcT *> arcs;
+	for (int i = 0; i < n; i++) {
+		nodeT *node = graph.getNodeByIndex(i);
+		for (int j = 0; j < node->arcs.size(); j++) {
+			arcs.add(node->arcs[j]);
+		}
+	}
+	double maxArc;
+	DistanceQueue queue;
+	queueKindT kind = ChooseQueueKind(graph, maxArc);
+	queue.setKind(kind, maxArc);
+	for (int i = 0; i < arcs.size(); i++) {
+		queue.enqueue(i, arcs[i]->distance);
+	}
+	Vector<int> parent(n);
+	Vector<int> treeSize(n);
+	for (int i = 0; i < n; i++) {
+		parent.add(i);
+		treeSize.add(1);
+	}
+	double total = 0;
+	while (!queue.isEmpty() && tree.size() < n - 1) {
+		arcT *arc = arcs[queue.dequeue().node];
+		int r1 = FindRoot(parent, arc->start->index);
+		int r2 = FindRoot(parent, arc->finish->index);
+		if (r1 == r2) continue;
+		if (treeSize[r1] < treeSize[r2]) {
+			int tmp = r1;
+			r1 = r2;
+			r2 = tmp;
+		}
+		parent[r2] = r1;
+		treeSize[r1] += treeSize[r2];
+		tree.add(arc);
+		total += arc->distance;
+	}
+	return total;
+}
+
+/*
+ * Function: FindRoot
+ * Usage: int root = FindRoot(parent, index);
+ * ------------------------------------------
+ * Returns the root of the tree containing index, halving the path to
+ * it along the way.
+ */
+
+static int FindRoot(Vector<int> & parent, int index) {
+	while (parent[index] != index) {
+		parent[index] = parent[parent[index]];
+		index = parent[index];
+	}
+	return index;
+}
@@ -0,0 +1,31 @@
+/*
+ * File: mst.h
+ * -----------
+ * This interface exports a function that finds a minimum spanning
+ * forest of a Pathfinder graph, which is the cheapest set of roads that
+ * keeps every pair of connected locations connected.
+ */
+
+#ifndef _mst_h
+#define _mst_h
+
+#include "genlib.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+
+/*
+ * Function: MinimumSpanningForest
+ * Usage: double total = MinimumSpanningForest(graph, tree);
+ * ---------------------------------------------------------
+ * Replaces the contents of tree with the arcs of a minimum spanning
+ * forest of graph, found with Kruskal's algorithm, and returns their
+ * total distance.  The direction of the arcs is ignored, so of the two
+ * arcs that represent a road in the map files, at most one appears in
+ * the result.  The forest contains one tree for each component of the
+ * graph.  The graph is not modified.
+ */
+
+double MinimumSpanningForest(Graph<nodeT,arcT> & graph, Vector<arcT *> & tree);
+
+#endif
@@ -0,0 +1,303 @@
+/*
+ * File: nodeorder.cpp
+ * -------------------
+ * This file implements the nodeorder.h interface.
+ */
+
+#include "genlib.h"
+#include "nodeorder.h"
+
+/* Constants */
+
+const int HILBERT_BITS = 16;                  /* Bits per coordinate */
+const int HILBERT_SIDE = 1 << HILBERT_BITS;   /* Cells per side      */
+
+/* Private function prototypes */
+
+static void HilbertOrder(Graph<nodeT,arcT> & graph, Vector<nodeT *> & order);
+static unsigned HilbertKey(unsigned x, unsigned y);
+static void SortByKey(Vector<unsigned> & keys, Vector<int> & items);
+static void BreadthFirstOrder(Graph<nodeT,arcT> & graph,
+                              Vector<nodeT *> & order, bool reverseCM);
+static nodeT *FarthestNode(nodeT *start, Vector<int> & mark, int stamp,
+                           Vector<nodeT *> & queue);
+static void AddNeighbors(nodeT *node, Vector<bool> & placed,
+                         Vector<nodeT *> & order, bool byDegree);
+static int Degree(nodeT *node);
+static bool HasDistinctLocations(Graph<nodeT,arcT> & graph);
+
+void ComputeNodeOrder(Graph<nodeT,arcT> & graph, Vector<nodeT *> & order,
+                      nodeOrderT method) {
+	if (method == AUTO_ORDER) {
+		method = (HasDistinctLocations(graph)) ? HILBERT_ORDER : RCM_ORDER;
+	}
+	switch (method) {
+	  case HILBERT_ORDER: HilbertOrder(graph, order); break;
+	  case BFS_ORDER: BreadthFirstOrder(graph, order, false); break;
+	  case RCM_ORDER: BreadthFirstOrder(graph, order, true); break;
+	  default: Error("ComputeNodeOrder: Illegal method");
+	}
+}
+
+/*
+ * Implementation notes: ReorderGraph
+ * ----------------------------------
+ * Renumbering the nodes changes the layout of the arrays indexed by
+ * node but leaves the nodes and arcs wherever they were allocated.
+ * Copying the graph allocates them again in index order, with each
+ * node's arcs following one another, and swapping the copy into place
+ * lets the original storage be freed when the copy goes out of scope.
+ */
+
+void ReorderGraph(Graph<nodeT,arcT> & graph, nodeOrderT method) {
+	Vector<nodeT *> order;
+	ComputeNodeOrder(graph, order, method);
+	graph.reorderNodes(order);
+	Graph<nodeT,arcT> packed(graph);
+	graph.swap(packed);
+}
+
+/*
+ * Function: HilbertOrder
+ * Usage: HilbertOrder(graph, order);
+ * ----------------------------------
+ * Scales the locations of the nodes onto a square grid with
+ * HILBERT_SIDE cells on a side, computes the position of each node's
+ * cell along the Hilbert curve through the grid, and sorts the nodes
+ * by that position.  The same scale is used in both directions, so the
+ * curve is not distorted on maps that are much wider than they are
+ * tall.  Nodes in the same cell keep their original relative order.
+ */
+
+static void HilbertOrder(Graph<nodeT,arcT> & graph, Vector<nodeT *> & order) {
+	int n = graph.size();
+	order.clear();
+	if (n == 0) return;
+	pointT lo = graph.getNodeByIndex(0)->loc;
+	pointT hi = lo;
+	for (int i = 1; i < n; i++) {
+		pointT pt = graph.getNodeByIndex(i)->loc;
+		if (pt.x < lo.x) lo.x = pt.x;
+		if (pt.y < lo.y) lo.y = pt.y;
+		if (pt.x > hi.x) hi.x = pt.x;
+		if (pt.y > hi.y) hi.y = pt.y;
+	}
+	double extent = hi.x - lo.x;
+	if (hi.y - lo.y > extent) extent = hi.y - lo.y;
+	double scale = (extent > 0) ? (HILBERT_SIDE - 1) / extent : 0;
+	Vector<unsigned> keys(n);
+	Vector<int> items(n);
+	for (int i = 0; i < n; i++) {
+		pointT pt = graph.getNodeByIndex(i)->loc;
+		unsigned x = unsigned((pt.x - lo.x) * scale);
+		unsigned y = unsigned((pt.y - lo.y) * scale);
+		keys.add(HilbertKey(x, y));
+		items.add(i);
+	}
+	SortByKey(keys, items);
+	order = Vector<nodeT *>(n);
+	for (int i = 0; i < n; i++) {
+		order.add(graph.getNodeByIndex(items[i]));
+	}
+}
+
+/*
+ * Function: HilbertKey
+ * Usage: unsigned key = HilbertKey(x, y);
+ * ---------------------------------------
+ * Returns the position of the cell (x, y) along the Hilbert curve that
+ * fills a square of HILBERT_SIDE cells on a side.  At each level the
+ * loop finds the quadrant containing the cell, adds the number of cells
+ * in the quadrants the curve visits first, and rotates the coordinates
+ * into the orientation of the curve within that quadrant.  The result
+ * has 2 * HILBERT_BITS bits, which fit in an unsigned int.
+ */
+
+static unsigned HilbertKey(unsigned x, unsigned y) {
+	unsigned key = 0;
+	for (unsigned s = HILBERT_SIDE / 2; s > 0; s /= 2) {
+		unsigned rx = (x & s) ? 1 : 0;
+		unsigned ry = (y & s) ? 1 : 0;
+		key += s * s * ((3 * rx) ^ ry);
+		if (ry == 0) {
+			if (rx == 1) {
+				x = HILBERT_SIDE - 1 - x;
+				y = HILBERT_SIDE - 1 - y;
+			}
+			unsigned tmp = x;
+			x = y;
+			y = tmp;
+		}
+	}
+	return key;
+}
+
+/*
+ * Function: SortByKey
+ * Usage: SortByKey(keys, items);
+ * ------------------------------
+ * Sorts items into increasing order of the corresponding keys, and the
+ * keys along with them, using a radix sort on the low and then the high
+ * HILBERT_BITS bits of the keys.  Each pass is a stable counting sort,
+ * so the sort takes linear time and items with equal keys keep their
+ * order.
+ */
+
+static void SortByKey(Vector<unsigned> & keys, Vector<int> & items) {
+	int n = keys.size();
+	Vector<unsigned> keyBuffer = keys;
+	Vector<int> itemBuffer = items;
+	Vector<int> count(HILBERT_SIDE + 1);
+	for (int shift = 0; shift < 2 * HILBERT_BITS; shift += HILBERT_BITS) {
+		count.clear();
+		for (int d = 0; d <= HILBERT_SIDE; d++) {
+			count.add(0);
+		}
+		for (int i = 0; i < n; i++) {
+			count[((keys[i] >> shift) & (HILBERT_SIDE - 1)) + 1]++;
+		}
+		for (int d = 0; d < HILBERT_SIDE; d++) {
+			count[d + 1] += count[d];
+		}
+		for (int i = 0; i < n; i++) {
+			int pos = count[(keys[i] >> shift) & (HILBERT_SIDE - 1)]++;
+			keyBuffer[pos] = keys[i];
+			itemBuffer[pos] = items[i];
+		}
+		keys.swap(keyBuffer);
+		items.swap(itemBuffer);
+	}
+}
+
+/*
+ * Function: BreadthFirstOrder
+ * Usage: BreadthFirstOrder(graph, order, reverseCM);
+ * --------------------------------------------------
+ * Orders the nodes by breadth-first searches over the arcs in both
+ * directions, starting a new search at the first unplaced node in
+ * index order whenever one search runs out of nodes.  The order vector
+ * itself serves as the queue.  For the reverse Cuthill-McKee order,
+ * each search instead starts from the node farthest from that node,
+ * visits the neighbors of each node in increasing order of degree, and
+ * the finished order is reversed.
+ */
+
+static void BreadthFirstOrder(Graph<nodeT,arcT> & graph,
+                              Vector<nodeT *> & order, bool reverseCM) {
+	int n = graph.size();
+	order = Vector<nodeT *>(n);
+	Vector<bool> placed(n);
+	Vector<int> mark(n);
+	for (int i = 0; i < n; i++) {
+		placed.add(false);
+		mark.add(0);
+	}
+	Vector<nodeT *> queue;
+	int nComponents = 0;
+	for (int i = 0; i < n; i++) {
+		nodeT *start = graph.getNodeByIndex(i);
+		if (placed[start->index]) continue;
+		if (reverseCM) start = FarthestNode(start, mark, ++nComponents, queue);
+		int head = order.size();
+		order.add(start);
+		placed[start->index] = true;
+		while (head < order.size()) {
+			AddNeighbors(order[head++], placed, order, reverseCM);
+		}
+	}
+	if (reverseCM) {
+		for (int lo = 0, hi = n - 1; lo < hi; lo++, hi--) {
+			nodeT *tmp = order[lo];
+			order[lo] = order[hi];
+			order[hi] = tmp;
+		}
+	}
+}
+
+/*
+ * Function: FarthestNode
+ * Usage: nodeT *node = FarthestNode(start, mark, stamp, queue);
+ * -------------------------------------------------------------
+ * Runs a breadth-first search from start and returns the last node it
+ * reaches, which is in the deepest level of the search.  Nodes are
+ * marked as visited by setting their entries in mark to stamp, which
+ * must differ from every stamp used before; the queue is working
+ * storage.  A single search of this kind is the usual cheap way to
+ * find a node near the edge of a component.
+ */
+
+static nodeT *FarthestNode(nodeT *start, Vector<int> & mark, int stamp,
+                           Vector<nodeT *> & queue) {
+	queue.clear();
+	queue.add(start);
+	mark[start->index] = stamp;
+	for (int head = 0; head < queue.size(); head++) {
+		nodeT *node = queue[head];
+		for (int j = 0; j < node->arcs.size(); j++) {
+			nodeT *next = node->arcs[j]->finish;
+			if (mark[next->index] != stamp) {
+				mark[next->index] = stamp;
+				queue.add(next);
+			}
+		}
+		for (int j = 0; j < node->incoming.size(); j++) {
+			nodeT *next = node->incoming[j]->start;
+			if (mark[next->index] != stamp) {
+				mark[next->index] = stamp;
+				queue.add(next);
+			}
+		}
+	}
+	return queue[queue.size() - 1];
+}
+
+/*
+ * Function: AddNeighbors
+ * Usage: AddNeighbors(node, placed, order, byDegree);
+ * ---------------------------------------------------
+ * Adds to the end of order the nodes at the other end of the arcs
+ * leaving and entering node that have not yet been placed, each once,
+ * and marks them as placed.  If byDegree is true, the added nodes are
+ * put in order of increasing degree with an insertion sort, since a
+ * node has only a few neighbors.
+ */
+
+static void AddNeighbors(nodeT *node, Vector<bool> & placed,
+                         Vector<nodeT *> & order, bool byDegree) {
+	int first = order.size();
+	int nArcs = node->arcs.size() + node->incoming.size();
+	for (int j = 0; j < nArcs; j++) {
+		nodeT *next;
+		if (j < node->arcs.size()) {
+			next = node->arcs[j]->finish;
+		} else {
+			next = node->incoming[j - node->arcs.size()]->start;
+		}
+		if (placed[next->index]) continue;
+		placed[next->index] = true;
+		order.add(next);
+		if (byDegree) {
+			int k = order.size() - 1;
+			int degree = Degree(next);
+			while (k > first && Degree(order[k - 1]) > degree) {
+				order[k] = order[k - 1];
+				k--;
+			}
+			order[k] = next;
+		}
+	}
+}
+
+static int Degree(nodeT *node) {
+	return node->arcs.size() + node->incoming.size();
+}
+
+static bool HasDistinctLocations(Graph<nodeT,arcT> & graph) {
+	if (graph.size() == 0) return false;
+	pointT p0 = graph.getNodeByIndex(0)->loc;
+	for (int i = 1; i < graph.size(); i++) {
+		pointT pt = graph.getNodeByIndex(i)->loc;
+		if (pt.x != p0.x || pt.y != p0.y) return true;
+	}
+	return false;
+}
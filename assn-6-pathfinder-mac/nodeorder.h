@@ -0,0 +1,76 @@
+/*
+ * File: nodeorder.h
+ * -----------------
+ * This interface exports functions that renumber the nodes of a
+ * Pathfinder graph so that nodes near one another in the map are also
+ * near one another in memory.  The search engines keep their per-node
+ * data in arrays indexed by node, and a node's neighbors are usually
+ * the next nodes a search examines, so when neighbors have nearby
+ * indices a search touches far fewer cache lines.  The nodes of a map
+ * file are numbered in the order in which the file lists them, which
+ * need not have anything to do with where they are.
+ */
+
+#ifndef _nodeorder_h
+#define _nodeorder_h
+
+#include "genlib.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+
+/*
+ * Type: nodeOrderT
+ * ----------------
+ * This type identifies the ways of ordering the nodes:
+ *
+ *   HILBERT_ORDER  Orders the nodes along a Hilbert curve through the
+ *                  bounding box of their loc fields.  The curve visits
+ *                  every part of a square before moving on, so nodes
+ *                  that are close on the map are usually close in the
+ *                  order as well.
+ *   BFS_ORDER      Orders the nodes by a breadth-first search over the
+ *                  arcs, ignoring their direction.
+ *   RCM_ORDER      Orders the nodes by the reverse Cuthill-McKee
+ *                  method, a breadth-first search from an outlying
+ *                  node that visits neighbors of low degree first and
+ *                  is then reversed, which keeps the indices of the
+ *                  endpoints of every arc particularly close.
+ *   AUTO_ORDER     Chooses HILBERT_ORDER if the nodes have different
+ *                  locations and RCM_ORDER if they do not.
+ *
+ * The searches in BFS_ORDER and RCM_ORDER start again from the first
+ * unvisited node for each component of the graph.
+ */
+
+enum nodeOrderT { HILBERT_ORDER, BFS_ORDER, RCM_ORDER, AUTO_ORDER };
+
+/*
+ * Function: ComputeNodeOrder
+ * Usage: ComputeNodeOrder(graph, order, method);
+ * ----------------------------------------------
+ * Replaces the contents of order with the nodes of graph in the order
+ * chosen by method.  The graph is not modified, so the result can be
+ * passed to the reorderNodes method of the graph.  Every method runs in
+ * time proportional to the number of nodes and arcs.
+ */
+
+void ComputeNodeOrder(Graph<nodeT,arcT> & graph, Vector<nodeT *> & order,
+                      nodeOrderT method = AUTO_ORDER);
+
+/*
+ * Function: ReorderGraph
+ * Usage: ReorderGraph(graph, method);
+ * -----------------------------------
+ * Renumbers the nodes of graph in the order chosen by method and then
+ * rebuilds the graph so that its nodes and arcs are allocated in that
+ * order as well.  Like loading a new map, this replaces every node and
+ * arc, so any pointers to them held outside the graph are no longer
+ * valid; listeners such as SpatialIndex are notified and follow the
+ * change.  Data indexed by node, such as the tables of a Landmarks
+ * object, must be computed again.
+ */
+
+void ReorderGraph(Graph<nodeT,arcT> & graph, nodeOrderT method = AUTO_ORDER);
+
+#endif
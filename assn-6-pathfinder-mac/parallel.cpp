@@ -0,0 +1,86 @@
+/*
+ * File: parallel.cpp
+ * ------------------
+ * This file implements the parallel.h interface using POSIX threads,
+ * which are available on every platform on which Pathfinder runs.
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+#include "genlib.h"
+#include "parallel.h"
+#include "vector.h"
+
+/* Structure passed to each thread */
+
+struct threadArgT {
+	ParallelTaskBase *task;
+	int thread;
+	int nThreads;
+};
+
+/* Prototypes */
+
+static void *ThreadMain(void *arg);
+
+/*
+ * Implementation notes: GetProcessorCount
+ * ---------------------------------------
+ * The number of online processors is available through sysconf on
+ * both Mac OS X and Linux.
+ */
+
+int GetProcessorCount() {
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return (count < 1) ? 1 : (int) count;
+}
+
+ParallelTaskBase::~ParallelTaskBase() {
+	/* Empty */
+}
+
+/*
+ * Implementation notes: RunParallelTask
+ * -------------------------------------
+ * This function starts threads 1 through nThreads - 1, runs thread 0
+ * itself, and then joins the others.  If a thread cannot be created,
+ * its share of the work is done on the calling thread instead, which
+ * keeps the result correct at the cost of some parallelism.
+ */
+
+void RunParallelTask(int nThreads, ParallelTaskBase *task) {
+	Vector<threadArgT> args(nThreads);
+	Vector<pthread_t> threads(nThreads);
+	Vector<bool> started(nThreads);
+	for (int i = 0; i < nThreads; i++) {
+		threadArgT arg = { task, i, nThreads };
+		args.add(arg);
+		threads.add(pthread_t());
+		started.add(false);
+	}
+	for (int i = 1; i < nThreads; i++) {
+		started[i] = pthread_create(&threads[i], NULL, ThreadMain,
+		                            &args[i]) == 0;
+	}
+	task->run(0, nThreads);
+	for (int i = 1; i < nThreads; i++) {
+		if (started[i]) {
+			pthread_join(threads[i], NULL);
+		} else {
+			task->run(i, nThreads);
+		}
+	}
+}
+
+/*
+ * Function: ThreadMain
+ * Usage: pthread_create(&thread, NULL, ThreadMain, &arg);
+ * -------------------------------------------------------
+ * Entry point for each thread created by RunParallelTask.
+ */
+
+static void *ThreadMain(void *arg) {
+	threadArgT *tp = (threadArgT *) arg;
+	tp->task->run(tp->thread, tp->nThreads);
+	return NULL;
+}
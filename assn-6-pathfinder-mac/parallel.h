@@ -0,0 +1,60 @@
+/*
+ * File: parallel.h
+ * ----------------
+ * This interface exports a minimal facility for running a function on
+ * several threads at once.  The model is deliberately simple: the client
+ * supplies a function and a block of data, RunInParallel calls that
+ * function once on each of the requested number of threads, and the
+ * call returns only after every thread has finished.  Each invocation
+ * is told which thread it is running on, so that it can divide the work
+ * among the threads without any further coordination.
+ *
+ * The functions that run in parallel must not modify any data that
+ * other threads are reading or writing.  In particular, the collection
+ * classes in the cs106 library are safe to share only if no thread
+ * modifies them and no thread uses foreach on them while another thread
+ * modifies the same collection.
+ */
+
+#ifndef _parallel_h
+#define _parallel_h
+
+#include "genlib.h"
+
+/*
+ * Function: GetProcessorCount
+ * Usage: int nThreads = GetProcessorCount();
+ * ------------------------------------------
+ * Returns the number of processors available to this program, which is
+ * the natural number of threads to use for work that is limited by
+ * computation rather than memory.  The result is always at least 1.
+ */
+
+int GetProcessorCount();
+
+/*
+ * Function: RunInParallel
+ * Usage: RunInParallel(nThreads, fn, data);
+ * -----------------------------------------
+ * Calls
+ *
+ *       fn(thread, nThreads, data)
+ *
+ * once for each value of thread between 0 and nThreads - 1, with each
+ * call running on its own thread, and waits for all of the calls to
+ * return.  The call for thread 0 runs on the calling thread.  If
+ * nThreads is 1 or less, fn is simply called once with thread set to 0
+ * and nThreads set to 1, so that the same code serves both the serial
+ * and parallel cases.
+ */
+
+template <typename ClientDataType>
+void RunInParallel(int nThreads,
+                   void (*fn)(int thread, int nThreads, ClientDataType & data),
+                   ClientDataType & data);
+
+/* Include the implementation of the template function */
+
+#include "parallelimpl.cpp"
+
+#endif
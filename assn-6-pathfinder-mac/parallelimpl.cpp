@@ -0,0 +1,75 @@
+/*
+ * File: parallelimpl.cpp
+ * ----------------------
+ * This file implements the template function RunInParallel.  C++
+ * requires that this code be available at the time the interface is
+ * read, but clients are not expected to look at this code.
+ */
+
+#ifdef _parallel_h
+
+/*
+ * Implementation notes: task classes
+ * ----------------------------------
+ * The code that creates and joins the threads lives in parallel.cpp
+ * and cannot know the ClientDataType used by the client.  As in the
+ * callback classes in gpathfinderimpl.cpp, the function and the address
+ * of the client data are therefore stored in a template subclass of a
+ * base class with a virtual run method, and RunParallelTask works only
+ * with the base class.
+ */
+
+class ParallelTaskBase {
+public:
+	virtual ~ParallelTaskBase();
+	virtual void run(int thread, int nThreads) = 0;
+};
+
+template <typename ClientDataType>
+class ParallelTask : public ParallelTaskBase {
+public:
+	ParallelTask(void (*fn)(int thread, int nThreads, ClientDataType & data),
+	             ClientDataType *pdata);
+	virtual void run(int thread, int nThreads);
+
+private:
+	void (*fn)(int thread, int nThreads, ClientDataType & data);
+	ClientDataType *pdata;
+};
+
+template <typename ClientDataType>
+ParallelTask<ClientDataType>::ParallelTask(
+                  void (*fn)(int thread, int nThreads, ClientDataType & data),
+                  ClientDataType *pdata) {
+	this->fn = fn;
+	this->pdata = pdata;
+}
+
+template <typename ClientDataType>
+void ParallelTask<ClientDataType>::run(int thread, int nThreads) {
+	fn(thread, nThreads, *pdata);
+}
+
+/*
+ * Function: RunParallelTask
+ * Usage: RunParallelTask(nThreads, task);
+ * ---------------------------------------
+ * Runs task->run on nThreads threads and waits for them to finish.
+ * This function is implemented in parallel.cpp.
+ */
+
+void RunParallelTask(int nThreads, ParallelTaskBase *task);
+
+template <typename ClientDataType>
+void RunInParallel(int nThreads,
+                   void (*fn)(int thread, int nThreads, ClientDataType & data),
+                   ClientDataType & data) {
+	if (nThreads <= 1) {
+		fn(0, 1, data);
+		return;
+	}
+	ParallelTask<ClientDataType> task(fn, &data);
+	RunParallelTask(nThreads, &task);
+}
+
+#endif
@@ -17,88 +17,360 @@
  as a string. I chose to do it this way so that the client doesn't actually
  have access to all the methods where the real calculations are done. Rather
  they have to call other methods to retrieve the information for them.
+ 
+ The path is found with Dijkstra's algorithm the first time the client asks
+ for it, and the result is kept until the map, start or finish changes, so
+ GetDistance runs in constant time. The search itself keeps its distances,
+ parent arcs and queue in a SearchSpace indexed by the node indices. A
+ client that runs many queries can hand the same SearchSpace to each Path
+ with SetWorkspace; the SearchSpace resets itself between searches without
+ clearing its arrays, so each query only costs time for the part of the map
+ it explores. A Path that is not given a workspace creates its own and
+ frees it in the destructor.
+ 
+ When the same start is used with many destinations, the client can give
+ the Path a TreeCache with SetCache instead. The first search from a start
+ then builds the whole shortest-path tree, and every later query from that
+ start just follows parent arcs back from the finish.
+ 
+ For single queries on a large map, the client can give the Path a set of
+ Landmarks with SetLandmarks. The search then becomes A*: each node is
+ taken off the queue in order of its distance plus the landmark lower
+ bound on the distance still to go, which steers the search toward the
+ finish. The bound is consistent, so a node is still final the first time
+ it comes off the queue. The priorities are no longer whole numbers, so
+ this search always uses the binary heap. If the map has changed since
+ the landmarks were computed, their bounds may be wrong and the Path
+ falls back to Dijkstra's algorithm. GetSettledCount reports how many
+ nodes the last search settled, which shows how much the landmarks help.
+ 
+ A ComponentIndex given with SetComponents lets FindPath give up at once
+ when start and finish lie in different components. Without it, that case
+ is the slowest of all, since the search has to settle every node it can
+ reach before it knows that finish is not among them.
+ 
+ Paths can be copied, so that functions like KShortestPaths can return a
+ Vector of them. A copy shares the map, cache, landmarks and any workspace
+ the client gave the original, but never a workspace the original created
+ for itself, since each Path frees only the one it owns. SetRoute hands
+ the Path a route that was found some other way, which then behaves
+ exactly like a route the Path found itself.
+ 
+ A client that wants to know why a query was slow can give the Path a
+ searchStatsT record with SetStats. Every search then fills in the record:
+ the counts come from the SearchSpace, which keeps them anyway, and the
+ clock is only read when a record has been given, so a Path without one
+ does no extra work. A query answered by the TreeCache reports the search
+ that built the tree, or nothing but the path time if an earlier query
+ already built it.
+ 
+ A SearchControl given with SetControl lets the client put a deadline on
+ each search or cancel it, which keeps the window responsive when a query
+ on a huge map would otherwise run for seconds. The search checks the
+ control every SEARCH_CHECK_INTERVAL settled nodes. A search that is
+ stopped counts as finished, so the Path reports no route until the
+ start, finish or map changes, and the control tells the client why the
+ search stopped and how long the route must at least be. Stopping leaves
+ nothing to clean up: the next search resets the workspace in constant
+ time however much of the map the stopped search had reached.
  */
 
 #include "path.h"
 #include "genlib.h"
-#include <typeinfo>
-
-// [TODO: implement the methods in your Path class]
 
 Path::Path(){
-    start = new nodeT;
-    finish = new nodeT;
-    Vector<arcT> *finalPath = new Vector<arcT>;
-    Graph<nodeT,arcT> *pathF = new Graph<nodeT,arcT>;
-    distance = 0;
+    start = NULL;
+    finish = NULL;
+    pathF = NULL;
+    space = NULL;
+    ownsSpace = false;
+    cache = NULL;
+    landmarks = NULL;
+    components = NULL;
+    settledCount = 0;
+    stats = NULL;
+    control = NULL;
+    Invalidate();
+}
+
+Path::Path(const Path & other){
+    space = NULL;
+    ownsSpace = false;
+    CopyFrom(other);
+}
+
+Path::~Path(){
+    if (ownsSpace) delete space;
+}
+
+Path & Path::operator=(const Path & other){
+    if (this != &other) CopyFrom(other);
+    return *this;
+}
+
+/*
+ * The map is passed by reference and only its address is kept, so
+ * handing a graph to a Path never copies the nodes and arcs.  The
+ * graph must outlive the Path.
+ */
+void Path::SetMap(Graph<nodeT,arcT> & pathF2){
+    pathF = &pathF2;
+    Invalidate();
+}
+
+/*
+ * The workspace is shared rather than copied, so it must outlive the
+ * Path and must not be used by two searches at the same time.  The
+ * workspace also remembers which queue suits the map, so sharing it
+ * saves a pass over the arcs on every query.
+ */
+void Path::SetWorkspace(SearchSpace & workspace){
+    if (ownsSpace) delete space;
+    space = &workspace;
+    ownsSpace = false;
+    Invalidate();
+}
+
+/*
+ * Like the workspace, the cache is shared with the client. Once a cache
+ * is set, the Path uses it for every search instead of the workspace.
+ */
+void Path::SetCache(TreeCache & treeCache){
+    cache = &treeCache;
+    Invalidate();
+}
+
+/*
+ * The landmarks are also shared, and are only used while they are
+ * current for the map.
+ */
+void Path::SetLandmarks(Landmarks & marks){
+    landmarks = &marks;
+    Invalidate();
+}
+
+/*
+ * The record belongs to the client, which reads it after each query.
+ */
+void Path::SetStats(searchStatsT & record){
+    stats = &record;
 }
 
-Path::~Path(){}
+/*
+ * The control is shared too, so one control can limit every Path that
+ * answers the same request.
+ */
+void Path::SetControl(SearchControl & searchControl){
+    control = &searchControl;
+}
 
-void Path::SetMap(Graph<nodeT,arcT> pathF2){
-     *pathF = pathF2;
+/*
+ * The component index is shared as well, and must be attached to the
+ * same graph as the map.
+ */
+void Path::SetComponents(ComponentIndex & index){
+    components = &index;
+    Invalidate();
 }
 
-void Path::SetStart(nodeT strt){
-    *start = strt;
+void Path::SetStart(nodeT *strt){
+    start = strt;
+    Invalidate();
 }
 
-void Path::SetFinish(nodeT fin){
-    *finish = fin;
+void Path::SetFinish(nodeT *fin){
+    finish = fin;
+    Invalidate();
+}
+
+/*
+ * The route must be a chain of arcs leading out of strt; an empty route
+ * is the path from strt to itself.
+ */
+void Path::SetRoute(nodeT *strt, Vector<arcT *> & arcs){
+    start = strt;
+    finish = strt;
+    distance = 0;
+    for (int i = 0; i < arcs.size(); i++) {
+        if (arcs[i]->start != finish) {
+            Error("SetRoute: The arcs do not form a path.");
+        }
+        finish = arcs[i]->finish;
+        distance += arcs[i]->distance;
+    }
+    finalPath = arcs;
+    settledCount = 0;
+    searched = true;
+}
+
+bool Path::Exists(){
+    if (!searched) FindPath();
+    return distance != UNREACHABLE;
 }
 
 double Path::GetDistance(){
-    if (finalPath) {
+    if (!Exists()) {
         Error("GetDistance: No current path at this point and time.");
     }
-    
-    foreach (arcT *arc in finalPath) {
-        distance += arc->distance;
-    }
+    return distance;
+}
+
+Vector<arcT *> Path::GetArcs(){
+    if (!searched) FindPath();
+    return finalPath;
+}
+
+int Path::GetSettledCount(){
+    if (!searched) FindPath();
+    return settledCount;
 }
 
 string Path::toString(){
-    
+    if (!Exists()) return "";
+    string str = start->name;
+    for (int i = 0; i < finalPath.size(); i++) {
+        str += "->" + finalPath[i]->finish->name;
+    }
+    return str;
 }
 
+/*
+ * FindPath runs Dijkstra's algorithm, or A* with landmarks, from start
+ * and stops as soon as finish is settled. Nodes are enqueued again
+ * whenever their distance improves, and stale queue entries are skipped
+ * when they come out. Since an A* queue entry holds the priority rather
+ * than the distance, the distance is always read from the workspace.
+ * The priority of the last node settled is a lower bound on the length
+ * of any route still to be found, so that is the bound given to the
+ * control if it stops the search.
+ * The path is then read backwards through the parent arcs.
+ */
 void Path::FindPath() {
     
-    Vector<arcT *> path;
-    Queue< Vector<arcT *> > queue;
-    Map<double> fixed;
+    if (pathF == NULL || start == NULL || finish == NULL) {
+        Error("FindPath: The map, start and finish must all be set.");
+    }
+    double clock = 0;
+    if (stats != NULL) {
+        ClearSearchStats(*stats);
+        clock = SearchClock();
+    }
+    if (control != NULL) control->begin();
+    if (components != NULL && !components->sameComponent(start, finish)) {
+        finalPath.clear();
+        distance = UNREACHABLE;
+        settledCount = 0;
+        searched = true;
+        if (stats != NULL) stats->setupTime = SearchClock() - clock;
+        return;
+    }
+    if (cache != NULL) {
+        distance = cache->getDistance(*pathF, start, finish, stats, control);
+        if (stats != NULL) clock = SearchClock();
+        finalPath.clear();
+        if (distance != UNREACHABLE) {
+            finalPath = cache->getPath(*pathF, start, finish);
+        }
+        settledCount = 0;
+        searched = true;
+        if (stats != NULL) stats->pathTime = SearchClock() - clock;
+        return;
+    }
+    if (space == NULL) {
+        space = new SearchSpace;
+        ownsSpace = true;
+    }
     
-    while (start != finish) {
-        if (!fixed.containsKey(start->name)) {
-            fixed.put(start->name, TotalPathDistance(path));
-            foreach (arcT *arc in start->arcs) {
-                if (!fixed.containsKey(arc->finish->name)) {
-                    Vector<arcT *> newPath = path;
-                    newPath.add(arc);
-                    
-                    queue.enqueue(newPath, TotalPathDistance(newPath));
-                }
+    bool useLandmarks = landmarks != NULL && landmarks->isCurrent(*pathF);
+    int goal = finish->index;
+    if (useLandmarks) {
+        space->reset(pathF->size(), BINARY_HEAP);
+    } else {
+        space->reset(*pathF);
+    }
+    DistanceQueue & queue = space->getQueue();
+    space->setDistance(start->index, 0, NULL);
+    queue.enqueue(start->index, 0);
+    if (stats != NULL) {
+        double now = SearchClock();
+        stats->setupTime = now - clock;
+        clock = now;
+    }
+    
+    long relaxed = 0;
+    while (!queue.isEmpty()) {
+        queueEntryT entry = queue.dequeue();
+        if (space->isSettled(entry.node)) continue;
+        space->settle(entry.node);
+        if (entry.node == goal) break;
+        if (control != NULL
+            && space->getSettledCount() % SEARCH_CHECK_INTERVAL == 0
+            && control->check(entry.dist)) break;
+        
+        nodeT *node = pathF->getNodeByIndex(entry.node);
+        double nodeDist = space->getDistance(entry.node);
+        relaxed += node->arcs.size();
+        for (int i = 0; i < node->arcs.size(); i++) {
+            arcT *arc = node->arcs[i];
+            int next = arc->finish->index;
+            double newDist = nodeDist + arc->distance;
+            if (newDist < space->getDistance(next)) {
+                space->setDistance(next, newDist, arc);
+                double priority = newDist;
+                if (useLandmarks) priority += landmarks->lowerBound(next, goal);
+                queue.enqueue(next, priority);
             }
         }
-        
-        if (queue.isEmpty()) break;
-        
-        path = queue.dequeue();
-        start = path[path.size() - 1]->finish;
     }
-}
-
-double Path::TotalPathDistance(Vector<arcT *> path) {
-    double distance = 0;
-    foreach (arcT *arc in path) {
-        distance += arc->distance;
+    
+    if (stats != NULL) {
+        double now = SearchClock();
+        stats->searchTime = now - clock;
+        clock = now;
     }
     
-    return distance;
+    settledCount = space->getSettledCount();
+    finalPath.clear();
+    distance = space->isSettled(finish->index) ? space->getDistance(finish->index)
+                                                : UNREACHABLE;
+    if (distance != UNREACHABLE) {
+        Vector<arcT *> reversed;
+        for (arcT *arc = space->getParentArc(finish->index); arc != NULL;
+             arc = space->getParentArc(arc->start->index)) {
+            reversed.add(arc);
+        }
+        for (int i = reversed.size() - 1; i >= 0; i--) {
+            finalPath.add(reversed[i]);
+        }
+    }
+    searched = true;
+    if (stats != NULL) {
+        space->fillStats(*stats);
+        stats->relaxed = relaxed;
+        stats->pathTime = SearchClock() - clock;
+    }
 }
 
+void Path::Invalidate() {
+    searched = false;
+    distance = UNREACHABLE;
+    finalPath.clear();
+}
 
-
-
-
-
-
+void Path::CopyFrom(const Path & other) {
+    if (ownsSpace) delete space;
+    start = other.start;
+    finish = other.finish;
+    finalPath = other.finalPath;
+    distance = other.distance;
+    searched = other.searched;
+    pathF = other.pathF;
+    space = (other.ownsSpace) ? NULL : other.space;
+    ownsSpace = false;
+    cache = other.cache;
+    landmarks = other.landmarks;
+    components = other.components;
+    settledCount = other.settledCount;
+    stats = other.stats;
+    control = other.control;
+}
@@ -37,32 +37,59 @@
 
 #include "genlib.h"
 #include "vector.h"
-#include "queue.h"
 #include "graphtypes.h"
 #include "point.h"
 #include "Graph.h"
+#include "searchspace.h"
+#include "treecache.h"
+#include "landmarks.h"
+#include "components.h"
+#include "searchstats.h"
+#include "searchcontrol.h"
 
 class Path {
 public:
     Path();
+    Path(const Path & other);
     ~Path();
+    Path & operator=(const Path & other);
     
-    void SetMap(Graph<nodeT,arcT> pathF2);
-    void SetStart(nodeT strt);
-    void SetFinish(nodeT fin);
+    void SetMap(Graph<nodeT,arcT> & pathF2);
+    void SetWorkspace(SearchSpace & workspace);
+    void SetCache(TreeCache & treeCache);
+    void SetLandmarks(Landmarks & marks);
+    void SetComponents(ComponentIndex & index);
+    void SetStats(searchStatsT & record);
+    void SetControl(SearchControl & searchControl);
+    void SetStart(nodeT *strt);
+    void SetFinish(nodeT *fin);
+    void SetRoute(nodeT *strt, Vector<arcT *> & arcs);
+    bool Exists();
     double GetDistance();
+    Vector<arcT *> GetArcs();
     string toString();
+    int GetSettledCount();
     
 private:
     //instance variables
     nodeT *start, *finish;
-    Vector<arcT> *finalPath;
+    Vector<arcT *> finalPath;
     double distance;
+    bool searched;
     Graph<nodeT,arcT> *pathF;
+    SearchSpace *space;
+    bool ownsSpace;
+    TreeCache *cache;
+    Landmarks *landmarks;
+    ComponentIndex *components;
+    int settledCount;
+    searchStatsT *stats;
+    SearchControl *control;
     
     //private methods
     void FindPath();
-    double TotalPathDistance(Vector<arcT *> path);
+    void Invalidate();
+    void CopyFrom(const Path & other);
 
 };
 
@@ -11,6 +11,7 @@
 
 #include "genlib.h"
 #include "gpathfinder.h"
+#include "extgraph.h"
 #include "simpio.h"
 #include "scanner.h"
 #include "graphtypes.h"
@@ -18,9 +19,24 @@
 #include "vector.h"
 #include "Queue.h"
 #include "path.h"
+#include "treecache.h"
+#include "spatialindex.h"
+#include "kshortest.h"
+#include "components.h"
+#include "mst.h"
+#include "searchstats.h"
+#include "searchcontrol.h"
 #include <iostream>
 #include <fstream>
 
+/* Constants */
+
+const int NUM_ALTERNATIVES = 5;
+const double QUERY_TIME_LIMIT = 5;
+const string ALTERNATIVE_COLORS[] = {
+    HIGHLIGHT_COLOR, "Blue", "Green", "Magenta", "Cyan"
+};
+
 /* Function prototypes */
 
 void QuitAction();
@@ -30,8 +46,16 @@ void NewArcs(Graph<nodeT,arcT> &pathF, Scanner &scanner, string &currToken, stri
 void CheckIncoming(string &currToken, bool &nodes, bool &arcs, Scanner &scanner);
 void CheckFile(string &text, ifstream &infile);
 void DrawMap(string &map);
-Vector<arcT *> FindShortest(Graph<nodeT,arcT> &pathF);
+void FindShortest(Graph<nodeT,arcT> &pathF);
+void FindAlternatives(Graph<nodeT,arcT> &pathF);
+void FindMST(Graph<nodeT,arcT> &pathF);
+SpatialIndex &MapIndex(Graph<nodeT,arcT> &pathF);
+ComponentIndex &MapComponents(Graph<nodeT,arcT> &pathF);
+nodeT *GetNodeFromClick(SpatialIndex &index, string prompt);
 double TotalPathDistance(Vector<arcT *> path);
+void StartQueryControl(SearchControl &control);
+void CancelOnClick(SearchControl &control);
+bool ReportStoppedSearch(SearchControl &control);
 
 /* Main program */
 
@@ -42,7 +66,8 @@ int main() {
 	InitPathfinderGraphics();
     AddButton("Map", NewMap, *pathF);
     AddButton("Dijkstra", FindShortest, *pathF);
-    AddButton("Kruscal", NewMap, *pathF);
+    AddButton("Alternatives", FindAlternatives, *pathF);
+    AddButton("Kruscal", FindMST, *pathF);
 	AddButton("Quit", QuitAction);
     
 	PathfinderEventLoop();
@@ -56,8 +81,8 @@ void QuitAction() {
 }
 
 /**
- * Function that creates a new graph and displays the new map
- * in the graphics window
+ * Function that creates a new graph, displays the new map
+ * in the graphics window, and reports the memory the graph uses
  *
  * @param the pathfinder graph
  * @return void
@@ -104,6 +129,9 @@ void NewMap(Graph<nodeT,arcT> &pathF) {
         }
     }
     
+    graphMemoryT memory = pathF.memoryStats();
+    cout << "Map memory: " << memory.totalBytes << " bytes ("
+         << memory.bytesPerNode << " per node)" << endl;
 }
 
 /**
@@ -180,9 +208,6 @@ void NewArcs(Graph<nodeT,arcT> &pathF, Scanner &scanner, string &currToken, stri
     
     pathF.addArc(currArc);
     
-    currArc->start->arcs.add(currArc);
-    currArc->finish->arcs.add(currArc);
-    
     DrawPathfinderArc(currArc->start->loc, currArc->finish->loc, "black");
     UpdatePathfinderDisplay();
 }
@@ -244,45 +269,223 @@ void CheckFile(string &text, ifstream &infile){
 }
 
 /**
- * This should be the method where the path class is used to help find the shortest
- * path yet I wasn't able to get a working implementation of the class finished
- * before the hard deadline
+ * Asks the user to click on two locations and draws the shortest path between
+ * them on the map. Each click is snapped to the nearest location by the
+ * spatial index from MapIndex. The shortest-path trees of recent
+ * starting points are kept in a TreeCache, so asking for another destination
+ * from the same start only has to follow the tree back from the destination.
+ * The work done by the search is printed below the route. A search that runs
+ * past QUERY_TIME_LIMIT seconds, or that the user stops by clicking, gives
+ * up and reports how long the route must at least be
  *
  * @param the graph with all the nodes and arcs
  * @return void
  */
-Vector<arcT *> FindShortest(Graph<nodeT,arcT> &pathF){
+void FindShortest(Graph<nodeT,arcT> &pathF){
     
-    nodeT start, finish;
-    double distance = 0;
+    static TreeCache cache;
+    SpatialIndex &index = MapIndex(pathF);
     
-    Path pathFinder;
+    if (index.size() == 0) {
+        cout << "Please load a map first." << endl;
+        return;
+    }
     
-    pathFinder.SetStart(start);
-    pathFinder.SetFinish(finish);
+    Path pathFinder;
+    searchStatsT stats;
+    SearchControl control;
+    pathFinder.SetMap(pathF);
+    pathFinder.SetCache(cache);
+    pathFinder.SetComponents(MapComponents(pathF));
+    pathFinder.SetStats(stats);
+    pathFinder.SetControl(control);
+    
+    pathFinder.SetStart(GetNodeFromClick(index, "Click on starting location..."));
+    pathFinder.SetFinish(GetNodeFromClick(index, "Click on destination..."));
+    
+    StartQueryControl(control);
+    bool found = pathFinder.Exists();
+    if (ReportStoppedSearch(control)) return;
+    if (!found) {
+        cout << "There is no path between those locations." << endl;
+        return;
+    }
     
-    pathFinder.toString();
+    Vector<arcT *> arcs = pathFinder.GetArcs();
+    foreach (arcT *arc in arcs) {
+        DrawPathfinderArc(arc->start->loc, arc->finish->loc, HIGHLIGHT_COLOR);
+    }
+    UpdatePathfinderDisplay();
     
-    distance  = pathFinder.GetDistance();
+    cout << pathFinder.toString() << endl;
+    cout << "Total distance: " << pathFinder.GetDistance() << endl;
+    cout << "Search: " << SearchStatsToString(stats) << endl;
 }
 
-
+/**
+ * Asks the user to click on two locations and draws the NUM_ALTERNATIVES
+ * shortest routes between them, each in its own color. The routes are drawn
+ * from the longest to the shortest, so where they overlap the shortest one
+ * stays on top in the highlight color. If the search is stopped early, the
+ * routes found by then are still drawn
+ *
+ * @param the graph with all the nodes and arcs
+ * @return void
+ */
+void FindAlternatives(Graph<nodeT,arcT> &pathF){
     
+    SpatialIndex &index = MapIndex(pathF);
+    
+    if (index.size() == 0) {
+        cout << "Please load a map first." << endl;
+        return;
+    }
+    
+    nodeT *start = GetNodeFromClick(index, "Click on starting location...");
+    nodeT *finish = GetNodeFromClick(index, "Click on destination...");
+    SearchControl control;
+    StartQueryControl(control);
+    Vector<Path> routes = KShortestPaths(pathF, start, finish, NUM_ALTERNATIVES,
+                                         &MapComponents(pathF), NULL, &control);
+    
+    if (ReportStoppedSearch(control) && routes.isEmpty()) return;
+    if (routes.isEmpty()) {
+        cout << "There is no path between those locations." << endl;
+        return;
+    }
+    
+    for (int i = routes.size() - 1; i >= 0; i--) {
+        Vector<arcT *> arcs = routes[i].GetArcs();
+        foreach (arcT *arc in arcs) {
+            DrawPathfinderArc(arc->start->loc, arc->finish->loc, ALTERNATIVE_COLORS[i]);
+        }
+    }
+    UpdatePathfinderDisplay();
+    
+    for (int i = 0; i < routes.size(); i++) {
+        cout << ALTERNATIVE_COLORS[i] << ": " << routes[i].toString() << endl;
+        cout << "Total distance: " << routes[i].GetDistance() << endl;
+    }
+}
 
+/**
+ * Draws a minimum spanning tree of the map in the highlight color, which is
+ * the cheapest set of roads that keeps every location reachable. A map with
+ * several islands gets one tree for each of them.
+ *
+ * @param the graph with all the nodes and arcs
+ * @return void
+ */
+void FindMST(Graph<nodeT,arcT> &pathF){
+    
+    if (pathF.size() == 0) {
+        cout << "Please load a map first." << endl;
+        return;
+    }
+    
+    Vector<arcT *> tree;
+    double total = MinimumSpanningForest(pathF, tree);
+    foreach (arcT *arc in tree) {
+        DrawPathfinderArc(arc->start->loc, arc->finish->loc, HIGHLIGHT_COLOR);
+    }
+    UpdatePathfinderDisplay();
+    
+    cout << "Total distance: " << total << endl;
+}
 
+/**
+ * Helper function that returns the spatial index of the map. The index is
+ * attached to the graph the first time it is needed and follows the graph
+ * from then on, so every button shares the same one.
+ *
+ * @param the graph with all the nodes and arcs
+ * @return the spatial index of the graph
+ */
+SpatialIndex &MapIndex(Graph<nodeT,arcT> &pathF){
+    
+    static SpatialIndex index(pathF);
+    return index;
+}
 
+/**
+ * Helper function that returns the component index of the map, which lets
+ * the searches reject two locations on different islands without looking
+ * at the map. Like the spatial index, it is attached to the graph the first
+ * time it is needed and follows the graph from then on.
+ *
+ * @param the graph with all the nodes and arcs
+ * @return the component index of the graph
+ */
+ComponentIndex &MapComponents(Graph<nodeT,arcT> &pathF){
+    
+    static ComponentIndex components(pathF);
+    return components;
+}
 
+/**
+ * Helper function that waits for a mouse click and returns the location
+ * closest to it, which it highlights on the map
+ *
+ * @param the spatial index of the graph and the prompt to print
+ * @return the node nearest to the click
+ */
+nodeT *GetNodeFromClick(SpatialIndex &index, string prompt){
+    
+    cout << prompt << endl;
+    nodeT *node = index.nearest(GetMouseClick());
+    DrawPathfinderNode(node->loc, HIGHLIGHT_COLOR, node->name);
+    UpdatePathfinderDisplay();
+    cout << node->name << endl;
+    return node;
+}
 
+/**
+ * Helper function that prepares the control for a query: the search gives up
+ * after QUERY_TIME_LIMIT seconds, and a click while it runs cancels it. The
+ * event loop cannot see the mouse while a search runs, so the control polls
+ * the mouse button itself
+ *
+ * @param the control to prepare
+ * @return void
+ */
+void StartQueryControl(SearchControl &control){
+    
+    control.reset();
+    control.setTimeLimit(QUERY_TIME_LIMIT);
+    control.setPollFunction(CancelOnClick);
+}
 
+/**
+ * Poll function for the query control, which cancels the search as soon as
+ * the mouse button goes down
+ *
+ * @param the control of the running search
+ * @return void
+ */
+void CancelOnClick(SearchControl &control){
+    
+    if (MouseButtonIsDown()) control.cancel();
+}
 
-
-
-
-
-
-
-
-
-
-
-
+/**
+ * Helper function that tells the user why a search stopped early and what it
+ * learned before stopping. The click that cancelled a search is swallowed
+ * here, so that the event loop does not treat it as a new click
+ *
+ * @param the control of the search
+ * @return true if the search was stopped early
+ */
+bool ReportStoppedSearch(SearchControl &control){
+    
+    if (control.getStatus() == SEARCH_COMPLETE) return false;
+    if (control.getStatus() == SEARCH_CANCELLED) {
+        WaitForMouseUp();
+        cout << "The search was cancelled." << endl;
+    } else {
+        cout << "The search was stopped after " << QUERY_TIME_LIMIT
+             << " seconds." << endl;
+    }
+    cout << "Any route not shown is at least " << control.getBound()
+         << " long." << endl;
+    return true;
+}
@@ -0,0 +1,95 @@
+/*
+ * File: searchcontrol.cpp
+ * -----------------------
+ * This file implements the searchcontrol.h interface.
+ */
+
+#include "genlib.h"
+#include "searchcontrol.h"
+#include "searchstats.h"
+
+SearchControl::SearchControl() {
+	deadline = 0;
+	cancelled = false;
+	status = SEARCH_COMPLETE;
+	bound = 0;
+	pollFn = NULL;
+}
+
+SearchControl::~SearchControl() {
+	/* Empty */
+}
+
+void SearchControl::setTimeLimit(double seconds) {
+	deadline = SearchClock() + seconds;
+}
+
+void SearchControl::setDeadline(double time) {
+	deadline = time;
+}
+
+void SearchControl::clearDeadline() {
+	deadline = 0;
+}
+
+double SearchControl::getDeadline() {
+	return deadline;
+}
+
+void SearchControl::cancel() {
+	cancelled = true;
+}
+
+bool SearchControl::isCancelled() {
+	return cancelled;
+}
+
+void SearchControl::reset() {
+	cancelled = false;
+	deadline = 0;
+	status = SEARCH_COMPLETE;
+	bound = 0;
+}
+
+void SearchControl::setPollFunction(void (*fn)(SearchControl & control)) {
+	pollFn = fn;
+}
+
+searchStatusT SearchControl::getStatus() {
+	return status;
+}
+
+double SearchControl::getBound() {
+	return bound;
+}
+
+void SearchControl::begin() {
+	status = SEARCH_COMPLETE;
+	bound = 0;
+}
+
+/*
+ * Implementation notes: check
+ * ---------------------------
+ * Cancellation is tested before the deadline, since a search that was
+ * both cancelled and late was abandoned by its client, and the clock
+ * is read only if there is a deadline.
+ */
+
+bool SearchControl::check(double bound) {
+	if (pollFn != NULL) pollFn(*this);
+	searchStatusT reason = SEARCH_COMPLETE;
+	if (cancelled) {
+		reason = SEARCH_CANCELLED;
+	} else if (deadline != 0 && SearchClock() >= deadline) {
+		reason = SEARCH_TIMED_OUT;
+	}
+	if (reason == SEARCH_COMPLETE) return false;
+	this->bound = bound;
+	status = reason;
+	return true;
+}
+
+bool SearchControl::isStopped() {
+	return status != SEARCH_COMPLETE;
+}
@@ -0,0 +1,194 @@
+/*
+ * File: searchcontrol.h
+ * ---------------------
+ * This file provides the interface to the SearchControl class, which
+ * lets a client stop a search before it finishes.  A search for a node
+ * that cannot be reached, or a search over the whole of a large map,
+ * can run for seconds, and while it runs an interactive program cannot
+ * respond to its user and a server cannot answer other requests.  A
+ * SearchControl carries a deadline and a cancellation flag.  Every
+ * engine accepts one as an option and checks it each time it has
+ * settled SEARCH_CHECK_INTERVAL more nodes; when the deadline has
+ * passed or the flag is set, the engine stops and returns what it has
+ * found so far.  The control then reports why the search stopped and
+ * a lower bound on the distances the search had not yet determined.
+ */
+
+#ifndef _searchcontrol_h
+#define _searchcontrol_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+
+/*
+ * Type: searchStatusT
+ * -------------------
+ * This type describes how the last search run under a control ended:
+ *
+ *   SEARCH_COMPLETE   The search ran to its normal end.
+ *   SEARCH_CANCELLED  The search stopped because the control was
+ *                     cancelled.
+ *   SEARCH_TIMED_OUT  The search stopped because its deadline passed.
+ */
+
+enum searchStatusT { SEARCH_COMPLETE, SEARCH_CANCELLED, SEARCH_TIMED_OUT };
+
+/*
+ * Constant: SEARCH_CHECK_INTERVAL
+ * -------------------------------
+ * The number of nodes an engine settles between checks of its control.
+ * A check reads the clock, which costs far more than settling a node,
+ * so checking at this interval adds nothing measurable to a search
+ * while still stopping it within a millisecond or so of the deadline.
+ */
+
+const int SEARCH_CHECK_INTERVAL = 4096;
+
+/*
+ * Class: SearchControl
+ * --------------------
+ * This class holds the conditions under which a search must stop and
+ * records the outcome of the last search run under it.  A client
+ * typically keeps one control for each query or each request:
+ *
+ *     SearchControl control;
+ *     control.setTimeLimit(0.5);
+ *     DijkstraDistances(graph, source, dist, AUTO_QUEUE, NULL, &control);
+ *     if (control.getStatus() != SEARCH_COMPLETE) . . .
+ *
+ * The cancel method may be called by another thread while a search is
+ * running.  A client that runs on a single thread, such as the event
+ * loop of the Pathfinder application, can instead supply a poll
+ * function, which each check calls and which may call cancel.
+ */
+
+class SearchControl {
+public:
+
+/*
+ * Constructor: SearchControl
+ * Usage: SearchControl control;
+ * -----------------------------
+ * Creates a control with no deadline and no poll function that has not
+ * been cancelled.
+ */
+	SearchControl();
+
+/*
+ * Destructor: ~SearchControl
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees the storage associated with this control.
+ */
+	~SearchControl();
+
+/*
+ * Methods: setTimeLimit, setDeadline, clearDeadline, getDeadline
+ * Usage: control.setTimeLimit(seconds);
+ *        control.setDeadline(time);
+ *        control.clearDeadline();
+ *        double time = control.getDeadline();
+ * --------------------------------------------------------------
+ * These methods set and read the time after which searches stop.  The
+ * setTimeLimit method sets the deadline to the given number of seconds
+ * from now.  The setDeadline method sets it to a time measured by
+ * SearchClock, as described in searchstats.h, which suits a server
+ * that fixes the deadline of a request when the request arrives and
+ * then runs several searches for it.  The deadline applies to every
+ * later search until it is cleared; getDeadline returns 0 if there is
+ * none.
+ */
+	void setTimeLimit(double seconds);
+	void setDeadline(double time);
+	void clearDeadline();
+	double getDeadline();
+
+/*
+ * Methods: cancel, isCancelled, reset
+ * Usage: control.cancel();
+ *        if (control.isCancelled()) . . .
+ *        control.reset();
+ * ------------------------------------
+ * The cancel method asks any search running under this control, and
+ * every later one, to stop at its next check.  Cancelling stays in
+ * effect until reset is called, so a request that has been abandoned
+ * cannot start new work by accident.  The reset method clears the
+ * cancellation and the deadline, leaving the poll function in place.
+ */
+	void cancel();
+	bool isCancelled();
+	void reset();
+
+/*
+ * Method: setPollFunction
+ * Usage: control.setPollFunction(fn);
+ * -----------------------------------
+ * Asks every check to call fn(control) before testing whether the
+ * search should stop.  The function may call cancel, for example when
+ * it finds that the user has pressed the mouse button.  Passing NULL
+ * removes the poll function.
+ */
+	void setPollFunction(void (*fn)(SearchControl & control));
+
+/*
+ * Methods: getStatus, getBound
+ * Usage: searchStatusT status = control.getStatus();
+ *        double bound = control.getBound();
+ * --------------------------------------------------
+ * These methods describe the last search run under this control.  If
+ * the search was stopped, getBound returns the best lower bound it had
+ * found: every node whose distance is less than the bound was settled
+ * with its exact distance, and every distance the search did not
+ * report is at least the bound.  A point-to-point search reports a
+ * lower bound on the distance to its finish.  The bound is 0 if the
+ * search ran to completion.
+ */
+	searchStatusT getStatus();
+	double getBound();
+
+/*
+ * Methods: begin, check, isStopped
+ * Usage: control.begin();
+ *        if (control.check(bound)) . . .
+ *        if (control.isStopped()) . . .
+ * ---------------------------------------
+ * These methods are called by the engines rather than by clients.
+ * The begin method marks the start of a query, setting the status to
+ * SEARCH_COMPLETE.  The check method calls the poll function, tests
+ * the cancellation flag and the deadline, and if the search must stop,
+ * records the reason and the bound passed to it and returns true.
+ * Engines that run several searches for a query call isStopped to
+ * avoid starting more of them once one has been stopped.
+ */
+	void begin();
+	bool check(double bound);
+	bool isStopped();
+
+private:
+
+/*
+ * Implementation notes: threads
+ * -----------------------------
+ * The cancellation flag and the status are declared volatile so that
+ * a search notices a change made by another thread at its next check
+ * rather than keeping a stale copy in a register.  Each is a single
+ * word written with a single store, so no lock is needed.  Engines
+ * whose threads share a control record the same bound from each of
+ * them, so it does not matter which thread stops first.
+ */
+
+/* Instance variables */
+
+	double deadline;                        /* 0 if there is none      */
+	volatile bool cancelled;                /* Set by cancel           */
+	volatile searchStatusT status;          /* Outcome of last search  */
+	double bound;                           /* Bound when stopped      */
+	void (*pollFn)(SearchControl & control);
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(SearchControl)
+
+};
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * File: searchspace.cpp
+ * ---------------------
+ * This file implements the searchspace.h interface.
+ */
+
+#include <climits>
+#include "genlib.h"
+#include "searchspace.h"
+
+SearchSpace::SearchSpace() {
+	generation = 0;
+	nReached = 0;
+	nSettled = 0;
+	nImproved = 0;
+	graphVersion = 0;
+	graphKind = BINARY_HEAP;
+	graphMaxArc = 0;
+}
+
+SearchSpace::~SearchSpace() {
+	/* Empty */
+}
+
+/*
+ * Implementation notes: reset
+ * ---------------------------
+ * New entries are added to the arrays with stamp 0, which is older
+ * than any generation that reset hands out.  Calling setKind on the
+ * queue with an unchanged representation simply empties it, keeping
+ * the storage the queue has already grown.
+ */
+
+void SearchSpace::reset(Graph<nodeT,arcT> & graph) {
+	if (graph.getVersion() != graphVersion) {
+		graphKind = ChooseQueueKind(graph, graphMaxArc);
+		graphVersion = graph.getVersion();
+	}
+	reset(graph.size(), graphKind, graphMaxArc);
+}
+
+void SearchSpace::reset(int nNodes, queueKindT kind, double maxArc) {
+	while (stamp.size() < nNodes) {
+		dist.add(UNREACHABLE);
+		parent.add(NULL);
+		stamp.add(0);
+	}
+	if (generation >= INT_MAX / 2 - 1) {
+		for (int i = 0; i < stamp.size(); i++) {
+			stamp[i] = 0;
+		}
+		generation = 0;
+	}
+	generation++;
+	nReached = 0;
+	nSettled = 0;
+	nImproved = 0;
+	queue.setKind(kind, maxArc);
+}
+
+double SearchSpace::getDistance(int index) {
+	if (stamp[index] < 2 * generation) return UNREACHABLE;
+	return dist[index];
+}
+
+arcT *SearchSpace::getParentArc(int index) {
+	if (stamp[index] < 2 * generation) return NULL;
+	return parent[index];
+}
+
+void SearchSpace::setDistance(int index, double newDist, arcT *parentArc) {
+	if (stamp[index] < 2 * generation) {
+		stamp[index] = 2 * generation;
+		nReached++;
+	} else {
+		nImproved++;
+	}
+	dist[index] = newDist;
+	parent[index] = parentArc;
+}
+
+bool SearchSpace::isSettled(int index) {
+	return stamp[index] == 2 * generation + 1;
+}
+
+void SearchSpace::settle(int index) {
+	if (stamp[index] < 2 * generation) {
+		Error("settle: Node has not been reached");
+	}
+	if (stamp[index] == 2 * generation) nSettled++;
+	stamp[index] = 2 * generation + 1;
+}
+
+DistanceQueue & SearchSpace::getQueue() {
+	return queue;
+}
+
+int SearchSpace::getReachedCount() {
+	return nReached;
+}
+
+int SearchSpace::getSettledCount() {
+	return nSettled;
+}
+
+/*
+ * Implementation notes: fillStats
+ * -------------------------------
+ * Each reached node has written one entry in each of the three arrays,
+ * and the rest of the arrays are untouched by the search.
+ */
+
+void SearchSpace::fillStats(searchStatsT & stats) {
+	stats.settled = nSettled;
+	stats.pushes = queue.getPushCount();
+	stats.pops = queue.getPopCount();
+	stats.decreaseKeys = nImproved;
+	stats.peakFrontier = queue.getPeakSize();
+	stats.bytesTouched = long(nReached) * (sizeof(double) + sizeof(arcT *)
+	                                       + sizeof(int))
+	                   + long(stats.peakFrontier) * sizeof(queueEntryT);
+}
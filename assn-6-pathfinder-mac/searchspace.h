@@ -0,0 +1,179 @@
+/*
+ * File: searchspace.h
+ * -------------------
+ * This file provides the interface to the SearchSpace class, which
+ * holds the working storage for a shortest-path search: the tentative
+ * distance to each node, the arc through which each node was reached,
+ * the set of nodes that have been settled, and the priority queue.
+ * A client that runs many searches over the same graph keeps a single
+ * SearchSpace and passes it to each search, which then allocates no
+ * memory once the arrays have grown to the size of the graph.
+ */
+
+#ifndef _searchspace_h
+#define _searchspace_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+#include "distqueue.h"
+#include "sssp.h"
+#include "searchstats.h"
+
+/*
+ * Class: SearchSpace
+ * ------------------
+ * This class stores per-node search state in arrays indexed by the
+ * index field of the nodes.  Rather than clearing those arrays at the
+ * start of every search, which would make each query cost time
+ * proportional to the size of the graph, the class keeps a generation
+ * number that is incremented by reset.  Each node carries a stamp that
+ * records the generation in which it was last touched, so any node
+ * whose stamp is out of date is treated as unreached.  As a result,
+ * the cost of a search depends only on the part of the graph that it
+ * actually explores.
+ */
+
+class SearchSpace {
+public:
+
+/*
+ * Constructor: SearchSpace
+ * Usage: SearchSpace space;
+ * -------------------------
+ * Initializes an empty search space.  The arrays are allocated by the
+ * first call to reset.
+ */
+	SearchSpace();
+
+/*
+ * Destructor: ~SearchSpace
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees the storage associated with this search space.
+ */
+	~SearchSpace();
+
+/*
+ * Method: reset
+ * Usage: space.reset(graph);
+ *        space.reset(nNodes, kind, maxArc);
+ * -----------------------------------------
+ * Begins a new search, after which every node is unreached and the
+ * queue is empty.  In the first form, the search space chooses the
+ * queue representation for the graph by calling ChooseQueueKind.
+ * That choice requires a pass over every arc, so it is remembered and
+ * made again only when the version of the graph changes, as described
+ * in graph.h.  In the second form, the client supplies the number of
+ * nodes and the queue representation, as described in distqueue.h;
+ * AUTO_QUEUE is not allowed there.  Unless the arrays must grow or the
+ * queue representation changes, reset takes constant time, even when
+ * the previous search was stopped early and left its queue full.
+ */
+	void reset(Graph<nodeT,arcT> & graph);
+	void reset(int nNodes, queueKindT kind = BINARY_HEAP, double maxArc = 0);
+
+/*
+ * Method: getDistance
+ * Usage: double dist = space.getDistance(index);
+ * ----------------------------------------------
+ * Returns the tentative distance to the node with the specified index,
+ * or UNREACHABLE if the current search has not reached it.
+ */
+	double getDistance(int index);
+
+/*
+ * Method: getParentArc
+ * Usage: arcT *arc = space.getParentArc(index);
+ * ---------------------------------------------
+ * Returns the arc through which the current search reached the node
+ * with the specified index, or NULL if the node is the source or has
+ * not been reached.
+ */
+	arcT *getParentArc(int index);
+
+/*
+ * Method: setDistance
+ * Usage: space.setDistance(index, dist, parentArc);
+ * -------------------------------------------------
+ * Records a new tentative distance for the node with the specified
+ * index, along with the arc through which it was reached.
+ */
+	void setDistance(int index, double dist, arcT *parentArc);
+
+/*
+ * Methods: isSettled, settle
+ * Usage: if (space.isSettled(index)) . . .
+ *        space.settle(index);
+ * ---------------------------------------
+ * These methods test and set the flag indicating that the distance to
+ * a node is final.  Only a node that has been reached can be settled.
+ */
+	bool isSettled(int index);
+	void settle(int index);
+
+/*
+ * Method: getQueue
+ * Usage: DistanceQueue & queue = space.getQueue();
+ * ------------------------------------------------
+ * Returns the priority queue used by the current search.
+ */
+	DistanceQueue & getQueue();
+
+/*
+ * Methods: getReachedCount, getSettledCount
+ * Usage: int n = space.getReachedCount();
+ *        int n = space.getSettledCount();
+ * ---------------------------------------
+ * These methods return the number of nodes reached and settled by the
+ * current search, which measure the work it has done.
+ */
+	int getReachedCount();
+	int getSettledCount();
+
+/*
+ * Method: fillStats
+ * Usage: space.fillStats(stats);
+ * ------------------------------
+ * Stores the counts that the search space keeps for the current search
+ * in the settled, pushes, pops, decreaseKeys, peakFrontier, and
+ * bytesTouched fields of stats, leaving the other fields unchanged.
+ * A call to setDistance for a node that has already been reached
+ * counts as a decrease-key.
+ */
+	void fillStats(searchStatsT & stats);
+
+private:
+
+/*
+ * Implementation notes: stamps
+ * ----------------------------
+ * A node is reached in the current generation g if its stamp is at
+ * least 2g and is settled if its stamp is 2g + 1, so a single array
+ * serves both purposes.  When the generation counter is about to
+ * overflow, reset clears the stamps and starts again at 1.
+ */
+
+/* Instance variables */
+
+	Vector<double> dist;
+	Vector<arcT *> parent;
+	Vector<int> stamp;
+	int generation;
+	int nReached;
+	int nSettled;
+	long nImproved;
+	DistanceQueue queue;
+	long graphVersion;                     /* Graph seen by reset(graph) */
+	queueKindT graphKind;                  /* The queue chosen for it    */
+	double graphMaxArc;
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(SearchSpace)
+
+};
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * File: searchstats.cpp
+ * ---------------------
+ * This file implements the searchstats.h interface.
+ */
+
+#include <sstream>
+#include <sys/time.h>
+#include "genlib.h"
+#include "searchstats.h"
+
+void ClearSearchStats(searchStatsT & stats) {
+	stats.settled = 0;
+	stats.relaxed = 0;
+	stats.pushes = 0;
+	stats.pops = 0;
+	stats.decreaseKeys = 0;
+	stats.peakFrontier = 0;
+	stats.bytesTouched = 0;
+	stats.setupTime = 0;
+	stats.searchTime = 0;
+	stats.pathTime = 0;
+}
+
+void AddSearchStats(searchStatsT & total, searchStatsT & stats) {
+	total.settled += stats.settled;
+	total.relaxed += stats.relaxed;
+	total.pushes += stats.pushes;
+	total.pops += stats.pops;
+	total.decreaseKeys += stats.decreaseKeys;
+	if (stats.peakFrontier > total.peakFrontier) {
+		total.peakFrontier = stats.peakFrontier;
+	}
+	if (stats.bytesTouched > total.bytesTouched) {
+		total.bytesTouched = stats.bytesTouched;
+	}
+	total.setupTime += stats.setupTime;
+	total.searchTime += stats.searchTime;
+	total.pathTime += stats.pathTime;
+}
+
+double SearchClock() {
+	timeval now;
+	gettimeofday(&now, NULL);
+	return now.tv_sec + now.tv_usec / 1e6;
+}
+
+/*
+ * Implementation notes: SearchStatsToString, SearchStatsToJSON
+ * ------------------------------------------------------------
+ * The times are converted to milliseconds, which suits the queries on
+ * the maps that come with the assignment as well as the large ones.
+ */
+
+string SearchStatsToString(searchStatsT & stats) {
+	ostringstream out;
+	out << stats.settled << " settled, " << stats.relaxed << " relaxed, "
+	    << stats.pushes << " pushes (" << stats.decreaseKeys
+	    << " decrease-keys), " << stats.pops << " pops, peak frontier "
+	    << stats.peakFrontier << ", " << stats.bytesTouched << " bytes; "
+	    << stats.setupTime * 1e3 << " + " << stats.searchTime * 1e3
+	    << " + " << stats.pathTime * 1e3 << " ms";
+	return out.str();
+}
+
+string SearchStatsToJSON(searchStatsT & stats) {
+	ostringstream out;
+	out << "{\"settled\": " << stats.settled
+	    << ", \"relaxed\": " << stats.relaxed
+	    << ", \"pushes\": " << stats.pushes
+	    << ", \"pops\": " << stats.pops
+	    << ", \"decreaseKeys\": " << stats.decreaseKeys
+	    << ", \"peakFrontier\": " << stats.peakFrontier
+	    << ", \"bytesTouched\": " << stats.bytesTouched
+	    << ", \"setupMs\": " << stats.setupTime * 1e3
+	    << ", \"searchMs\": " << stats.searchTime * 1e3
+	    << ", \"pathMs\": " << stats.pathTime * 1e3 << "}";
+	return out.str();
+}
@@ -0,0 +1,91 @@
+/*
+ * File: searchstats.h
+ * -------------------
+ * This interface exports a record in which the search engines report
+ * the work done by a query.  When a route takes longer than expected,
+ * the record shows whether the search settled too many nodes, spent
+ * its time in the priority queue, or lost it elsewhere.  Every engine
+ * takes the record as an option: a client that does not supply one
+ * pays for a few counters kept in registers and nothing else, since
+ * the clock is read only when a record has been supplied.
+ */
+
+#ifndef _searchstats_h
+#define _searchstats_h
+
+#include "genlib.h"
+
+/*
+ * Type: searchStatsT
+ * ------------------
+ * This type holds the statistics of one query.  The engines use lazy
+ * deletion instead of a decrease-key operation, so decreaseKeys counts
+ * the pushes that lowered the distance of a node already in the queue,
+ * each of which leaves a stale entry behind.  The bytesTouched field
+ * estimates the working storage written by the search, counting the
+ * per-node arrays only for the nodes the search reached when it uses
+ * a SearchSpace.  The three times are in seconds: setup covers
+ * preparing the workspace, search covers the main loop, and path
+ * covers reading back the route.
+ */
+
+struct searchStatsT {
+	int settled;         /* Nodes whose distance became final          */
+	long relaxed;        /* Arcs examined from settled nodes           */
+	long pushes;         /* Entries added to the priority queue        */
+	long pops;           /* Entries removed from the priority queue    */
+	long decreaseKeys;   /* Pushes that improved a pending distance    */
+	int peakFrontier;    /* Largest number of entries in the queue     */
+	long bytesTouched;   /* Estimated bytes of workspace written       */
+	double setupTime;    /* Seconds spent preparing the search         */
+	double searchTime;   /* Seconds spent in the main loop             */
+	double pathTime;     /* Seconds spent reading back the route       */
+};
+
+/*
+ * Function: ClearSearchStats
+ * Usage: ClearSearchStats(stats);
+ * -------------------------------
+ * Sets every field of stats to 0.
+ */
+
+void ClearSearchStats(searchStatsT & stats);
+
+/*
+ * Function: AddSearchStats
+ * Usage: AddSearchStats(total, stats);
+ * ------------------------------------
+ * Adds the fields of stats to those of total, which is how an engine
+ * that runs several searches reports them together.  The peak frontier
+ * and the bytes touched are combined by taking the larger value, since
+ * the searches reuse the same storage.
+ */
+
+void AddSearchStats(searchStatsT & total, searchStatsT & stats);
+
+/*
+ * Function: SearchClock
+ * Usage: double start = SearchClock();
+ * ------------------------------------
+ * Returns the current wall-clock time in seconds, measured from an
+ * arbitrary starting point.  The engines take the difference of two
+ * readings to compute the times in a searchStatsT.
+ */
+
+double SearchClock();
+
+/*
+ * Functions: SearchStatsToString, SearchStatsToJSON
+ * Usage: cout << SearchStatsToString(stats) << endl;
+ *        out << SearchStatsToJSON(stats) << endl;
+ * -------------------------------------------------
+ * These functions format stats for people and for programs.  The
+ * string form fits on one console line.  The JSON form is an object on
+ * a single line with one member per field, so that a trace of many
+ * queries can be written as JSON lines, one query per line.
+ */
+
+string SearchStatsToString(searchStatsT & stats);
+string SearchStatsToJSON(searchStatsT & stats);
+
+#endif
@@ -0,0 +1,391 @@
+/*
+ * File: snapshot.cpp
+ * ------------------
+ * This file implements the snapshot.h interface.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <pthread.h>
+#include "genlib.h"
+#include "snapshot.h"
+#include "sssp.h"
+
+/* Private function prototypes */
+
+static int AtomicAdd(int & value, int delta);
+static bool IsFractional(double distance);
+
+/*
+ * Implementation notes: GraphSnapshot
+ * -----------------------------------
+ * The arrays of the topology are read through pointers to their first
+ * elements, which keeps the bounds checks of the Vector class out of
+ * the inner loop of a search.  A closed arc is stored with the distance
+ * UNREACHABLE and skipped by getArcs.
+ */
+
+GraphSnapshot::GraphSnapshot() {
+	topology = NULL;
+	version = 0;
+	nonIntegral = 0;
+	maxArcBound = 0;
+	pins = 0;
+}
+
+GraphSnapshot::~GraphSnapshot() {
+	/* Empty */
+}
+
+int GraphSnapshot::size() {
+	return topology->nNodes;
+}
+
+int GraphSnapshot::getArcCount() {
+	return topology->nArcs;
+}
+
+int GraphSnapshot::getMaxDegree() {
+	return topology->maxDegree;
+}
+
+long GraphSnapshot::getVersion() {
+	return version;
+}
+
+int GraphSnapshot::findArc(arcT *arc) {
+	int index = arc->start->index;
+	if (index < 0 || index >= topology->nNodes) return -1;
+	for (int id = topology->offsets[index]; id < topology->offsets[index + 1];
+	     id++) {
+		if (topology->arcs[id] == arc) return id;
+	}
+	return -1;
+}
+
+arcT *GraphSnapshot::getArc(int id) {
+	return topology->arcs[id];
+}
+
+double GraphSnapshot::getArcDistance(int id) {
+	if (id < 0 || id >= topology->nArcs) {
+		Error("getArcDistance: Arc number out of range");
+	}
+	return chunks[id / SNAPSHOT_CHUNK_SIZE]->distance[id % SNAPSHOT_CHUNK_SIZE];
+}
+
+bool GraphSnapshot::isArcClosed(int id) {
+	return getArcDistance(id) == UNREACHABLE;
+}
+
+int GraphSnapshot::getArcs(int index, compactArcT arcs[]) {
+	int first = topology->offsets[index];
+	int last = topology->offsets[index + 1];
+	if (first == last) return 0;
+	const int *finish = &topology->finish[0];
+	chunkT * const *table = &chunks[0];
+	int n = 0;
+	for (int id = first; id < last; id++) {
+		double d = table[id / SNAPSHOT_CHUNK_SIZE]
+		           ->distance[id % SNAPSHOT_CHUNK_SIZE];
+		if (d == UNREACHABLE) continue;
+		arcs[n].finish = finish[id];
+		arcs[n].distance = d;
+		n++;
+	}
+	return n;
+}
+
+bool GraphSnapshot::isIntegral() {
+	return nonIntegral == 0;
+}
+
+double GraphSnapshot::getMaxArcBound() {
+	return maxArcBound;
+}
+
+/*
+ * Private method: setDistance
+ * Usage: setDistance(id, distance);
+ * ---------------------------------
+ * Changes the distance of an arc in a version that has not yet been
+ * published.  If the chunk holding the arc is shared with any other
+ * version, it is copied first.  A chunk whose reference count is 1 can
+ * belong only to this version, because the version it was copied from
+ * is still current and therefore still holds every chunk it shares.
+ */
+
+void GraphSnapshot::setDistance(int id, double distance) {
+	int index = id / SNAPSHOT_CHUNK_SIZE;
+	chunkT *chunk = chunks[index];
+	if (AtomicAdd(chunk->refCount, 0) != 1) {
+		chunkT *copy = new chunkT;
+		memcpy(copy->distance, chunk->distance, sizeof chunk->distance);
+		copy->refCount = 1;
+		if (AtomicAdd(chunk->refCount, -1) == 0) delete chunk;
+		chunks[index] = copy;
+		chunk = copy;
+	}
+	double &slot = chunk->distance[id % SNAPSHOT_CHUNK_SIZE];
+	if (slot != UNREACHABLE && IsFractional(slot)) nonIntegral--;
+	if (distance != UNREACHABLE) {
+		if (IsFractional(distance)) nonIntegral++;
+		if (distance > maxArcBound) maxArcBound = distance;
+	}
+	slot = distance;
+}
+
+SnapshotUpdate::SnapshotUpdate() {
+	/* Empty */
+}
+
+SnapshotUpdate::~SnapshotUpdate() {
+	/* Empty */
+}
+
+void SnapshotUpdate::setArcWeight(arcT *arc, double distance) {
+	if (distance < 0) Error("setArcWeight: Negative arc distance");
+	arcs.add(arc);
+	distances.add(distance);
+}
+
+void SnapshotUpdate::closeArc(arcT *arc) {
+	arcs.add(arc);
+	distances.add(UNREACHABLE);
+}
+
+int SnapshotUpdate::size() {
+	return arcs.size();
+}
+
+void SnapshotUpdate::clear() {
+	arcs.clear();
+	distances.clear();
+}
+
+SnapshotStore::SnapshotStore() {
+	current = NULL;
+	lastVersion = 0;
+	nLive = 0;
+	pthread_mutex_init(&pinLock, NULL);
+	pthread_mutex_init(&writeLock, NULL);
+}
+
+SnapshotStore::SnapshotStore(Graph<nodeT,arcT> & graph) {
+	current = NULL;
+	lastVersion = 0;
+	nLive = 0;
+	pthread_mutex_init(&pinLock, NULL);
+	pthread_mutex_init(&writeLock, NULL);
+	build(graph);
+}
+
+SnapshotStore::~SnapshotStore() {
+	if (current != NULL) destroy(current);
+	pthread_mutex_destroy(&pinLock);
+	pthread_mutex_destroy(&writeLock);
+}
+
+/*
+ * Implementation notes: build
+ * ---------------------------
+ * The arcs are numbered by walking the nodes in index order, so the
+ * arcs leaving each node occupy a consecutive range of numbers.  The
+ * graph is read before the write lock is taken, since only the graph's
+ * owner may be reading it.
+ */
+
+void SnapshotStore::build(Graph<nodeT,arcT> & graph) {
+	GraphSnapshot *snapshot = new GraphSnapshot;
+	GraphSnapshot::topologyT *topology = new GraphSnapshot::topologyT;
+	topology->refCount = 1;
+	topology->nNodes = graph.size();
+	topology->maxDegree = 0;
+	topology->offsets = Vector<int>(graph.size() + 1);
+	for (int i = 0; i < graph.size(); i++) {
+		nodeT *node = graph.getNodeByIndex(i);
+		topology->offsets.add(topology->arcs.size());
+		for (int j = 0; j < node->arcs.size(); j++) {
+			topology->arcs.add(node->arcs[j]);
+			topology->finish.add(node->arcs[j]->finish->index);
+		}
+		if (node->arcs.size() > topology->maxDegree) {
+			topology->maxDegree = node->arcs.size();
+		}
+	}
+	topology->nArcs = topology->arcs.size();
+	topology->offsets.add(topology->nArcs);
+	snapshot->topology = topology;
+	for (int id = 0; id < topology->nArcs; id++) {
+		if (id % SNAPSHOT_CHUNK_SIZE == 0) {
+			GraphSnapshot::chunkT *chunk = new GraphSnapshot::chunkT;
+			memset(chunk->distance, 0, sizeof chunk->distance);
+			chunk->refCount = 1;
+			snapshot->chunks.add(chunk);
+		}
+		double distance = topology->arcs[id]->distance;
+		if (distance < 0) {
+			destroy(snapshot);
+			Error("SnapshotStore: Negative arc distance");
+		}
+		snapshot->setDistance(id, distance);
+	}
+	AtomicAdd(nLive, 1);
+	pthread_mutex_lock(&writeLock);
+	snapshot->version = ++lastVersion;
+	install(snapshot);
+	pthread_mutex_unlock(&writeLock);
+}
+
+/*
+ * Implementation notes: acquire, release
+ * --------------------------------------
+ * The pin count of a version and the pointer to the current version
+ * are changed only while pinLock is held, so exactly one thread sees
+ * a version that is both unpinned and no longer current, and that
+ * thread frees it after releasing the lock.
+ */
+
+GraphSnapshot *SnapshotStore::acquire() {
+	pthread_mutex_lock(&pinLock);
+	GraphSnapshot *snapshot = current;
+	if (snapshot != NULL) snapshot->pins++;
+	pthread_mutex_unlock(&pinLock);
+	if (snapshot == NULL) Error("acquire: No version has been built");
+	return snapshot;
+}
+
+void SnapshotStore::release(GraphSnapshot *snapshot) {
+	pthread_mutex_lock(&pinLock);
+	bool pinned = snapshot->pins > 0;
+	if (pinned) snapshot->pins--;
+	bool unused = pinned && snapshot->pins == 0 && snapshot != current;
+	pthread_mutex_unlock(&pinLock);
+	if (!pinned) Error("release: The snapshot is not pinned");
+	if (unused) destroy(snapshot);
+}
+
+/*
+ * Implementation notes: publish
+ * -----------------------------
+ * The current version cannot be freed while a writer is reading it,
+ * because only a writer holding writeLock can replace it.  Every arc is
+ * looked up before anything is built, so that an invalid update leaves
+ * the store unchanged.
+ */
+
+long SnapshotStore::publish(SnapshotUpdate & update) {
+	pthread_mutex_lock(&writeLock);
+	GraphSnapshot *base = current;
+	if (base == NULL) {
+		pthread_mutex_unlock(&writeLock);
+		Error("publish: No version has been built");
+	}
+	Vector<int> ids(update.size());
+	for (int i = 0; i < update.size(); i++) {
+		int id = base->findArc(update.arcs[i]);
+		if (id < 0) {
+			pthread_mutex_unlock(&writeLock);
+			Error("publish: The arc is not in the snapshot");
+		}
+		ids.add(id);
+	}
+	GraphSnapshot *next = new GraphSnapshot;
+	next->topology = base->topology;
+	AtomicAdd(next->topology->refCount, 1);
+	next->chunks = base->chunks;
+	for (int i = 0; i < next->chunks.size(); i++) {
+		AtomicAdd(next->chunks[i]->refCount, 1);
+	}
+	next->nonIntegral = base->nonIntegral;
+	next->maxArcBound = base->maxArcBound;
+	for (int i = 0; i < ids.size(); i++) {
+		next->setDistance(ids[i], update.distances[i]);
+	}
+	AtomicAdd(nLive, 1);
+	next->version = ++lastVersion;
+	install(next);
+	pthread_mutex_unlock(&writeLock);
+	return next->version;
+}
+
+/*
+ * Implementation notes: getCurrentVersion
+ * ---------------------------------------
+ * The version number is read from the current snapshot under pinLock,
+ * which a writer holds only long enough to install a finished version,
+ * so that a query asking for it never waits while a writer builds one.
+ */
+
+long SnapshotStore::getCurrentVersion() {
+	pthread_mutex_lock(&pinLock);
+	long version = (current == NULL) ? 0 : current->version;
+	pthread_mutex_unlock(&pinLock);
+	return version;
+}
+
+int SnapshotStore::getLiveVersionCount() {
+	return AtomicAdd(nLive, 0);
+}
+
+/*
+ * Private method: install
+ * Usage: install(snapshot);
+ * -------------------------
+ * Makes snapshot the current version and frees the version it replaces
+ * if no query holds it.  The caller must hold writeLock.
+ */
+
+void SnapshotStore::install(GraphSnapshot *snapshot) {
+	pthread_mutex_lock(&pinLock);
+	GraphSnapshot *old = current;
+	current = snapshot;
+	bool unused = old != NULL && old->pins == 0;
+	pthread_mutex_unlock(&pinLock);
+	if (unused) destroy(old);
+}
+
+/*
+ * Private method: destroy
+ * Usage: destroy(snapshot);
+ * -------------------------
+ * Frees a version along with every chunk and topology that no other
+ * version still holds.
+ */
+
+void SnapshotStore::destroy(GraphSnapshot *snapshot) {
+	for (int i = 0; i < snapshot->chunks.size(); i++) {
+		GraphSnapshot::chunkT *chunk = snapshot->chunks[i];
+		if (AtomicAdd(chunk->refCount, -1) == 0) delete chunk;
+	}
+	if (AtomicAdd(snapshot->topology->refCount, -1) == 0) {
+		delete snapshot->topology;
+	}
+	if (snapshot->version != 0) AtomicAdd(nLive, -1);
+	delete snapshot;
+}
+
+/*
+ * Function: AtomicAdd
+ * Usage: int result = AtomicAdd(value, delta);
+ * --------------------------------------------
+ * Adds delta to value as a single atomic operation and returns the
+ * result.  Adding 0 reads the value with the same guarantees.  The
+ * implementation uses the atomic builtins supported by both GCC and
+ * Clang, since the C++ standard this code follows has none.
+ */
+
+static int AtomicAdd(int & value, int delta) {
+	return __sync_add_and_fetch(&value, delta);
+}
+
+/*
+ * Function: IsFractional
+ * Usage: if (IsFractional(distance)) . . .
+ * ----------------------------------------
+ * Returns true if distance is not a whole number.
+ */
+
+static bool IsFractional(double distance) {
+	return distance != floor(distance);
+}
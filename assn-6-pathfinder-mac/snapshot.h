@@ -0,0 +1,347 @@
+/*
+ * File: snapshot.h
+ * ----------------
+ * This file provides the interface to the SnapshotStore class, which
+ * lets arc distances change while other threads are answering queries.
+ * A Graph cannot be shared that way: its Set, BST, and Map members
+ * update internal counters even when they are only read, and their
+ * iterators report an error if the structure changes underneath them.
+ * A SnapshotStore instead holds a series of versions of the arcs of a
+ * graph, each of which is a GraphSnapshot that never changes once it
+ * has been published.  A query pins the current version and searches
+ * it for as long as it likes.  Meanwhile a writer builds the next
+ * version from the current one and publishes it, and each earlier
+ * version is freed as soon as the last query using it is finished.
+ */
+
+#ifndef _snapshot_h
+#define _snapshot_h
+
+#include <pthread.h>
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+#include "compactgraph.h"
+
+/*
+ * Constant: SNAPSHOT_CHUNK_SIZE
+ * -----------------------------
+ * The number of arc distances stored together in one block.  A new
+ * version shares with the previous one every block in which no arc
+ * has changed, so publishing a handful of changes copies only a few
+ * blocks, together with a table holding one pointer per block.
+ */
+
+const int SNAPSHOT_CHUNK_SIZE = 1024;
+
+/*
+ * Class: GraphSnapshot
+ * --------------------
+ * This class represents one published version of the arcs of a graph.
+ * The nodes are identified by the values their index fields had when
+ * the store was built, and the arcs are numbered densely, with the arcs
+ * leaving each node numbered consecutively in the order in which they
+ * appear in its arcs field.  A snapshot is never changed after it has
+ * been published, so any number of threads may read it at once.  The
+ * client obtains snapshots from SnapshotStore and never creates or
+ * deletes them itself.
+ */
+
+class GraphSnapshot {
+public:
+
+/*
+ * Methods: size, getArcCount, getMaxDegree, getVersion
+ * Usage: int nNodes = snapshot.size();
+ *        int nArcs = snapshot.getArcCount();
+ *        int degree = snapshot.getMaxDegree();
+ *        long version = snapshot.getVersion();
+ * ----------------------------------------------
+ * These methods return the number of nodes and arcs, the largest
+ * number of arcs leaving any one node, and the number of the version,
+ * which starts at 1 for the version built from the graph and increases
+ * by one with each version published after it.
+ */
+	int size();
+	int getArcCount();
+	int getMaxDegree();
+	long getVersion();
+
+/*
+ * Methods: findArc, getArc, getArcDistance, isArcClosed
+ * Usage: int id = snapshot.findArc(arc);
+ *        arcT *arc = snapshot.getArc(id);
+ *        double distance = snapshot.getArcDistance(id);
+ *        if (snapshot.isArcClosed(id)) . . .
+ * ---------------------------------------------------
+ * These methods convert between arcs of the graph and their numbers in
+ * the snapshot and return the distance of an arc in this version.  The
+ * findArc method returns -1 if the arc was not in the graph when the
+ * store was built.  A closed arc has the distance UNREACHABLE, defined
+ * in sssp.h.  The arc pointers remain valid only as long as the graph
+ * keeps the arcs.
+ */
+	int findArc(arcT *arc);
+	arcT *getArc(int id);
+	double getArcDistance(int id);
+	bool isArcClosed(int id);
+
+/*
+ * Method: getArcs
+ * Usage: int nArcs = snapshot.getArcs(index, arcs);
+ * -------------------------------------------------
+ * Stores the open arcs leaving the node with the specified index in
+ * the array arcs, which must have room for getMaxDegree entries, and
+ * returns their number.  The arcs come out in the form used by
+ * CompactGraph, so that the search engines treat both alike.
+ */
+	int getArcs(int index, compactArcT arcs[]);
+
+/*
+ * Methods: isIntegral, getMaxArcBound
+ * Usage: if (snapshot.isIntegral()) . . .
+ *        double maxArc = snapshot.getMaxArcBound();
+ * ------------------------------------------------
+ * The isIntegral method returns true if every open arc distance is an
+ * integer.  The getMaxArcBound method returns a number no smaller than
+ * the longest open arc distance.  The bound is kept up to date as arcs
+ * become longer, but it does not fall when the longest arc becomes
+ * shorter or is closed, since finding the new maximum would mean
+ * examining every arc.
+ */
+	bool isIntegral();
+	double getMaxArcBound();
+
+private:
+
+/*
+ * Implementation notes: sharing
+ * -----------------------------
+ * The structure of the graph never changes from one version to the
+ * next, so every version built from the same graph shares a single
+ * topologyT, which holds the arcs in the order of their numbers as an
+ * array of finish indices and an array of offsets giving the number
+ * of the first arc of each node.  The distances are stored in chunks
+ * of SNAPSHOT_CHUNK_SIZE, and each version has its own table of
+ * pointers to them.  Topologies and chunks carry reference counts,
+ * which are changed with atomic operations because versions that share
+ * them may be freed by different threads at the same time.
+ */
+
+	struct topologyT {
+		int refCount;
+		int nNodes;
+		int nArcs;
+		int maxDegree;
+		Vector<int> offsets;
+		Vector<int> finish;
+		Vector<arcT *> arcs;
+	};
+
+	struct chunkT {
+		int refCount;
+		double distance[SNAPSHOT_CHUNK_SIZE];
+	};
+
+/* Instance variables */
+
+	topologyT *topology;       /* Structure shared by every version       */
+	Vector<chunkT *> chunks;   /* Arc distances in blocks                 */
+	long version;              /* Number of this version                  */
+	int nonIntegral;           /* Open arcs whose distance is fractional  */
+	double maxArcBound;        /* Upper bound on the open arc distances   */
+	int pins;                  /* Queries holding this version            */
+
+/* Private methods */
+
+	GraphSnapshot();
+	~GraphSnapshot();
+	void setDistance(int id, double distance);
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(GraphSnapshot)
+
+	friend class SnapshotStore;
+
+};
+
+/*
+ * Class: SnapshotUpdate
+ * ---------------------
+ * This class collects the changes that a writer wants to publish as a
+ * single new version.  The changes take effect in the order in which
+ * they were added, so a later change to the same arc wins.
+ */
+
+class SnapshotUpdate {
+public:
+
+/*
+ * Constructor: SnapshotUpdate
+ * Usage: SnapshotUpdate update;
+ * -----------------------------
+ * Creates an update that makes no changes.
+ */
+	SnapshotUpdate();
+
+/*
+ * Destructor: ~SnapshotUpdate
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees the storage associated with this update.
+ */
+	~SnapshotUpdate();
+
+/*
+ * Methods: setArcWeight, closeArc
+ * Usage: update.setArcWeight(arc, distance);
+ *        update.closeArc(arc);
+ * -----------------------------------------
+ * These methods record a new distance for arc, which must be
+ * nonnegative, or record that the arc is closed.  A closed arc is
+ * reopened by giving it a distance again.
+ */
+	void setArcWeight(arcT *arc, double distance);
+	void closeArc(arcT *arc);
+
+/*
+ * Methods: size, clear
+ * Usage: int n = update.size();
+ *        update.clear();
+ * ----------------------------
+ * These methods return the number of changes recorded and discard all
+ * of them, so that the update can be reused.
+ */
+	int size();
+	void clear();
+
+private:
+
+/* Instance variables */
+
+	Vector<arcT *> arcs;       /* The arcs to change, in order            */
+	Vector<double> distances;  /* The new distance of each                */
+
+	friend class SnapshotStore;
+
+};
+
+/*
+ * Class: SnapshotStore
+ * --------------------
+ * This class publishes the versions of a graph's arcs.  Any number of
+ * query threads may call acquire and release while one or more writer
+ * threads call publish:
+ *
+ *     GraphSnapshot *snapshot = store.acquire();
+ *     DijkstraDistances(*snapshot, source, dist);
+ *     store.release(snapshot);
+ *
+ * A query never waits for a writer to build a version.  Writers build
+ * the next version without holding any lock that queries need, and the
+ * lock that acquire and release take is held by a writer only long
+ * enough to replace the pointer to the current version.
+ */
+
+class SnapshotStore {
+public:
+
+/*
+ * Constructor: SnapshotStore
+ * Usage: SnapshotStore store;
+ *        SnapshotStore store(graph);
+ * ----------------------------------
+ * Creates a store.  The second form also publishes the first version
+ * by calling build.
+ */
+	SnapshotStore();
+	SnapshotStore(Graph<nodeT,arcT> & graph);
+
+/*
+ * Destructor: ~SnapshotStore
+ * Usage: (usually implicit)
+ * -------------------------
+ * Frees the current version.  Every snapshot must have been released
+ * before the store is destroyed.
+ */
+	~SnapshotStore();
+
+/*
+ * Method: build
+ * Usage: store.build(graph);
+ * --------------------------
+ * Publishes a version holding the arcs of graph as they are now, which
+ * takes time proportional to the size of the graph.  Later versions
+ * are built from this one, so build must be called again after nodes
+ * or arcs are added to or removed from the graph.  Versions built from
+ * an earlier state of the graph remain valid for the queries that hold
+ * them.
+ */
+	void build(Graph<nodeT,arcT> & graph);
+
+/*
+ * Methods: acquire, release
+ * Usage: GraphSnapshot *snapshot = store.acquire();
+ *        store.release(snapshot);
+ * ------------------------------------------------
+ * The acquire method pins the current version and returns it; the
+ * version then stays in memory, unchanged, until the query releases
+ * it.  Calling acquire before the first version has been built is an
+ * error.  Each snapshot must be released exactly once, after which
+ * the query must not use it again.
+ */
+	GraphSnapshot *acquire();
+	void release(GraphSnapshot *snapshot);
+
+/*
+ * Method: publish
+ * Usage: long version = store.publish(update);
+ * --------------------------------------------
+ * Builds a new version by applying the changes in update to the current
+ * version and makes it current, returning its version number.  Every
+ * arc in the update must have been in the graph when the store was
+ * built.  The time required is proportional to the number of changes
+ * plus the number of chunks, and the new version shares every chunk
+ * in which no distance changed.  Writers that call publish at the same
+ * time are served one after another.
+ */
+	long publish(SnapshotUpdate & update);
+
+/*
+ * Methods: getCurrentVersion, getLiveVersionCount
+ * Usage: long version = store.getCurrentVersion();
+ *        int n = store.getLiveVersionCount();
+ * -----------------------------------------------
+ * These methods return the number of the current version, or 0 if
+ * none has been built, and the number of versions still in memory,
+ * which is one more than the number of earlier versions that queries
+ * have not yet released.
+ */
+	long getCurrentVersion();
+	int getLiveVersionCount();
+
+private:
+
+/* Instance variables */
+
+	GraphSnapshot *current;    /* The version returned by acquire         */
+	long lastVersion;          /* The last version number handed out      */
+	int nLive;                 /* Versions not yet freed                  */
+	pthread_mutex_t pinLock;   /* Guards current and the pin counts       */
+	pthread_mutex_t writeLock; /* Serializes the writers                  */
+
+/* Private methods */
+
+	void install(GraphSnapshot *snapshot);
+	void destroy(GraphSnapshot *snapshot);
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(SnapshotStore)
+
+};
+
+#endif
@@ -0,0 +1,301 @@
+/*
+ * File: spatialindex.cpp
+ * ----------------------
+ * This file implements the spatialindex.h interface.
+ */
+
+#include <cmath>
+#include "genlib.h"
+#include "spatialindex.h"
+
+/*
+ * Constants
+ * ---------
+ * NODES_PER_CELL is the average number of nodes the grid is sized to
+ * hold in each cell.  MAX_CELLS_PER_NODE limits the number of cells
+ * when the nodes are unevenly spread over their bounding box.
+ */
+
+const double NODES_PER_CELL = 2;
+const int MAX_CELLS_PER_NODE = 4;
+
+SpatialIndex::SpatialIndex() {
+	graph = NULL;
+	Vector<nodeT *> none;
+	rebuild(none);
+}
+
+SpatialIndex::SpatialIndex(Graph<nodeT,arcT> & graph) {
+	this->graph = NULL;
+	attach(graph);
+}
+
+SpatialIndex::~SpatialIndex() {
+	detach();
+}
+
+void SpatialIndex::attach(Graph<nodeT,arcT> & graph) {
+	detach();
+	this->graph = &graph;
+	graphReset();
+	graph.addListener(this);
+}
+
+void SpatialIndex::detach() {
+	if (graph != NULL) graph->removeListener(this);
+	graph = NULL;
+	Vector<nodeT *> none;
+	rebuild(none);
+}
+
+int SpatialIndex::size() {
+	return count;
+}
+
+nodeT *SpatialIndex::nearest(pointT pt) {
+	Vector<nodeT *> result = kNearest(pt, 1);
+	return (result.isEmpty()) ? NULL : result[0];
+}
+
+/*
+ * Implementation notes: kNearest
+ * ------------------------------
+ * The search examines rings of cells around the cell containing pt,
+ * starting with that cell itself.  Any node in a ring beyond ring r is
+ * separated from pt by at least r whole cells, so the search can stop
+ * after ring r once it has k candidates that are all closer than r
+ * cell widths.  If pt lies outside the grid, the search starts from
+ * the nearest cell on the edge, and the same bound still holds.
+ */
+
+Vector<nodeT *> SpatialIndex::kNearest(pointT pt, int k) {
+	Vector<nodeT *> best;
+	Vector<double> bestDist;
+	if (count == 0 || k <= 0) return best;
+	int row = cellRow(pt.y);
+	int col = cellCol(pt.x);
+	int maxRadius = (nRows > nCols) ? nRows : nCols;
+	for (int radius = 0; radius <= maxRadius; radius++) {
+		searchRing(pt, row, col, radius, k, best, bestDist);
+		if (best.size() == count) break;
+		if (best.size() == k) {
+			double bound = radius * cellSize;
+			if (bestDist[k - 1] <= bound * bound) break;
+		}
+	}
+	return best;
+}
+
+Vector<nodeT *> SpatialIndex::inRectangle(pointT corner1, pointT corner2) {
+	Vector<nodeT *> result;
+	if (count == 0) return result;
+	int x0 = (corner1.x < corner2.x) ? corner1.x : corner2.x;
+	int x1 = (corner1.x < corner2.x) ? corner2.x : corner1.x;
+	int y0 = (corner1.y < corner2.y) ? corner1.y : corner2.y;
+	int y1 = (corner1.y < corner2.y) ? corner2.y : corner1.y;
+	for (int row = cellRow(y0); row <= cellRow(y1); row++) {
+		for (int col = cellCol(x0); col <= cellCol(x1); col++) {
+			Vector<nodeT *> & cell = cells[row * nCols + col];
+			for (int i = 0; i < cell.size(); i++) {
+				pointT loc = cell[i]->loc;
+				if (loc.x >= x0 && loc.x <= x1 && loc.y >= y0 && loc.y <= y1) {
+					result.add(cell[i]);
+				}
+			}
+		}
+	}
+	return result;
+}
+
+/*
+ * Implementation notes: nodeAdded
+ * -------------------------------
+ * A node that falls outside the grid forces a rebuild.  To keep a map
+ * that is loaded in order from one side to the other from rebuilding
+ * on every node, such a rebuild leaves a margin around the nodes.
+ */
+
+void SpatialIndex::nodeAdded(nodeT *node) {
+	if (!inGrid(node->loc) || count >= 2 * builtCount) {
+		Vector<nodeT *> nodes;
+		collectNodes(nodes);
+		nodes.add(node);
+		rebuild(nodes);
+	} else {
+		int cell = cellRow(node->loc.y) * nCols + cellCol(node->loc.x);
+		cells[cell].add(node);
+		cellOf.add(cell);
+		count++;
+	}
+}
+
+/*
+ * Implementation notes: nodeRemoved
+ * ---------------------------------
+ * The node is looked for in the cell where it was filed, which is not
+ * necessarily the cell its loc field names now.  The graph fills the
+ * hole in the indices with the node that has the highest index, and
+ * cellOf moves that node's entry to match.
+ */
+
+void SpatialIndex::nodeRemoved(nodeT *node) {
+	int index = node->index;
+	if (index < 0 || index >= cellOf.size()) {
+		Error("SpatialIndex: node " + node->name + " is not in the index");
+	}
+	Vector<nodeT *> & cell = cells[cellOf[index]];
+	for (int i = 0; i < cell.size(); i++) {
+		if (cell[i] == node) {
+			cell[i] = cell[cell.size() - 1];
+			cell.removeAt(cell.size() - 1);
+			count--;
+			int last = cellOf.size() - 1;
+			cellOf[index] = cellOf[last];
+			cellOf.removeAt(last);
+			return;
+		}
+	}
+	Error("SpatialIndex: node " + node->name + " is not in the index");
+}
+
+void SpatialIndex::graphReset() {
+	Vector<nodeT *> nodes;
+	if (graph != NULL) {
+		for (int i = 0; i < graph->size(); i++) {
+			nodes.add(graph->getNodeByIndex(i));
+		}
+	}
+	rebuild(nodes);
+}
+
+/*
+ * Private method: rebuild
+ * Usage: rebuild(nodes);
+ * ----------------------
+ * Replaces the grid with a new one that holds exactly the specified
+ * nodes, whose indices must run from 0 to one less than their number,
+ * as the indices of the nodes in a graph do.  The cells are sized for
+ * the bounding box of the nodes, and the grid extends half the size of
+ * that box beyond it on each side.
+ */
+
+void SpatialIndex::rebuild(Vector<nodeT *> & nodes) {
+	int n = nodes.size();
+	cells.clear();
+	cellOf.clear();
+	count = builtCount = n;
+	if (n == 0) {
+		nRows = nCols = 0;
+		originX = originY = 0;
+		cellSize = 1;
+		return;
+	}
+	int minX = nodes[0]->loc.x, maxX = minX;
+	int minY = nodes[0]->loc.y, maxY = minY;
+	for (int i = 1; i < n; i++) {
+		pointT loc = nodes[i]->loc;
+		if (loc.x < minX) minX = loc.x;
+		if (loc.x > maxX) maxX = loc.x;
+		if (loc.y < minY) minY = loc.y;
+		if (loc.y > maxY) maxY = loc.y;
+	}
+	double width = maxX - minX + 1;
+	double height = maxY - minY + 1;
+	cellSize = sqrt(width * height * NODES_PER_CELL / n);
+	if (cellSize < 1) cellSize = 1;
+	originX = minX - int(width / 2);
+	originY = minY - int(height / 2);
+	while (true) {
+		nCols = int(2 * width / cellSize) + 1;
+		nRows = int(2 * height / cellSize) + 1;
+		if (double(nRows) * nCols <= MAX_CELLS_PER_NODE * n + 16) break;
+		cellSize *= 2;
+	}
+	cells = Vector< Vector<nodeT *> >(nRows * nCols);
+	for (int i = 0; i < nRows * nCols; i++) {
+		cells.add(Vector<nodeT *>());
+	}
+	cellOf = Vector<int>(n);
+	for (int i = 0; i < n; i++) {
+		cellOf.add(0);
+	}
+	for (int i = 0; i < n; i++) {
+		pointT loc = nodes[i]->loc;
+		int cell = cellRow(loc.y) * nCols + cellCol(loc.x);
+		cells[cell].add(nodes[i]);
+		cellOf[nodes[i]->index] = cell;
+	}
+}
+
+void SpatialIndex::collectNodes(Vector<nodeT *> & nodes) {
+	for (int i = 0; i < cells.size(); i++) {
+		for (int j = 0; j < cells[i].size(); j++) {
+			nodes.add(cells[i][j]);
+		}
+	}
+}
+
+/*
+ * Private methods: inGrid, cellRow, cellCol
+ * -----------------------------------------
+ * The inGrid method tests whether a point lies within the area covered
+ * by the grid.  The cellRow and cellCol methods return the row and
+ * column of the cell containing a coordinate, clamped to the edges of
+ * the grid for points that lie outside it.
+ */
+
+bool SpatialIndex::inGrid(pointT pt) {
+	return pt.x >= originX && pt.x < originX + nCols * cellSize
+	    && pt.y >= originY && pt.y < originY + nRows * cellSize;
+}
+
+int SpatialIndex::cellRow(int y) {
+	int row = int(floor((y - originY) / cellSize));
+	if (row < 0) return 0;
+	return (row >= nRows) ? nRows - 1 : row;
+}
+
+int SpatialIndex::cellCol(int x) {
+	int col = int(floor((x - originX) / cellSize));
+	if (col < 0) return 0;
+	return (col >= nCols) ? nCols - 1 : col;
+}
+
+/*
+ * Private method: searchRing
+ * Usage: searchRing(pt, row, col, radius, k, best, bestDist);
+ * -----------------------------------------------------------
+ * Examines the cells whose row and column differ from (row, col) by
+ * exactly radius in the larger of the two directions.  The best and
+ * bestDist vectors hold the closest nodes found so far and their
+ * squared distances, in increasing order, and never grow beyond k.
+ */
+
+void SpatialIndex::searchRing(pointT pt, int row, int col, int radius, int k,
+                              Vector<nodeT *> & best, Vector<double> & bestDist) {
+	for (int r = row - radius; r <= row + radius; r++) {
+		if (r < 0 || r >= nRows) continue;
+		bool edgeRow = (r == row - radius || r == row + radius);
+		int step = (edgeRow || radius == 0) ? 1 : 2 * radius;
+		for (int c = col - radius; c <= col + radius; c += step) {
+			if (c < 0 || c >= nCols) continue;
+			Vector<nodeT *> & cell = cells[r * nCols + c];
+			for (int i = 0; i < cell.size(); i++) {
+				double dx = cell[i]->loc.x - pt.x;
+				double dy = cell[i]->loc.y - pt.y;
+				double d = dx * dx + dy * dy;
+				if (best.size() == k && d >= bestDist[k - 1]) continue;
+				if (best.size() == k) {
+					best.removeAt(k - 1);
+					bestDist.removeAt(k - 1);
+				}
+				int pos = best.size();
+				while (pos > 0 && bestDist[pos - 1] > d) {
+					pos--;
+				}
+				best.insertAt(pos, cell[i]);
+				bestDist.insertAt(pos, d);
+			}
+		}
+	}
+}
@@ -0,0 +1,152 @@
+/*
+ * File: spatialindex.h
+ * --------------------
+ * This file provides the interface to the SpatialIndex class, which
+ * finds the nodes of a Pathfinder graph by their position on the map.
+ * The mouse functions in gpathfinder.h return only a pointT, and the
+ * index turns such a point into the node closest to it without looking
+ * at every node in the graph.
+ */
+
+#ifndef _spatialindex_h
+#define _spatialindex_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+#include "point.h"
+
+/*
+ * Class: SpatialIndex
+ * -------------------
+ * This class indexes the nodes of a graph by their loc field.  Once the
+ * index is attached to a graph, it registers itself as a listener and
+ * follows the nodes as they are added and removed, so it never has to
+ * be rebuilt by the client.  The loc field of a node must be set
+ * before the node is added to an indexed graph, which means creating
+ * the node and passing it to addNode rather than adding it by name,
+ * and must not change while the node is in the graph.
+ */
+
+class SpatialIndex : public GraphListener<nodeT,arcT> {
+public:
+
+/*
+ * Constructor: SpatialIndex
+ * Usage: SpatialIndex index;
+ *        SpatialIndex index(graph);
+ * ---------------------------------
+ * Creates a spatial index.  The second form attaches the index to the
+ * graph, as described for the attach method.
+ */
+	SpatialIndex();
+	SpatialIndex(Graph<nodeT,arcT> & graph);
+
+/*
+ * Destructor: ~SpatialIndex
+ * Usage: (usually implicit)
+ * -------------------------
+ * Detaches the index from its graph and frees its storage.
+ */
+	virtual ~SpatialIndex();
+
+/*
+ * Methods: attach, detach
+ * Usage: index.attach(graph);
+ *        index.detach();
+ * --------------------------
+ * The attach method indexes every node in the graph, which takes time
+ * proportional to the number of nodes, and registers the index as a
+ * listener so that later changes are reflected automatically.  The
+ * graph must outlive the index or be detached from it first.  The
+ * detach method unregisters the index and empties it.
+ */
+	void attach(Graph<nodeT,arcT> & graph);
+	void detach();
+
+/*
+ * Method: size
+ * Usage: int n = index.size();
+ * ----------------------------
+ * Returns the number of nodes in the index.
+ */
+	int size();
+
+/*
+ * Method: nearest
+ * Usage: nodeT *node = index.nearest(pt);
+ * ---------------------------------------
+ * Returns the node closest to pt, or NULL if the index is empty.
+ */
+	nodeT *nearest(pointT pt);
+
+/*
+ * Method: kNearest
+ * Usage: Vector<nodeT *> nodes = index.kNearest(pt, k);
+ * -----------------------------------------------------
+ * Returns the k nodes closest to pt in order of increasing distance,
+ * or every node if the index holds fewer than k.
+ */
+	Vector<nodeT *> kNearest(pointT pt, int k);
+
+/*
+ * Method: inRectangle
+ * Usage: Vector<nodeT *> nodes = index.inRectangle(corner1, corner2);
+ * -------------------------------------------------------------------
+ * Returns the nodes that lie within the rectangle with the specified
+ * opposite corners, including its boundary, in no particular order.
+ */
+	Vector<nodeT *> inRectangle(pointT corner1, pointT corner2);
+
+/* Methods called by the graph, as described in graph.h */
+
+	virtual void nodeAdded(nodeT *node);
+	virtual void nodeRemoved(nodeT *node);
+	virtual void graphReset();
+
+private:
+
+/*
+ * Implementation notes: grid of cells
+ * -----------------------------------
+ * The index divides the bounding box of the nodes into a grid of
+ * square cells, each of which holds the nodes that fall inside it.  The
+ * cell size is chosen so that each cell holds about two nodes on
+ * average, which makes a nearest-neighbor search examine only a few
+ * cells around the query point.  Adding a node outside the grid, or
+ * enough nodes to double the count since the grid was built, rebuilds
+ * the grid, so the cost of rebuilding is spread evenly over the nodes
+ * that caused it.  The index also records the cell in which it filed
+ * each node, so that removing a node never depends on its loc field.
+ */
+
+/* Instance variables */
+
+	Graph<nodeT,arcT> *graph;         /* The graph being indexed           */
+	Vector< Vector<nodeT *> > cells;  /* The cells in row-major order      */
+	int nRows, nCols;                 /* Dimensions of the grid            */
+	int originX, originY;             /* Coordinates of the top-left cell  */
+	double cellSize;                  /* Width and height of each cell     */
+	Vector<int> cellOf;               /* Cell of each node, by node index  */
+	int count;                        /* Number of nodes in the index      */
+	int builtCount;                   /* Number when the grid was built    */
+
+/* Private methods */
+
+	void rebuild(Vector<nodeT *> & nodes);
+	void collectNodes(Vector<nodeT *> & nodes);
+	bool inGrid(pointT pt);
+	int cellRow(int y);
+	int cellCol(int x);
+	void searchRing(pointT pt, int row, int col, int radius, int k,
+	                Vector<nodeT *> & best, Vector<double> & bestDist);
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(SpatialIndex)
+
+};
+
+#endif
@@ -0,0 +1,699 @@
+/*
+ * File: sssp.cpp
+ * --------------
+ * This file implements the sssp.h interface.
+ */
+
+#include <cmath>
+#include "genlib.h"
+#include "sssp.h"
+#include "parallel.h"
+#include "distqueue.h"
+
+/*
+ * Constants
+ * ---------
+ * PARALLEL_THRESHOLD is the smallest number of nodes in a round of
+ * delta-stepping for which it is worth starting threads; smaller
+ * rounds are processed on the calling thread.  MAX_BUCKETS limits the
+ * size of the cyclic bucket array when the client supplies a delta
+ * that is very small compared with the longest arc.
+ */
+
+const int PARALLEL_THRESHOLD = 4096;
+const int MAX_BUCKETS = 1 << 20;
+
+/* Types */
+
+struct relaxRequestT {
+	int node;
+	double dist;
+};
+
+/*
+ * Type: deltaStateT
+ * -----------------
+ * This structure holds the state shared by the threads during one
+ * round of delta-stepping.  The outbox vector holds one list of
+ * requests for each pair of threads: thread t stores the requests for
+ * nodes owned by thread o in outbox[t * nThreads + o].  Each thread
+ * then applies only the requests for the nodes it owns, so no two
+ * threads ever write to the same entry in dist.
+ */
+
+struct deltaStateT {
+	Graph<nodeT,arcT> *graph;
+	Vector<double> *dist;
+	Vector<int> *frontier;
+	double delta;
+	bool heavy;
+	Vector< Vector<relaxRequestT> > outbox;
+	Vector< Vector<int> > improved;
+};
+
+/* Prototypes */
+
+template <typename ArcSourceType>
+static void RunDijkstra(ArcSourceType & arcs, int source,
+                        Vector<double> & dist, Vector<arcT *> *parent,
+                        queueKindT kind, searchStatsT *stats,
+                        SearchControl *control);
+template <typename ArcSourceType>
+static void SettleQueue(ArcSourceType & arcs, DistanceQueue & queue,
+                        Vector<double> & dist, Vector<arcT *> *parent,
+                        SearchControl *control, searchStatsT *stats);
+static void InitDistances(int nNodes, Vector<double> & dist);
+static double MaxArcDistance(Graph<nodeT,arcT> & graph);
+static void RelaxRound(deltaStateT & state, int nThreads);
+static void GenerateRequests(int thread, int nThreads, deltaStateT & state);
+static void ApplyRequests(int thread, int nThreads, deltaStateT & state);
+static int BucketImprovedNodes(deltaStateT & state,
+                               Vector< Vector<int> > & buckets);
+static void DetachSubtree(Graph<nodeT,arcT> & graph, Vector<double> & dist,
+                          Vector<arcT *> & parent, nodeT *root,
+                          DistanceQueue & queue);
+
+/*
+ * Classes: GraphArcSource, BufferedArcSource<RepType>
+ * ---------------------------------------------------
+ * These classes give the search loop in SettleQueue the same view of
+ * the arcs in each representation it searches.  The load method makes
+ * the arcs leaving a node current and returns their number, after which
+ * getDistance, getFinish, and getArc describe the arc at a position.
+ * The chooseQueueKind method finds the longest arc and, if kind is
+ * AUTO_QUEUE, the queue suited to the arc distances.  BufferedArcSource
+ * serves both CompactGraph and GraphSnapshot, which deliver the arcs
+ * of a node into an array through the ReadArcs functions.  Only a
+ * Graph has arcT pointers to report, so BufferedArcSource is never
+ * asked to record parent arcs and returns NULL from getArc.
+ */
+
+class GraphArcSource {
+public:
+	GraphArcSource(Graph<nodeT,arcT> & graph, bool backward)
+	               : graph(graph), backward(backward), arcs(NULL) { }
+
+	int size() {
+		return graph.size();
+	}
+
+	queueKindT chooseQueueKind(queueKindT kind, double & maxArc) {
+		maxArc = MaxArcDistance(graph);
+		return (kind == AUTO_QUEUE) ? ChooseQueueKind(graph, maxArc) : kind;
+	}
+
+	int load(int index) {
+		nodeT *node = graph.getNodeByIndex(index);
+		arcs = (backward) ? &node->incoming : &node->arcs;
+		return arcs->size();
+	}
+
+	double getDistance(int i) {
+		return (*arcs)[i]->distance;
+	}
+
+	int getFinish(int i) {
+		arcT *arc = (*arcs)[i];
+		return ((backward) ? arc->start : arc->finish)->index;
+	}
+
+	arcT *getArc(int i) {
+		return (*arcs)[i];
+	}
+
+private:
+	Graph<nodeT,arcT> & graph;
+	bool backward;
+	SmallSet<arcT *> *arcs;
+};
+
+static int ReadArcs(CompactGraph & compact, int index, compactArcT arcs[]) {
+	return compact.decodeArcs(index, arcs);
+}
+
+static int ReadArcs(GraphSnapshot & snapshot, int index, compactArcT arcs[]) {
+	return snapshot.getArcs(index, arcs);
+}
+
+template <typename RepType>
+class BufferedArcSource {
+public:
+	BufferedArcSource(RepType & rep)
+	                  : rep(rep), buffer(rep.getMaxDegree() + 1) {
+		compactArcT blank = { 0, 0 };
+		for (int i = 0; i <= rep.getMaxDegree(); i++) {
+			buffer.add(blank);
+		}
+		arcs = &buffer[0];
+	}
+
+	int size() {
+		return rep.size();
+	}
+
+	queueKindT chooseQueueKind(queueKindT kind, double & maxArc) {
+		queueKindT choice = ChooseQueueKind(rep, maxArc);
+		return (kind == AUTO_QUEUE) ? choice : kind;
+	}
+
+	int load(int index) {
+		return ReadArcs(rep, index, arcs);
+	}
+
+	double getDistance(int i) {
+		return arcs[i].distance;
+	}
+
+	int getFinish(int i) {
+		return arcs[i].finish;
+	}
+
+	arcT *getArc(int i) {
+		return NULL;
+	}
+
+private:
+	RepType & rep;
+	Vector<compactArcT> buffer;
+	compactArcT *arcs;
+};
+
+/*
+ * Implementation notes: DijkstraDistances, DijkstraTree,
+ *                       ReverseDijkstraTree
+ * -----------------------------------------------------
+ * This implementation uses a DistanceQueue of node indices.  Rather
+ * than supporting a decrease-key operation, it enqueues a node again
+ * whenever its distance improves and skips entries whose distance is
+ * out of date when they are dequeued.  Because Dijkstra's algorithm
+ * dequeues distances in nondecreasing order, the integer queues are
+ * valid whenever the arc distances are integers.  All three functions
+ * call RunDijkstra, which records parent arcs only if it is given a
+ * vector in which to store them, and they search backward by giving it
+ * a GraphArcSource that follows the incoming arcs.  A control is
+ * checked just after a node is settled, so the distance of that node,
+ * which is no larger than that of any node still to be settled, is the
+ * bound it records.  These functions initialize an entry for every
+ * node, so the bytes they touch include the whole of dist and parent,
+ * and all of that work counts as setup time.
+ */
+
+void DijkstraDistances(Graph<nodeT,arcT> & graph, nodeT *source,
+                       Vector<double> & dist, queueKindT kind,
+                       searchStatsT *stats, SearchControl *control) {
+	GraphArcSource arcs(graph, false);
+	RunDijkstra(arcs, source->index, dist, NULL, kind, stats, control);
+}
+
+void DijkstraTree(Graph<nodeT,arcT> & graph, nodeT *source,
+                  Vector<double> & dist, Vector<arcT *> & parent,
+                  queueKindT kind, searchStatsT *stats,
+                  SearchControl *control) {
+	double clock = (stats == NULL) ? 0 : SearchClock();
+	parent.clear();
+	for (int i = 0; i < graph.size(); i++) {
+		parent.add(NULL);
+	}
+	GraphArcSource arcs(graph, false);
+	RunDijkstra(arcs, source->index, dist, &parent, kind, stats, control);
+	if (stats != NULL) {
+		stats->setupTime = SearchClock() - clock - stats->searchTime;
+	}
+}
+
+void ReverseDijkstraTree(Graph<nodeT,arcT> & graph, nodeT *target,
+                         Vector<double> & dist, Vector<arcT *> & next,
+                         queueKindT kind, searchStatsT *stats,
+                         SearchControl *control) {
+	double clock = (stats == NULL) ? 0 : SearchClock();
+	next.clear();
+	for (int i = 0; i < graph.size(); i++) {
+		next.add(NULL);
+	}
+	GraphArcSource arcs(graph, true);
+	RunDijkstra(arcs, target->index, dist, &next, kind, stats, control);
+	if (stats != NULL) {
+		stats->setupTime = SearchClock() - clock - stats->searchTime;
+	}
+}
+
+/*
+ * Implementation notes: DijkstraDistances on a CompactGraph
+ * ---------------------------------------------------------
+ * This version runs the same search through a BufferedArcSource, which
+ * decodes the arcs of each settled node into a buffer large enough for
+ * the node with the most arcs.  The buffer is read through a pointer
+ * to its first element so that the loop over the arcs makes no bounds
+ * checks.
+ */
+
+void DijkstraDistances(CompactGraph & compact, int source,
+                       Vector<double> & dist, queueKindT kind,
+                       searchStatsT *stats, SearchControl *control) {
+	if (source < 0 || source >= compact.size()) {
+		Error("DijkstraDistances: Source index out of range");
+	}
+	BufferedArcSource<CompactGraph> arcs(compact);
+	RunDijkstra(arcs, source, dist, NULL, kind, stats, control);
+}
+
+/*
+ * Function: RunDijkstra
+ * Usage: RunDijkstra(arcs, source, dist, parent, kind, stats, control);
+ * ---------------------------------------------------------------------
+ * Computes the distances from the node whose index is source over the
+ * arcs supplied by arcs, which is one of the arc source classes above.
+ * If parent is not NULL, it must already hold an entry for every node,
+ * and the arc by which the search reached each node is stored there.
+ */
+
+template <typename ArcSourceType>
+static void RunDijkstra(ArcSourceType & arcs, int source,
+                        Vector<double> & dist, Vector<arcT *> *parent,
+                        queueKindT kind, searchStatsT *stats,
+                        SearchControl *control) {
+	double clock = (stats == NULL) ? 0 : SearchClock();
+	if (control != NULL) control->begin();
+	double maxArc;
+	kind = arcs.chooseQueueKind(kind, maxArc);
+	DistanceQueue queue;
+	queue.setKind(kind, maxArc);
+	InitDistances(arcs.size(), dist);
+	dist[source] = 0;
+	queue.enqueue(source, 0);
+	if (stats != NULL) {
+		ClearSearchStats(*stats);
+		stats->setupTime = SearchClock() - clock;
+	}
+	SettleQueue(arcs, queue, dist, parent, control, stats);
+	if (stats != NULL) {
+		long nNodes = arcs.size();
+		stats->bytesTouched = nNodes * sizeof(double)
+		                    + long(stats->peakFrontier) * sizeof(queueEntryT);
+		if (parent != NULL) stats->bytesTouched += nNodes * sizeof(arcT *);
+	}
+}
+
+/*
+ * Function: SettleQueue
+ * Usage: SettleQueue(arcs, queue, dist, parent, control, stats);
+ * --------------------------------------------------------------
+ * Runs Dijkstra's algorithm from the entries already in queue, whose
+ * distances must already be stored in dist, until the queue is empty
+ * or the control stops the search.  If parent is not NULL, each
+ * improvement records its arc there.  If stats is not NULL, this
+ * function fills in the search time and every count except
+ * bytesTouched, which depends on how the caller set up the search.
+ */
+
+template <typename ArcSourceType>
+static void SettleQueue(ArcSourceType & arcs, DistanceQueue & queue,
+                        Vector<double> & dist, Vector<arcT *> *parent,
+                        SearchControl *control, searchStatsT *stats) {
+	double clock = (stats == NULL) ? 0 : SearchClock();
+	int settled = 0;
+	long relaxed = 0, improved = 0;
+	while (!queue.isEmpty()) {
+		queueEntryT entry = queue.dequeue();
+		if (entry.dist > dist[entry.node]) continue;
+		settled++;
+		if (control != NULL && settled % SEARCH_CHECK_INTERVAL == 0
+		    && control->check(entry.dist)) break;
+		int nArcs = arcs.load(entry.node);
+		relaxed += nArcs;
+		for (int i = 0; i < nArcs; i++) {
+			double newDist = entry.dist + arcs.getDistance(i);
+			int finish = arcs.getFinish(i);
+			if (newDist < dist[finish]) {
+				if (dist[finish] != UNREACHABLE) improved++;
+				dist[finish] = newDist;
+				if (parent != NULL) (*parent)[finish] = arcs.getArc(i);
+				queue.enqueue(finish, newDist);
+			}
+		}
+	}
+	if (stats != NULL) {
+		stats->searchTime = SearchClock() - clock;
+		stats->settled = settled;
+		stats->relaxed = relaxed;
+		stats->pushes = queue.getPushCount();
+		stats->pops = queue.getPopCount();
+		stats->decreaseKeys = improved;
+		stats->peakFrontier = queue.getPeakSize();
+	}
+}
+
+/*
+ * Implementation notes: DijkstraDistances on a GraphSnapshot
+ * ----------------------------------------------------------
+ * This version is the same as the one for a CompactGraph, except that
+ * the buffer is filled with the open arcs of the node by getArcs.
+ */
+
+void DijkstraDistances(GraphSnapshot & snapshot, int source,
+                       Vector<double> & dist, queueKindT kind,
+                       searchStatsT *stats, SearchControl *control) {
+	if (source < 0 || source >= snapshot.size()) {
+		Error("DijkstraDistances: Source index out of range");
+	}
+	BufferedArcSource<GraphSnapshot> arcs(snapshot);
+	RunDijkstra(arcs, source, dist, NULL, kind, stats, control);
+}
+
+/*
+ * Implementation notes: RepairTree
+ * --------------------------------
+ * Both kinds of change end in the same search, run by SettleQueue as
+ * in RunDijkstra, which differs only in where it starts.  After a
+ * decrease, the queue holds the finish node of the arc alone.  After
+ * an increase, it holds each node of the detached subtree that can be
+ * reached from outside it.  The search then settles only nodes whose
+ * distance changes: a node outside the affected region already has a
+ * distance no larger than any path through the region offers, so
+ * relaxing an arc into it changes nothing.  The queue is a binary
+ * heap, because the integer queues are sized for a whole search and a
+ * repair is usually small.  Collecting the subtree counts as setup
+ * time.
+ */
+
+void RepairTree(Graph<nodeT,arcT> & graph, Vector<double> & dist,
+                Vector<arcT *> & parent, arcT *arc, double oldDistance,
+                searchStatsT *stats) {
+	double clock = (stats == NULL) ? 0 : SearchClock();
+	if (dist.size() != graph.size() || parent.size() != graph.size()) {
+		Error("RepairTree: The tree does not match the graph");
+	}
+	if (arc->distance < 0) Error("RepairTree: Negative arc distance");
+	int start = arc->start->index;
+	int finish = arc->finish->index;
+	bool removed = !arc->start->arcs.contains(arc);
+	DistanceQueue queue;
+	if (!removed && arc->distance < oldDistance) {
+		if (dist[start] != UNREACHABLE
+		    && dist[start] + arc->distance < dist[finish]) {
+			dist[finish] = dist[start] + arc->distance;
+			parent[finish] = arc;
+			queue.enqueue(finish, dist[finish]);
+		}
+	} else if (parent[finish] == arc
+	           && (removed || arc->distance > oldDistance)) {
+		DetachSubtree(graph, dist, parent, arc->finish, queue);
+	}
+	if (stats != NULL) {
+		ClearSearchStats(*stats);
+		stats->setupTime = SearchClock() - clock;
+	}
+	GraphArcSource arcs(graph, false);
+	SettleQueue(arcs, queue, dist, &parent, NULL, stats);
+	if (stats != NULL) {
+		stats->bytesTouched = long(stats->settled)
+		                    * (sizeof(double) + sizeof(arcT *))
+		                    + long(stats->peakFrontier) * sizeof(queueEntryT);
+	}
+}
+
+/*
+ * Implementation notes: DeltaSteppingDistances
+ * --------------------------------------------
+ * Every tentative distance that is still pending lies within the
+ * longest arc distance of a node in the current bucket, so a cyclic
+ * array of maxArc / delta + 2 buckets is enough to hold them all.  The
+ * buckets use lazy deletion: a node may appear in a bucket more than
+ * once or after its distance has moved to a lower bucket, and such
+ * stale entries are discarded when the bucket is processed.  The
+ * mark vector records the last round in which each node joined the
+ * frontier, and the settled vector records the bucket in which each
+ * node was last settled, so that each node's heavy arcs are relaxed
+ * only once per bucket.  A control is checked only between buckets,
+ * when every node closer than the start of the next bucket is final.
+ */
+
+void DeltaSteppingDistances(Graph<nodeT,arcT> & graph, nodeT *source,
+                            Vector<double> & dist,
+                            int nThreads, double delta,
+                            SearchControl *control) {
+	if (control != NULL) control->begin();
+	if (nThreads <= 0) nThreads = GetProcessorCount();
+	if (delta <= 0) delta = ChooseDelta(graph);
+	InitDistances(graph.size(), dist);
+	double maxArc = MaxArcDistance(graph);
+	if (maxArc / delta > MAX_BUCKETS - 2) delta = maxArc / (MAX_BUCKETS - 2);
+	int nBuckets = int(maxArc / delta) + 2;
+	Vector< Vector<int> > buckets(nBuckets);
+	for (int i = 0; i < nBuckets; i++) {
+		buckets.add(Vector<int>());
+	}
+	int nNodes = graph.size();
+	Vector<int> mark(nNodes);
+	Vector<long> settled(nNodes);
+	for (int i = 0; i < nNodes; i++) {
+		mark.add(-1);
+		settled.add(-1);
+	}
+	deltaStateT state;
+	state.graph = &graph;
+	state.dist = &dist;
+	state.delta = delta;
+	for (int i = 0; i < nThreads * nThreads; i++) {
+		state.outbox.add(Vector<relaxRequestT>());
+	}
+	for (int i = 0; i < nThreads; i++) {
+		state.improved.add(Vector<int>());
+	}
+	dist[source->index] = 0;
+	buckets[0].add(source->index);
+	int pending = 1, round = 0;
+	long sinceCheck = 0;
+	for (long current = 0; pending > 0; current++) {
+		if (control != NULL && sinceCheck >= SEARCH_CHECK_INTERVAL) {
+			sinceCheck = 0;
+			if (control->check(current * delta)) break;
+		}
+		Vector<int> & bucket = buckets[current % nBuckets];
+		Vector<int> frontier, removed;
+		while (!bucket.isEmpty()) {
+			Vector<int> entries;
+			entries.swap(bucket);
+			pending -= entries.size();
+			frontier.clear();
+			for (int i = 0; i < entries.size(); i++) {
+				int node = entries[i];
+				if (long(floor(dist[node] / delta)) != current) continue;
+				if (mark[node] == round) continue;
+				mark[node] = round;
+				frontier.add(node);
+				if (settled[node] != current) {
+					settled[node] = current;
+					removed.add(node);
+				}
+			}
+			round++;
+			state.frontier = &frontier;
+			state.heavy = false;
+			RelaxRound(state, nThreads);
+			pending += BucketImprovedNodes(state, buckets);
+		}
+		state.frontier = &removed;
+		state.heavy = true;
+		RelaxRound(state, nThreads);
+		pending += BucketImprovedNodes(state, buckets);
+		sinceCheck += removed.size();
+	}
+}
+
+/*
+ * Implementation notes: ChooseDelta
+ * ---------------------------------
+ * The function scans every arc once.  A graph with no positive arc
+ * distances gets a delta of 1, which puts everything into one bucket.
+ */
+
+double ChooseDelta(Graph<nodeT,arcT> & graph) {
+	double maxArc = MaxArcDistance(graph);
+	int nNodes = graph.size();
+	int nArcs = graph.getArcSet().size();
+	if (maxArc <= 0 || nNodes == 0) return 1;
+	double avgDegree = double(nArcs) / nNodes;
+	if (avgDegree < 1) avgDegree = 1;
+	return maxArc / avgDegree;
+}
+
+/*
+ * Function: RelaxRound
+ * Usage: RelaxRound(state, nThreads);
+ * -----------------------------------
+ * Relaxes the light or heavy arcs of every node in state.frontier and
+ * leaves the nodes whose distances improved in state.improved.  The
+ * work runs in two parallel phases: the first generates relaxation
+ * requests and the second applies them.  Small rounds run on a single
+ * thread, in which case only the first improved list is used.
+ */
+
+static void RelaxRound(deltaStateT & state, int nThreads) {
+	if (state.frontier->size() < PARALLEL_THRESHOLD) nThreads = 1;
+	RunInParallel(nThreads, GenerateRequests, state);
+	RunInParallel(nThreads, ApplyRequests, state);
+}
+
+/*
+ * Function: GenerateRequests
+ * Usage: RunInParallel(nThreads, GenerateRequests, state);
+ * --------------------------------------------------------
+ * Examines one slice of the frontier and records a request for every
+ * arc of the selected kind that would shorten the distance to its
+ * finish node.  No thread writes to dist during this phase, so reading
+ * it is safe.
+ */
+
+static void GenerateRequests(int thread, int nThreads, deltaStateT & state) {
+	Vector<int> & frontier = *state.frontier;
+	Vector<double> & dist = *state.dist;
+	int first = int(long(frontier.size()) * thread / nThreads);
+	int last = int(long(frontier.size()) * (thread + 1) / nThreads);
+	for (int i = first; i < last; i++) {
+		nodeT *node = state.graph->getNodeByIndex(frontier[i]);
+		double base = dist[node->index];
+		for (int j = 0; j < node->arcs.size(); j++) {
+			arcT *arc = node->arcs[j];
+			if ((arc->distance > state.delta) != state.heavy) continue;
+			double newDist = base + arc->distance;
+			int finish = arc->finish->index;
+			if (newDist < dist[finish]) {
+				relaxRequestT request = { finish, newDist };
+				state.outbox[thread * nThreads + finish % nThreads].add(request);
+			}
+		}
+	}
+}
+
+/*
+ * Function: ApplyRequests
+ * Usage: RunInParallel(nThreads, ApplyRequests, state);
+ * -----------------------------------------------------
+ * Applies the requests addressed to the nodes owned by this thread,
+ * which are the nodes whose index is congruent to thread modulo
+ * nThreads.
+ */
+
+static void ApplyRequests(int thread, int nThreads, deltaStateT & state) {
+	Vector<double> & dist = *state.dist;
+	Vector<int> & improved = state.improved[thread];
+	for (int t = 0; t < nThreads; t++) {
+		Vector<relaxRequestT> & requests = state.outbox[t * nThreads + thread];
+		for (int i = 0; i < requests.size(); i++) {
+			if (requests[i].dist < dist[requests[i].node]) {
+				dist[requests[i].node] = requests[i].dist;
+				improved.add(requests[i].node);
+			}
+		}
+		requests.clear();
+	}
+}
+
+/*
+ * Function: BucketImprovedNodes
+ * Usage: pending += BucketImprovedNodes(state, buckets);
+ * ------------------------------------------------------
+ * Adds each node in the improved lists to the bucket for its new
+ * distance, empties the lists, and returns the number of nodes added.
+ */
+
+static int BucketImprovedNodes(deltaStateT & state,
+                               Vector< Vector<int> > & buckets) {
+	Vector<double> & dist = *state.dist;
+	int nBuckets = buckets.size();
+	int count = 0;
+	for (int t = 0; t < state.improved.size(); t++) {
+		Vector<int> & improved = state.improved[t];
+		for (int i = 0; i < improved.size(); i++) {
+			int node = improved[i];
+			buckets[long(floor(dist[node] / state.delta)) % nBuckets].add(node);
+		}
+		count += improved.size();
+		improved.clear();
+	}
+	return count;
+}
+
+/*
+ * Function: InitDistances
+ * Usage: InitDistances(nNodes, dist);
+ * -----------------------------------
+ * Resets dist so that it holds UNREACHABLE for each of nNodes nodes.
+ */
+
+static void InitDistances(int nNodes, Vector<double> & dist) {
+	dist = Vector<double>(nNodes);
+	for (int i = 0; i < nNodes; i++) {
+		dist.add(UNREACHABLE);
+	}
+}
+
+/*
+ * Function: MaxArcDistance
+ * Usage: double maxArc = MaxArcDistance(graph);
+ * ---------------------------------------------
+ * Returns the longest arc distance in the graph, signaling an error if
+ * any arc distance is negative.
+ */
+
+static double MaxArcDistance(Graph<nodeT,arcT> & graph) {
+	double maxArc = 0;
+	for (int i = 0; i < graph.size(); i++) {
+		nodeT *node = graph.getNodeByIndex(i);
+		for (int j = 0; j < node->arcs.size(); j++) {
+			double d = node->arcs[j]->distance;
+			if (d < 0) Error("Negative arc distance in shortest path search");
+			if (d > maxArc) maxArc = d;
+		}
+	}
+	return maxArc;
+}
+
+/*
+ * Function: DetachSubtree
+ * Usage: DetachSubtree(graph, dist, parent, root, queue);
+ * -------------------------------------------------------
+ * Removes the subtree below root from the shortest-path tree, marking
+ * each of its nodes as unreachable, and then enqueues each node of the
+ * subtree with the shortest distance at which it can be reached by a
+ * single arc from a node outside it.  The subtree is found by walking
+ * the arcs leaving each of its nodes and keeping those that are the
+ * parent arcs of their finish nodes, so the tree needs no child lists.
+ * The walk uses the vector of subtree nodes as its queue.
+ */
+
+static void DetachSubtree(Graph<nodeT,arcT> & graph, Vector<double> & dist,
+                          Vector<arcT *> & parent, nodeT *root,
+                          DistanceQueue & queue) {
+	Vector<int> subtree;
+	subtree.add(root->index);
+	for (int i = 0; i < subtree.size(); i++) {
+		nodeT *node = graph.getNodeByIndex(subtree[i]);
+		for (int j = 0; j < node->arcs.size(); j++) {
+			arcT *arc = node->arcs[j];
+			if (parent[arc->finish->index] == arc) {
+				subtree.add(arc->finish->index);
+			}
+		}
+	}
+	for (int i = 0; i < subtree.size(); i++) {
+		dist[subtree[i]] = UNREACHABLE;
+		parent[subtree[i]] = NULL;
+	}
+	for (int i = 0; i < subtree.size(); i++) {
+		nodeT *node = graph.getNodeByIndex(subtree[i]);
+		for (int j = 0; j < node->incoming.size(); j++) {
+			arcT *arc = node->incoming[j];
+			double startDist = dist[arc->start->index];
+			if (startDist != UNREACHABLE
+			    && startDist + arc->distance < dist[node->index]) {
+				dist[node->index] = startDist + arc->distance;
+				parent[node->index] = arc;
+			}
+		}
+		if (dist[node->index] != UNREACHABLE) {
+			queue.enqueue(node->index, dist[node->index]);
+		}
+	}
+}
@@ -0,0 +1,210 @@
+/*
+ * File: sssp.h
+ * ------------
+ * This interface exports functions that compute single-source shortest
+ * path distances, which are the lengths of the shortest paths from one
+ * source node to every node in a Pathfinder graph.  These one-to-all
+ * computations are the basis for isochrones and complete distance
+ * fields, as opposed to the point-to-point searches done by Path.
+ *
+ * Each function fills in a vector of distances indexed by the index
+ * field of the nodes, so that the distance to node is dist[node->index].
+ * Nodes that cannot be reached from the source have distance
+ * UNREACHABLE.  All arc distances must be nonnegative.  The Dijkstra
+ * functions also accept an optional searchStatsT record, described in
+ * searchstats.h, in which they report the work they have done.
+ *
+ * Every function also accepts an optional SearchControl, described in
+ * searchcontrol.h, which can stop the computation early.  If it does,
+ * each entry of dist that is no larger than the bound reported by the
+ * control is the exact distance, and each larger entry is either an
+ * upper bound or UNREACHABLE.  The same holds for the entries of the
+ * parent and next vectors, which are exact for those nodes.
+ */
+
+#ifndef _sssp_h
+#define _sssp_h
+
+#include <cfloat>
+#include "genlib.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+#include "compactgraph.h"
+#include "snapshot.h"
+#include "distqueue.h"
+#include "searchstats.h"
+#include "searchcontrol.h"
+
+/*
+ * Constant: UNREACHABLE
+ * ---------------------
+ * The distance reported for nodes that have no path from the source.
+ */
+
+const double UNREACHABLE = DBL_MAX;
+
+/*
+ * Function: DijkstraDistances
+ * Usage: DijkstraDistances(graph, source, dist);
+ *        DijkstraDistances(graph, source, dist, kind);
+ *        DijkstraDistances(graph, source, dist, kind, &stats);
+ *        DijkstraDistances(graph, source, dist, kind, &stats, &control);
+ * ----------------------------------------------------------------------
+ * Computes the shortest path distances from source to every node using
+ * Dijkstra's algorithm on a single thread.  This function serves as the
+ * reference against which the other engines are checked.  The optional
+ * kind parameter selects the priority queue; by default, the function
+ * calls ChooseQueueKind, which picks a bucket-based queue when every
+ * arc distance is an integer and falls back to a binary heap otherwise.
+ */
+
+void DijkstraDistances(Graph<nodeT,arcT> & graph, nodeT *source,
+                       Vector<double> & dist, queueKindT kind = AUTO_QUEUE,
+                       searchStatsT *stats = NULL,
+                       SearchControl *control = NULL);
+
+/*
+ * Function: DijkstraDistances
+ * Usage: DijkstraDistances(compact, source, dist);
+ *        DijkstraDistances(compact, source, dist, kind);
+ *        DijkstraDistances(compact, source, dist, kind, &stats);
+ *        DijkstraDistances(compact, source, dist, kind, &stats, &control);
+ * ------------------------------------------------------------------------
+ * Computes the same distances directly on a CompactGraph, described in
+ * compactgraph.h, starting from the node whose index is source.  The
+ * results are identical to those for the graph from which the compact
+ * copy was built unless its distances were stored with a tolerance.
+ */
+
+void DijkstraDistances(CompactGraph & compact, int source,
+                       Vector<double> & dist, queueKindT kind = AUTO_QUEUE,
+                       searchStatsT *stats = NULL,
+                       SearchControl *control = NULL);
+
+/*
+ * Function: DijkstraDistances
+ * Usage: DijkstraDistances(snapshot, source, dist);
+ *        DijkstraDistances(snapshot, source, dist, kind);
+ *        DijkstraDistances(snapshot, source, dist, kind, &stats);
+ *        DijkstraDistances(snapshot, source, dist, kind, &stats, &control);
+ * -------------------------------------------------------------------------
+ * Computes the same distances on a version of a graph published by a
+ * SnapshotStore, described in snapshot.h, starting from the node whose
+ * index is source.  Closed arcs are ignored.  Because a snapshot never
+ * changes, any number of threads may run this function at once while
+ * other threads publish new versions.
+ */
+
+void DijkstraDistances(GraphSnapshot & snapshot, int source,
+                       Vector<double> & dist, queueKindT kind = AUTO_QUEUE,
+                       searchStatsT *stats = NULL,
+                       SearchControl *control = NULL);
+
+/*
+ * Function: DijkstraTree
+ * Usage: DijkstraTree(graph, source, dist, parent);
+ *        DijkstraTree(graph, source, dist, parent, kind);
+ *        DijkstraTree(graph, source, dist, parent, kind, &stats);
+ *        DijkstraTree(graph, source, dist, parent, kind, &stats, &control);
+ * -------------------------------------------------------------------------
+ * Computes the same distances as DijkstraDistances and also fills in
+ * the shortest-path tree: parent[node->index] is the last arc on a
+ * shortest path from source to node, or NULL for the source and for
+ * nodes that cannot be reached.  A shortest path to any node can then
+ * be read backward by following the parent arcs to the source.
+ */
+
+void DijkstraTree(Graph<nodeT,arcT> & graph, nodeT *source,
+                  Vector<double> & dist, Vector<arcT *> & parent,
+                  queueKindT kind = AUTO_QUEUE, searchStatsT *stats = NULL,
+                  SearchControl *control = NULL);
+
+/*
+ * Function: ReverseDijkstraTree
+ * Usage: ReverseDijkstraTree(graph, target, dist, next);
+ *        ReverseDijkstraTree(graph, target, dist, next, kind);
+ *        ReverseDijkstraTree(graph, target, dist, next, kind, &stats);
+ *        ReverseDijkstraTree(graph, target, dist, next, kind, &stats,
+ *                            &control);
+ * --------------------------------------------------------------------
+ * Computes the shortest-path tree toward target by searching backward
+ * over the incoming arcs.  Here dist[node->index] is the distance from
+ * node to target, and next[node->index] is the first arc on a shortest
+ * path from node to target, or NULL for the target and for nodes from
+ * which it cannot be reached.  A shortest path from any node can then
+ * be read forward by following the next arcs to the target.
+ */
+void ReverseDijkstraTree(Graph<nodeT,arcT> & graph, nodeT *target,
+                         Vector<double> & dist, Vector<arcT *> & next,
+                         queueKindT kind = AUTO_QUEUE,
+                         searchStatsT *stats = NULL,
+                         SearchControl *control = NULL);
+
+/*
+ * Function: RepairTree
+ * Usage: RepairTree(graph, dist, parent, arc, oldDistance);
+ *        RepairTree(graph, dist, parent, arc, oldDistance, &stats);
+ * ----------------------------------------------------------------
+ * Brings a shortest-path tree computed by DijkstraTree up to date after
+ * a single arc has changed, doing work only for the nodes whose paths
+ * the change affects.  The arc's distance field must already hold its
+ * new value, and oldDistance is the value it replaced.  The function
+ * also handles an arc that has just been added, for which oldDistance
+ * is UNREACHABLE, and one that has just been removed from the graph,
+ * which it recognizes by its absence from the arcs of its start node.
+ *
+ * If the arc became shorter, the nodes whose paths it now shortens are
+ * updated by a search that starts from its finish node.  If the arc
+ * became longer or was removed, the tree changes only if the arc is in
+ * it, in which case every node in the subtree below the arc loses its
+ * path and is given the best one it can reach from outside the subtree.
+ * This is the approach of Ramalingam and Reps.  The stats record, if
+ * supplied, reports the work done by the repair.
+ */
+
+void RepairTree(Graph<nodeT,arcT> & graph, Vector<double> & dist,
+                Vector<arcT *> & parent, arcT *arc, double oldDistance,
+                searchStatsT *stats = NULL);
+
+/*
+ * Function: DeltaSteppingDistances
+ * Usage: DeltaSteppingDistances(graph, source, dist);
+ *        DeltaSteppingDistances(graph, source, dist, nThreads, delta);
+ *        DeltaSteppingDistances(graph, source, dist, nThreads, delta,
+ *                               &control);
+ * --------------------------------------------------------------------
+ * Computes the same distances as DijkstraDistances using the
+ * delta-stepping algorithm of Meyer and Sanders.  Tentative distances
+ * are kept in buckets of width delta.  The nodes in the lowest nonempty
+ * bucket are processed together: their light arcs (those no longer than
+ * delta) are relaxed repeatedly until the bucket is empty, after which
+ * their heavy arcs are relaxed once.  The relaxations in each round are
+ * independent, so they are spread over nThreads threads.
+ *
+ * If nThreads is omitted or is 0, the function uses one thread per
+ * processor.  If delta is omitted or is 0, the function chooses a
+ * value by calling ChooseDelta.  A control is checked between buckets,
+ * once the buckets since the last check have settled at least
+ * SEARCH_CHECK_INTERVAL nodes.
+ */
+
+void DeltaSteppingDistances(Graph<nodeT,arcT> & graph, nodeT *source,
+                            Vector<double> & dist,
+                            int nThreads = 0, double delta = 0,
+                            SearchControl *control = NULL);
+
+/*
+ * Function: ChooseDelta
+ * Usage: double delta = ChooseDelta(graph);
+ * -----------------------------------------
+ * Returns a bucket width for DeltaSteppingDistances based on the
+ * distribution of arc distances in the graph.  The value follows the
+ * usual rule of dividing the largest arc distance by the average
+ * out-degree, which keeps the number of repeated relaxations small
+ * while leaving enough nodes in each bucket to keep the threads busy.
+ */
+
+double ChooseDelta(Graph<nodeT,arcT> & graph);
+
+#endif
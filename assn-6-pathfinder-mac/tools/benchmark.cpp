@@ -0,0 +1,1190 @@
+/*
+ * File: benchmark.cpp
+ * -------------------
+ * This program measures the performance of the Pathfinder code on the
+ * maps that come with the assignment and on maps from mapgen.h.  It
+ * times each stage of the pipeline separately: parsing the text format
+ * as NewMap does, building the graph with addNode and addArc, the
+ * shortest-path engines, the minimum spanning forest, the node orders
+ * from nodeorder.h, the compressed arcs from compactgraph.h, the
+ * repair of shortest-path trees after arc changes, the versioned
+ * snapshots from snapshot.h, and the basic operations of the Vector,
+ * Map, Set, and PQueue classes on which all of them rest.  The tool is run as
+ *
+ *     benchmark [options]
+ *
+ * with the following options:
+ *
+ *     --nodes n        Number of nodes in the generated maps (100000)
+ *     --seed n         Random seed for the maps and queries (1)
+ *     --reps n         Repetitions of each whole-map measurement (5)
+ *     --queries n      Number of point-to-point queries (200)
+ *     --maps dir       Directory holding the bundled maps (.)
+ *     --csv file       Writes the results as CSV
+ *     --json file      Writes the results as JSON
+ *     --baseline file  Compares the results against an earlier CSV file
+ *     --tolerance pct  Slowdown reported as a regression (10)
+ *     --trace file     Writes the statistics of each query as JSON lines
+ *     --allocs file    Writes the container allocations made by queries
+ *     --memory file    Writes the memory used by each generated graph
+ *
+ * Every measurement is repeated, and the results give the minimum,
+ * median, 90th and 99th percentiles, maximum, and mean of the samples
+ * in milliseconds.  A baseline is simply the CSV file of an earlier
+ * run.  When one is given, the median of each measurement is compared
+ * with the median in the baseline, every measurement that is slower by
+ * more than the tolerance is reported as a regression, and the program
+ * exits with status 1 so that scripts can detect the failure.
+ *
+ * The trace file has one line for each point-to-point and k-shortest
+ * query, holding a JSON object that names the engine, the map, and
+ * the endpoints and gives the distance found and the searchStatsT
+ * record filled in by the engine.  The records are requested only
+ * when a trace file is given, so tracing does not slow down the
+ * ordinary measurements.
+ *
+ * The allocation file has a table from allocstats.h for each kind of
+ * point-to-point and k-shortest query, headed by the mean number of
+ * allocations per query.  Allocations are counted only when the file
+ * is requested.  The memory file has the breakdown returned by the
+ * memoryStats method of Graph for each generated map, followed by the
+ * same breakdown for its CompactGraph together with the compression
+ * ratio and the time Dijkstra's algorithm takes on the compact copy
+ * relative to the time it takes on the Graph.
+ *
+ * The tool is built from this file together with the engines in the
+ * parent directory and the CS106 library, e.g.
+ *
+ *     g++ -O2 -I.. -I../cs106 benchmark.cpp ../mapgen.cpp ../parallel.cpp \
+ *         ../sssp.cpp ../distqueue.cpp ../searchspace.cpp ../path.cpp \
+ *         ../treecache.cpp ../landmarks.cpp ../components.cpp \
+ *         ../isochrone.cpp ../kshortest.cpp ../mst.cpp ../searchstats.cpp \
+ *         ../nodeorder.cpp ../compactgraph.cpp ../searchcontrol.cpp \
+ *         ../dynamictree.cpp ../snapshot.cpp \
+ *         ../cs106/libcs106.a -lpthread -o benchmark
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+#include <unistd.h>
+#include <sys/time.h>
+#include "genlib.h"
+#include "foreach.h"
+#include "vector.h"
+#include "map.h"
+#include "set.h"
+#include "pqueue.h"
+#include "scanner.h"
+#include "random.h"
+#include "strutils.h"
+#include "mapgen.h"
+#include "parallel.h"
+#include "sssp.h"
+#include "path.h"
+#include "landmarks.h"
+#include "components.h"
+#include "isochrone.h"
+#include "kshortest.h"
+#include "mst.h"
+#include "searchstats.h"
+#include "allocstats.h"
+#include "nodeorder.h"
+#include "compactgraph.h"
+#include "dynamictree.h"
+#include "snapshot.h"
+
+/*
+ * genlib.h renames main to Main so that the CS106 library can set up
+ * the graphics window before the program starts.  This tool has no
+ * window and needs its command-line arguments, so it defines the real
+ * main instead.
+ */
+
+#undef main
+
+/* Constants */
+
+const int KSHORTEST_COUNT = 5;
+const int KSHORTEST_QUERIES = 20;
+const int PQUEUE_SIZE = 2000;
+const string BUNDLED_MAPS[] = { "Small.txt", "USA.txt", "MiddleEarth.txt" };
+const int NUM_BUNDLED_MAPS = sizeof BUNDLED_MAPS / sizeof BUNDLED_MAPS[0];
+
+/*
+ * Type: optionsT
+ * --------------
+ * This type holds the settings from the command line.  The trace,
+ * allocs, and memory fields point to the open output files, or are
+ * NULL if the files were not requested.
+ */
+
+struct optionsT {
+	int nNodes;
+	int seed;
+	int reps;
+	int nQueries;
+	string mapDir;
+	string csvFile;
+	string jsonFile;
+	string baselineFile;
+	double tolerance;
+	string traceFile;
+	ostream *trace;
+	string allocsFile;
+	ostream *allocs;
+	string memoryFile;
+	ostream *memory;
+};
+
+/*
+ * Type: resultT
+ * -------------
+ * This type holds the samples of one measurement, in milliseconds,
+ * together with the names under which it is reported.  The dataset
+ * is the map on which the measurement was taken, or the number of
+ * elements for the container kernels.
+ */
+
+struct resultT {
+	string name;
+	string dataset;
+	Vector<double> samples;
+};
+
+/*
+ * Type: summaryT
+ * --------------
+ * This type holds the statistics reported for each measurement.
+ */
+
+struct summaryT {
+	double min, p50, p90, p99, max, mean;
+};
+
+/*
+ * Class: Timer
+ * ------------
+ * This class measures elapsed wall-clock time.  The constructor starts
+ * the timer, and elapsed returns the milliseconds since then.
+ */
+
+class Timer {
+public:
+	Timer() { gettimeofday(&start, NULL); }
+	double elapsed() {
+		timeval now;
+		gettimeofday(&now, NULL);
+		return (now.tv_sec - start.tv_sec) * 1e3
+		     + (now.tv_usec - start.tv_usec) / 1e3;
+	}
+private:
+	timeval start;
+};
+
+/* Private function prototypes */
+
+static optionsT ParseOptions(int argc, char *argv[]);
+static resultT & NewResult(Vector<resultT> & results, string name,
+                           string dataset);
+static void BenchmarkParse(Vector<resultT> & results, optionsT & options);
+static bool ParseTextMap(string filename, Graph<nodeT,arcT> & graph);
+static void ParseArc(Graph<nodeT,arcT> & graph, Scanner & scanner,
+                     string token, string image);
+static void BenchmarkBuild(Vector<resultT> & results, optionsT & options,
+                           roadShapeT shape, string dataset);
+static void BenchmarkQueries(Vector<resultT> & results, optionsT & options,
+                             roadShapeT shape, string dataset);
+static void BenchmarkOrders(Vector<resultT> & results, optionsT & options,
+                            roadShapeT shape, string dataset);
+static void BenchmarkCompact(Vector<resultT> & results, optionsT & options,
+                             roadShapeT shape, string dataset);
+static void BenchmarkUpdates(Vector<resultT> & results, optionsT & options,
+                             roadShapeT shape, string dataset);
+static void BenchmarkSnapshots(Vector<resultT> & results, optionsT & options,
+                               roadShapeT shape, string dataset);
+static void BenchmarkContainers(Vector<resultT> & results,
+                                optionsT & options);
+static Vector<nodeT *> ChooseQueryNodes(Graph<nodeT,arcT> & graph, int n);
+static void TraceQuery(optionsT & options, string engine, string dataset,
+                       nodeT *start, nodeT *finish, double distance,
+                       searchStatsT & stats);
+static AllocStats *StartAllocCount(optionsT & options);
+static void ReportAllocs(optionsT & options, AllocStats *scope,
+                         resultT & result);
+static summaryT Summarize(Vector<double> samples);
+static double Percentile(Vector<double> & sorted, double fraction);
+static void SortSamples(Vector<double> & samples);
+static void WriteCSV(Vector<resultT> & results, ostream & out);
+static void WriteJSON(Vector<resultT> & results, optionsT & options,
+                      ostream & out);
+static bool CompareBaseline(Vector<resultT> & results, optionsT & options);
+static Vector<string> SplitFields(string line);
+static string FormatNumber(double x);
+static string ShapeName(roadShapeT shape);
+
+/* Main program */
+
+int main(int argc, char *argv[]) {
+	optionsT options = ParseOptions(argc, argv);
+	ofstream traceStream;
+	if (options.traceFile != "") {
+		traceStream.open(options.traceFile.c_str());
+		if (traceStream.fail()) Error("Can't write " + options.traceFile);
+		options.trace = &traceStream;
+	}
+	ofstream allocsStream;
+	if (options.allocsFile != "") {
+		allocsStream.open(options.allocsFile.c_str());
+		if (allocsStream.fail()) Error("Can't write " + options.allocsFile);
+		options.allocs = &allocsStream;
+	}
+	ofstream memoryStream;
+	if (options.memoryFile != "") {
+		memoryStream.open(options.memoryFile.c_str());
+		if (memoryStream.fail()) Error("Can't write " + options.memoryFile);
+		options.memory = &memoryStream;
+	}
+	Vector<resultT> results;
+	BenchmarkParse(results, options);
+	roadShapeT shapes[] = { GRID_ROADS, GEOMETRIC_ROADS, HIGHWAY_ROADS };
+	for (int i = 0; i < 3; i++) {
+		string dataset = ShapeName(shapes[i]) + "-"
+		               + IntegerToString(options.nNodes);
+		BenchmarkBuild(results, options, shapes[i], dataset);
+		BenchmarkQueries(results, options, shapes[i], dataset);
+		BenchmarkOrders(results, options, shapes[i], dataset);
+		BenchmarkCompact(results, options, shapes[i], dataset);
+		BenchmarkUpdates(results, options, shapes[i], dataset);
+		BenchmarkSnapshots(results, options, shapes[i], dataset);
+	}
+	BenchmarkContainers(results, options);
+	WriteCSV(results, cout);
+	if (options.csvFile != "") {
+		ofstream out(options.csvFile.c_str());
+		if (out.fail()) Error("Can't write " + options.csvFile);
+		WriteCSV(results, out);
+	}
+	if (options.jsonFile != "") {
+		ofstream out(options.jsonFile.c_str());
+		if (out.fail()) Error("Can't write " + options.jsonFile);
+		WriteJSON(results, options, out);
+	}
+	if (options.baselineFile != "") {
+		if (!CompareBaseline(results, options)) return 1;
+	}
+	return 0;
+}
+
+/*
+ * Function: ParseOptions
+ * Usage: optionsT options = ParseOptions(argc, argv);
+ * ---------------------------------------------------
+ * Reads the command-line options described at the top of the file.
+ */
+
+static optionsT ParseOptions(int argc, char *argv[]) {
+	optionsT options;
+	options.nNodes = 100000;
+	options.seed = 1;
+	options.reps = 5;
+	options.nQueries = 200;
+	options.mapDir = ".";
+	options.tolerance = 10;
+	options.trace = NULL;
+	options.allocs = NULL;
+	options.memory = NULL;
+	for (int i = 1; i < argc; i++) {
+		string flag = argv[i];
+		if (i + 1 == argc) Error("Missing value for " + flag);
+		string value = argv[++i];
+		if (flag == "--nodes") {
+			options.nNodes = StringToInteger(value);
+		} else if (flag == "--seed") {
+			options.seed = StringToInteger(value);
+		} else if (flag == "--reps") {
+			options.reps = StringToInteger(value);
+		} else if (flag == "--queries") {
+			options.nQueries = StringToInteger(value);
+		} else if (flag == "--maps") {
+			options.mapDir = value;
+		} else if (flag == "--csv") {
+			options.csvFile = value;
+		} else if (flag == "--json") {
+			options.jsonFile = value;
+		} else if (flag == "--baseline") {
+			options.baselineFile = value;
+		} else if (flag == "--tolerance") {
+			options.tolerance = StringToReal(value);
+		} else if (flag == "--trace") {
+			options.traceFile = value;
+		} else if (flag == "--allocs") {
+			options.allocsFile = value;
+		} else if (flag == "--memory") {
+			options.memoryFile = value;
+		} else {
+			Error("Unknown option " + flag);
+		}
+	}
+	if (options.nNodes < 4 || options.reps < 1 || options.nQueries < 1) {
+		Error("The nodes, reps, and queries options are too small");
+	}
+	return options;
+}
+
+/*
+ * Function: NewResult
+ * Usage: resultT & result = NewResult(results, name, dataset);
+ * ------------------------------------------------------------
+ * Adds an empty measurement to results and returns a reference to it,
+ * which remains valid until the next call.
+ */
+
+static resultT & NewResult(Vector<resultT> & results, string name,
+                           string dataset) {
+	resultT result;
+	result.name = name;
+	result.dataset = dataset;
+	results.add(result);
+	return results[results.size() - 1];
+}
+
+/*
+ * Function: BenchmarkParse
+ * Usage: BenchmarkParse(results, options);
+ * ----------------------------------------
+ * Times reading each bundled map and a generated map from the text
+ * format.  The generated map is written to a temporary file first.
+ * Bundled maps that cannot be found are skipped.
+ */
+
+static void BenchmarkParse(Vector<resultT> & results, optionsT & options) {
+	Vector<string> files, datasets;
+	for (int i = 0; i < NUM_BUNDLED_MAPS; i++) {
+		files.add(options.mapDir + "/" + BUNDLED_MAPS[i]);
+		datasets.add(BUNDLED_MAPS[i]);
+	}
+	string tempFile = "benchmark-" + IntegerToString(getpid()) + ".txt";
+	SetRandomSeed(options.seed);
+	roadMapT map;
+	GenerateRoads(map, GRID_ROADS, options.nNodes);
+	WriteTextMap(map, tempFile, "USA.jpg");
+	files.add(tempFile);
+	datasets.add("grid-" + IntegerToString(options.nNodes));
+	for (int i = 0; i < files.size(); i++) {
+		Graph<nodeT,arcT> probe;
+		if (!ParseTextMap(files[i], probe)) continue;
+		resultT & result = NewResult(results, "parse", datasets[i]);
+		for (int rep = 0; rep < options.reps; rep++) {
+			Graph<nodeT,arcT> graph;
+			Timer timer;
+			ParseTextMap(files[i], graph);
+			result.samples.add(timer.elapsed());
+		}
+	}
+	remove(tempFile.c_str());
+}
+
+/*
+ * Function: ParseTextMap
+ * Usage: if (ParseTextMap(filename, graph)) . . .
+ * -----------------------------------------------
+ * Reads a map file into graph, returning false if the file cannot be
+ * opened.  The tokens are read with a Scanner in the same way as by
+ * NewMap in pathfinder.cpp, but nothing is drawn, so that the time
+ * measures only the parsing and the graph operations.
+ */
+
+static bool ParseTextMap(string filename, Graph<nodeT,arcT> & graph) {
+	ifstream infile(filename.c_str());
+	if (infile.fail()) return false;
+	Scanner scanner;
+	scanner.setSpaceOption(Scanner::IgnoreSpaces);
+	scanner.setInput(infile);
+	string image;
+	bool nodes = false, arcs = false;
+	while (scanner.hasMoreTokens()) {
+		string token = scanner.nextToken();
+		if (token == "NODES" || token == "ARCS") {
+			nodes = (token == "NODES");
+			arcs = !nodes;
+			token = scanner.nextToken();
+		}
+		if (!nodes && !arcs) {
+			string dot = scanner.nextToken();
+			image = token + dot + scanner.nextToken();
+		} else if (nodes) {
+			nodeT *node = new nodeT;
+			node->name = token;
+			node->loc.x = StringToInteger(scanner.nextToken());
+			node->loc.y = StringToInteger(scanner.nextToken());
+			graph.addNode(node);
+		} else {
+			ParseArc(graph, scanner, token, image);
+		}
+	}
+	return true;
+}
+
+/*
+ * Function: ParseArc
+ * Usage: ParseArc(graph, scanner, token, image);
+ * ----------------------------------------------
+ * Reads the rest of an arc line whose first token has already been
+ * read and adds the arc in both directions, as NewArcs does.
+ */
+
+static void ParseArc(Graph<nodeT,arcT> & graph, Scanner & scanner,
+                     string token, string image) {
+	nodeT *start = graph.getNode(token);
+	nodeT *finish = graph.getNode(scanner.nextToken());
+	string distance = scanner.nextToken();
+	if (image == "Stanford.jpg") {
+		string dot = scanner.nextToken();
+		distance += dot + scanner.nextToken();
+	}
+	arcT *arc = new arcT;
+	arc->start = start;
+	arc->finish = finish;
+	arc->distance = StringToReal(distance);
+	graph.addArc(arc);
+	arcT *reverse = new arcT;
+	reverse->start = finish;
+	reverse->finish = start;
+	reverse->distance = arc->distance;
+	graph.addArc(reverse);
+}
+
+/*
+ * Function: BenchmarkBuild
+ * Usage: BenchmarkBuild(results, options, shape, dataset);
+ * --------------------------------------------------------
+ * Times building a graph from a generated map with BuildGraph, which
+ * consists entirely of calls to addNode and addArc, and then times
+ * clearing it again, which frees the nodes and arcs.  The memory used
+ * by the first graph built is written to the memory file, if any.
+ */
+
+static void BenchmarkBuild(Vector<resultT> & results, optionsT & options,
+                           roadShapeT shape, string dataset) {
+	SetRandomSeed(options.seed);
+	roadMapT map;
+	GenerateRoads(map, shape, options.nNodes);
+	resultT & build = NewResult(results, "build", dataset);
+	Vector<double> freeTimes;
+	for (int rep = 0; rep < options.reps; rep++) {
+		Graph<nodeT,arcT> graph;
+		Timer timer;
+		BuildGraph(map, graph);
+		build.samples.add(timer.elapsed());
+		if (rep == 0 && options.memory != NULL) {
+			graphMemoryT memory = graph.memoryStats();
+			*options.memory << dataset << endl
+			                << GraphMemoryToString(memory) << endl << endl;
+		}
+		Timer freeTimer;
+		graph.clear();
+		freeTimes.add(freeTimer.elapsed());
+	}
+	NewResult(results, "delete", dataset).samples = freeTimes;
+}
+
+/*
+ * Function: BenchmarkQueries
+ * Usage: BenchmarkQueries(results, options, shape, dataset);
+ * ----------------------------------------------------------
+ * Times the query engines on a generated map.  Point-to-point queries
+ * are timed one at a time, so their percentiles describe the latency
+ * of a single query; the engines that search the whole map are timed
+ * once per repetition.  The delta-stepping engine is timed with every
+ * power of two threads up to the number of processors, and Dijkstra's
+ * algorithm with every kind of priority queue.
+ */
+
+static void BenchmarkQueries(Vector<resultT> & results, optionsT & options,
+                             roadShapeT shape, string dataset) {
+	SetRandomSeed(options.seed);
+	roadMapT map;
+	GenerateRoads(map, shape, options.nNodes);
+	Graph<nodeT,arcT> graph;
+	BuildGraph(map, graph);
+	ComponentIndex components(graph);
+	Vector<nodeT *> ends = ChooseQueryNodes(graph, 2 * options.nQueries);
+
+	resultT & dijkstra = NewResult(results, "path-dijkstra", dataset);
+	SearchSpace workspace;
+	searchStatsT stats;
+	AllocStats *scope = StartAllocCount(options);
+	for (int i = 0; i < options.nQueries; i++) {
+		Path path;
+		path.SetMap(graph);
+		path.SetWorkspace(workspace);
+		path.SetComponents(components);
+		if (options.trace != NULL) path.SetStats(stats);
+		path.SetStart(ends[2 * i]);
+		path.SetFinish(ends[2 * i + 1]);
+		Timer timer;
+		bool found = path.Exists();
+		dijkstra.samples.add(timer.elapsed());
+		if (options.trace != NULL) {
+			TraceQuery(options, "path-dijkstra", dataset, ends[2 * i],
+			           ends[2 * i + 1],
+			           (found) ? path.GetDistance() : UNREACHABLE, stats);
+		}
+	}
+	ReportAllocs(options, scope, dijkstra);
+
+	Landmarks landmarks;
+	Timer selectTimer;
+	landmarks.select(graph);
+	NewResult(results, "landmarks-select", dataset).samples.add(
+	                                                  selectTimer.elapsed());
+	resultT & alt = NewResult(results, "path-alt", dataset);
+	scope = StartAllocCount(options);
+	for (int i = 0; i < options.nQueries; i++) {
+		Path path;
+		path.SetMap(graph);
+		path.SetLandmarks(landmarks);
+		path.SetComponents(components);
+		if (options.trace != NULL) path.SetStats(stats);
+		path.SetStart(ends[2 * i]);
+		path.SetFinish(ends[2 * i + 1]);
+		Timer timer;
+		bool found = path.Exists();
+		alt.samples.add(timer.elapsed());
+		if (options.trace != NULL) {
+			TraceQuery(options, "path-alt", dataset, ends[2 * i],
+			           ends[2 * i + 1],
+			           (found) ? path.GetDistance() : UNREACHABLE, stats);
+		}
+	}
+	ReportAllocs(options, scope, alt);
+
+	resultT & kshortest = NewResult(results, "kshortest", dataset);
+	scope = StartAllocCount(options);
+	for (int i = 0; i < KSHORTEST_QUERIES && i < options.nQueries; i++) {
+		Timer timer;
+		Vector<Path> paths = KShortestPaths(graph, ends[2 * i],
+		                                    ends[2 * i + 1], KSHORTEST_COUNT,
+		                                    &components,
+		                                    (options.trace == NULL) ? NULL
+		                                                            : &stats);
+		kshortest.samples.add(timer.elapsed());
+		if (options.trace != NULL) {
+			TraceQuery(options, "kshortest", dataset, ends[2 * i],
+			           ends[2 * i + 1],
+			           (paths.isEmpty()) ? UNREACHABLE : paths[0].GetDistance(),
+			           stats);
+		}
+	}
+	ReportAllocs(options, scope, kshortest);
+
+	Vector<double> dist;
+	queueKindT kinds[] = { BINARY_HEAP, RADIX_HEAP, DIAL_BUCKETS };
+	string kindNames[] = { "binary", "radix", "dial" };
+	for (int k = 0; k < 3; k++) {
+		resultT & sssp = NewResult(results, "sssp-" + kindNames[k], dataset);
+		for (int rep = 0; rep < options.reps; rep++) {
+			Timer timer;
+			DijkstraDistances(graph, ends[rep % ends.size()], dist, kinds[k]);
+			sssp.samples.add(timer.elapsed());
+		}
+	}
+
+	int maxThreads = GetProcessorCount();
+	for (int nThreads = 1; ; nThreads *= 2) {
+		if (nThreads > maxThreads) nThreads = maxThreads;
+		resultT & delta = NewResult(results, "delta-stepping-"
+		                            + IntegerToString(nThreads), dataset);
+		for (int rep = 0; rep < options.reps; rep++) {
+			Timer timer;
+			DeltaSteppingDistances(graph, ends[rep % ends.size()], dist,
+			                       nThreads);
+			delta.samples.add(timer.elapsed());
+		}
+		if (nThreads == maxThreads) break;
+	}
+
+	DijkstraDistances(graph, ends[0], dist);
+	double farthest = 0;
+	for (int i = 0; i < dist.size(); i++) {
+		if (dist[i] != UNREACHABLE && dist[i] > farthest) farthest = dist[i];
+	}
+	resultT & isochrone = NewResult(results, "isochrone", dataset);
+	for (int rep = 0; rep < options.reps; rep++) {
+		Isochrone search;
+		nodeT *node;
+		double d;
+		Timer timer;
+		search.start(graph, ends[rep % ends.size()], farthest / 4);
+		while (search.next(node, d)) {
+			/* Empty */
+		}
+		isochrone.samples.add(timer.elapsed());
+	}
+
+	resultT & mst = NewResult(results, "mst", dataset);
+	for (int rep = 0; rep < options.reps; rep++) {
+		Vector<arcT *> tree;
+		Timer timer;
+		MinimumSpanningForest(graph, tree);
+		mst.samples.add(timer.elapsed());
+	}
+}
+
+/*
+ * Function: BenchmarkOrders
+ * Usage: BenchmarkOrders(results, options, shape, dataset);
+ * ---------------------------------------------------------
+ * Times Dijkstra's algorithm over the whole of a generated map whose
+ * nodes have first been shuffled, which stands in for a map file that
+ * lists its nodes in no useful order, and then again after the graph
+ * is rebuilt in each of the orders from nodeorder.h.  The time taken
+ * by ReorderGraph is measured as well.  Every search starts from the
+ * same node, so the samples differ only in the memory layout.
+ */
+
+static void BenchmarkOrders(Vector<resultT> & results, optionsT & options,
+                            roadShapeT shape, string dataset) {
+	SetRandomSeed(options.seed);
+	roadMapT map;
+	GenerateRoads(map, shape, options.nNodes);
+	Graph<nodeT,arcT> graph;
+	BuildGraph(map, graph);
+	Vector<nodeT *> order;
+	for (int i = 0; i < graph.size(); i++) {
+		order.add(graph.getNodeByIndex(i));
+	}
+	for (int i = order.size() - 1; i > 0; i--) {
+		int j = RandomInteger(0, i);
+		nodeT *tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+	graph.reorderNodes(order);
+	Graph<nodeT,arcT> shuffled(graph);
+	graph.swap(shuffled);
+	shuffled.clear();
+	string source = ChooseQueryNodes(graph, 1)[0]->name;
+	Vector<double> dist;
+	resultT & before = NewResult(results, "sssp-shuffled", dataset);
+	for (int rep = 0; rep < options.reps; rep++) {
+		Timer timer;
+		DijkstraDistances(graph, graph.getNode(source), dist);
+		before.samples.add(timer.elapsed());
+	}
+	nodeOrderT methods[] = { HILBERT_ORDER, BFS_ORDER, RCM_ORDER };
+	string methodNames[] = { "hilbert", "bfs", "rcm" };
+	for (int k = 0; k < 3; k++) {
+		resultT & reorder = NewResult(results, "reorder-" + methodNames[k],
+		                              dataset);
+		Timer reorderTimer;
+		ReorderGraph(graph, methods[k]);
+		reorder.samples.add(reorderTimer.elapsed());
+		resultT & after = NewResult(results, "sssp-" + methodNames[k],
+		                            dataset);
+		for (int rep = 0; rep < options.reps; rep++) {
+			Timer timer;
+			DijkstraDistances(graph, graph.getNode(source), dist);
+			after.samples.add(timer.elapsed());
+		}
+	}
+}
+
+/*
+ * Function: BenchmarkCompact
+ * Usage: BenchmarkCompact(results, options, shape, dataset);
+ * ----------------------------------------------------------
+ * Times the construction of a CompactGraph from a generated map in
+ * the order chosen by ReorderGraph, and then Dijkstra's algorithm over
+ * the whole map on the Graph and on the compact copy, starting from
+ * the same node.  If a memory file was requested, the function writes
+ * the memory used by the compact copy to it, along with the ratio of
+ * the median search times.
+ */
+
+static void BenchmarkCompact(Vector<resultT> & results, optionsT & options,
+                             roadShapeT shape, string dataset) {
+	SetRandomSeed(options.seed);
+	roadMapT map;
+	GenerateRoads(map, shape, options.nNodes);
+	Graph<nodeT,arcT> graph;
+	BuildGraph(map, graph);
+	ReorderGraph(graph);
+	nodeT *source = ChooseQueryNodes(graph, 1)[0];
+	CompactGraph compact;
+	resultT & build = NewResult(results, "compact-build", dataset);
+	for (int rep = 0; rep < options.reps; rep++) {
+		Timer timer;
+		compact.build(graph);
+		build.samples.add(timer.elapsed());
+	}
+	Vector<double> dist;
+	resultT & before = NewResult(results, "sssp-graph", dataset);
+	for (int rep = 0; rep < options.reps; rep++) {
+		Timer timer;
+		DijkstraDistances(graph, source, dist);
+		before.samples.add(timer.elapsed());
+	}
+	double graphMedian = Summarize(before.samples).p50;
+	resultT & after = NewResult(results, "sssp-compact", dataset);
+	for (int rep = 0; rep < options.reps; rep++) {
+		Timer timer;
+		DijkstraDistances(compact, source->index, dist);
+		after.samples.add(timer.elapsed());
+	}
+	if (options.memory != NULL) {
+		graphMemoryT memory = compact.memoryStats();
+		double slowdown = Summarize(after.samples).p50 / graphMedian;
+		*options.memory << dataset << " (compact)" << endl
+		                << GraphMemoryToString(memory) << endl
+		                << "Compression ratio: "
+		                << FormatNumber(compact.getCompressionRatio()) << endl
+		                << "Graph size ratio: "
+		                << FormatNumber(double(graph.memoryStats().totalBytes)
+		                                / memory.totalBytes) << endl
+		                << "Traversal slowdown: " << FormatNumber(slowdown)
+		                << endl << endl;
+	}
+}
+
+/*
+ * Function: BenchmarkUpdates
+ * Usage: BenchmarkUpdates(results, options, shape, dataset);
+ * ----------------------------------------------------------
+ * Times the computation of a shortest-path tree over the whole of a
+ * generated map and then the repair of that tree by a DynamicTree
+ * after each of a series of changes to arc distances, one change per
+ * query.  Each change doubles or halves the distance of a randomly
+ * chosen arc, so about half of them make arcs longer and half shorter.
+ */
+
+static void BenchmarkUpdates(Vector<resultT> & results, optionsT & options,
+                             roadShapeT shape, string dataset) {
+	SetRandomSeed(options.seed);
+	roadMapT map;
+	GenerateRoads(map, shape, options.nNodes);
+	Graph<nodeT,arcT> graph;
+	BuildGraph(map, graph);
+	nodeT *source = ChooseQueryNodes(graph, 1)[0];
+	resultT & build = NewResult(results, "tree-build", dataset);
+	DynamicTree tree;
+	for (int rep = 0; rep < options.reps; rep++) {
+		Timer timer;
+		tree.attach(graph, source);
+		build.samples.add(timer.elapsed());
+	}
+	resultT & repair = NewResult(results, "tree-repair", dataset);
+	for (int i = 0; i < options.nQueries; i++) {
+		nodeT *node = graph.getNodeByIndex(RandomInteger(0, graph.size() - 1));
+		if (node->arcs.isEmpty()) continue;
+		arcT *arc = node->arcs[RandomInteger(0, node->arcs.size() - 1)];
+		double factor = (RandomChance(0.5)) ? 2 : 0.5;
+		Timer timer;
+		graph.updateArcWeight(arc, arc->distance * factor);
+		repair.samples.add(timer.elapsed());
+	}
+}
+
+/*
+ * Function: BenchmarkSnapshots
+ * Usage: BenchmarkSnapshots(results, options, shape, dataset);
+ * ------------------------------------------------------------
+ * Times the building of a SnapshotStore from a generated map, the
+ * publication of a version that changes the distance of one randomly
+ * chosen arc, once per query, and a search over the whole map on a
+ * pinned snapshot, which can be compared with sssp-compact.
+ */
+
+static void BenchmarkSnapshots(Vector<resultT> & results, optionsT & options,
+                               roadShapeT shape, string dataset) {
+	SetRandomSeed(options.seed);
+	roadMapT map;
+	GenerateRoads(map, shape, options.nNodes);
+	Graph<nodeT,arcT> graph;
+	BuildGraph(map, graph);
+	int source = ChooseQueryNodes(graph, 1)[0]->index;
+	SnapshotStore store;
+	resultT & build = NewResult(results, "snapshot-build", dataset);
+	for (int rep = 0; rep < options.reps; rep++) {
+		Timer timer;
+		store.build(graph);
+		build.samples.add(timer.elapsed());
+	}
+	resultT & publish = NewResult(results, "snapshot-publish", dataset);
+	for (int i = 0; i < options.nQueries; i++) {
+		nodeT *node = graph.getNodeByIndex(RandomInteger(0, graph.size() - 1));
+		if (node->arcs.isEmpty()) continue;
+		arcT *arc = node->arcs[RandomInteger(0, node->arcs.size() - 1)];
+		SnapshotUpdate update;
+		update.setArcWeight(arc, arc->distance * RandomInteger(1, 3));
+		Timer timer;
+		store.publish(update);
+		publish.samples.add(timer.elapsed());
+	}
+	resultT & search = NewResult(results, "sssp-snapshot", dataset);
+	Vector<double> dist;
+	for (int rep = 0; rep < options.reps; rep++) {
+		Timer timer;
+		GraphSnapshot *snapshot = store.acquire();
+		DijkstraDistances(*snapshot, source, dist);
+		store.release(snapshot);
+		search.samples.add(timer.elapsed());
+	}
+}
+
+/*
+ * Function: BenchmarkContainers
+ * Usage: BenchmarkContainers(results, options);
+ * ---------------------------------------------
+ * Times the basic operations of the CS106 containers on as many
+ * elements as the generated maps have nodes.  PQueue is timed on
+ * PQUEUE_SIZE elements instead, since inserting into its sorted
+ * vector takes linear time.  All of the results are added before any
+ * of them is used, because adding a result may move the others.
+ */
+
+static void BenchmarkContainers(Vector<resultT> & results,
+                                optionsT & options) {
+	int n = options.nNodes;
+	string dataset = IntegerToString(n);
+	Vector<string> keys;
+	for (int i = 0; i < n; i++) {
+		keys.add("n" + IntegerToString(i));
+	}
+	int first = results.size();
+	NewResult(results, "vector-add", dataset);
+	NewResult(results, "vector-get", dataset);
+	NewResult(results, "map-put", dataset);
+	NewResult(results, "map-get", dataset);
+	NewResult(results, "set-add", dataset);
+	NewResult(results, "set-contains", dataset);
+	NewResult(results, "pqueue-enqueue-dequeue", IntegerToString(PQUEUE_SIZE));
+	resultT & vectorAdd = results[first];
+	resultT & vectorGet = results[first + 1];
+	resultT & mapPut = results[first + 2];
+	resultT & mapGet = results[first + 3];
+	resultT & setAdd = results[first + 4];
+	resultT & setContains = results[first + 5];
+	resultT & pqueue = results[first + 6];
+	long checksum = 0;
+	for (int rep = 0; rep < options.reps; rep++) {
+		Vector<int> vec;
+		Timer addTimer;
+		for (int i = 0; i < n; i++) {
+			vec.add(i);
+		}
+		vectorAdd.samples.add(addTimer.elapsed());
+		Timer getTimer;
+		for (int i = 0; i < n; i++) {
+			checksum += vec[int(i * 7919L % n)];
+		}
+		vectorGet.samples.add(getTimer.elapsed());
+
+		Map<int> map;
+		Timer putTimer;
+		for (int i = 0; i < n; i++) {
+			map.put(keys[i], i);
+		}
+		mapPut.samples.add(putTimer.elapsed());
+		Timer mapGetTimer;
+		for (int i = 0; i < n; i++) {
+			checksum += map.get(keys[int(i * 7919L % n)]);
+		}
+		mapGet.samples.add(mapGetTimer.elapsed());
+
+		Set<int> set;
+		Timer setAddTimer;
+		for (int i = 0; i < n; i++) {
+			set.add(int(i * 7919L % n));
+		}
+		setAdd.samples.add(setAddTimer.elapsed());
+		Timer containsTimer;
+		for (int i = 0; i < n; i++) {
+			if (set.contains(i)) checksum++;
+		}
+		setContains.samples.add(containsTimer.elapsed());
+
+		PQueue<int> queue;
+		Timer queueTimer;
+		for (int i = 0; i < PQUEUE_SIZE; i++) {
+			queue.enqueue(i, (i * 7919) % PQUEUE_SIZE);
+		}
+		while (!queue.isEmpty()) {
+			checksum += queue.dequeue();
+		}
+		pqueue.samples.add(queueTimer.elapsed());
+	}
+	if (checksum == 0) cerr << "Unexpected checksum" << endl;
+}
+
+/*
+ * Function: ChooseQueryNodes
+ * Usage: Vector<nodeT *> ends = ChooseQueryNodes(graph, n);
+ * ---------------------------------------------------------
+ * Returns n nodes chosen at random, which the caller uses in pairs as
+ * the endpoints of queries.
+ */
+
+static Vector<nodeT *> ChooseQueryNodes(Graph<nodeT,arcT> & graph, int n) {
+	Vector<nodeT *> ends;
+	for (int i = 0; i < n; i++) {
+		ends.add(graph.getNodeByIndex(RandomInteger(0, graph.size() - 1)));
+	}
+	return ends;
+}
+
+/*
+ * Function: TraceQuery
+ * Usage: TraceQuery(options, engine, dataset, start, finish, distance,
+ *                   stats);
+ * --------------------------------------------------------------------
+ * Writes one line to the trace file describing a query.  The distance
+ * of a query with no answer is written as null.
+ */
+
+static void TraceQuery(optionsT & options, string engine, string dataset,
+                       nodeT *start, nodeT *finish, double distance,
+                       searchStatsT & stats) {
+	ostream & out = *options.trace;
+	out << "{\"engine\": \"" << engine << "\", \"dataset\": \"" << dataset
+	    << "\", \"start\": \"" << start->name << "\", \"finish\": \""
+	    << finish->name << "\", \"distance\": ";
+	if (distance == UNREACHABLE) {
+		out << "null";
+	} else {
+		out << distance;
+	}
+	out << ", \"stats\": " << SearchStatsToJSON(stats) << "}" << endl;
+}
+
+/*
+ * Functions: StartAllocCount, ReportAllocs
+ * Usage: AllocStats *scope = StartAllocCount(options);
+ *        ReportAllocs(options, scope, result);
+ * ----------------------------------------------------
+ * These functions count the allocations made by the queries of one
+ * measurement.  StartAllocCount turns counting on if an allocation
+ * file was requested and otherwise returns NULL.  ReportAllocs writes
+ * the counts to the file, with the mean per sample, and frees scope.
+ */
+
+static AllocStats *StartAllocCount(optionsT & options) {
+	return (options.allocs == NULL) ? NULL : new AllocStats();
+}
+
+static void ReportAllocs(optionsT & options, AllocStats *scope,
+                         resultT & result) {
+	if (scope == NULL) return;
+	ostream & out = *options.allocs;
+	int n = result.samples.size();
+	out << result.name << " " << result.dataset << ": " << n
+	    << " queries, "
+	    << FormatNumber(scope->getAllocCount() / double(n))
+	    << " allocations per query" << endl;
+	scope->report(out);
+	out << endl;
+	delete scope;
+}
+
+/*
+ * Function: Summarize
+ * Usage: summaryT summary = Summarize(samples);
+ * ---------------------------------------------
+ * Computes the statistics of a nonempty list of samples.  The samples
+ * are passed by value because they have to be sorted.
+ */
+
+static summaryT Summarize(Vector<double> samples) {
+	SortSamples(samples);
+	summaryT summary;
+	summary.min = samples[0];
+	summary.p50 = Percentile(samples, 0.50);
+	summary.p90 = Percentile(samples, 0.90);
+	summary.p99 = Percentile(samples, 0.99);
+	summary.max = samples[samples.size() - 1];
+	double total = 0;
+	for (int i = 0; i < samples.size(); i++) {
+		total += samples[i];
+	}
+	summary.mean = total / samples.size();
+	return summary;
+}
+
+/*
+ * Function: Percentile
+ * Usage: double p = Percentile(sorted, fraction);
+ * -----------------------------------------------
+ * Returns the specified percentile of the sorted samples, interpolating
+ * linearly between the two nearest samples.
+ */
+
+static double Percentile(Vector<double> & sorted, double fraction) {
+	double pos = fraction * (sorted.size() - 1);
+	int lower = int(floor(pos));
+	if (lower + 1 >= sorted.size()) return sorted[sorted.size() - 1];
+	return sorted[lower] + (pos - lower) * (sorted[lower + 1] - sorted[lower]);
+}
+
+/*
+ * Function: SortSamples
+ * Usage: SortSamples(samples);
+ * ----------------------------
+ * Sorts the samples into increasing order using insertion sort, which
+ * is fast enough for the few hundred samples of a measurement.
+ */
+
+static void SortSamples(Vector<double> & samples) {
+	for (int i = 1; i < samples.size(); i++) {
+		double x = samples[i];
+		int j = i;
+		while (j > 0 && samples[j - 1] > x) {
+			samples[j] = samples[j - 1];
+			j--;
+		}
+		samples[j] = x;
+	}
+}
+
+/*
+ * Functions: WriteCSV, WriteJSON
+ * Usage: WriteCSV(results, out);
+ *        WriteJSON(results, options, out);
+ * ----------------------------------------
+ * These functions write the statistics of every measurement, in
+ * milliseconds.  The JSON form also records the options of the run.
+ */
+
+static void WriteCSV(Vector<resultT> & results, ostream & out) {
+	out << "name,dataset,samples,min,p50,p90,p99,max,mean" << endl;
+	for (int i = 0; i < results.size(); i++) {
+		if (results[i].samples.isEmpty()) continue;
+		summaryT s = Summarize(results[i].samples);
+		out << results[i].name << "," << results[i].dataset << ","
+		    << results[i].samples.size() << "," << FormatNumber(s.min) << ","
+		    << FormatNumber(s.p50) << "," << FormatNumber(s.p90) << ","
+		    << FormatNumber(s.p99) << "," << FormatNumber(s.max) << ","
+		    << FormatNumber(s.mean) << endl;
+	}
+}
+
+static void WriteJSON(Vector<resultT> & results, optionsT & options,
+                      ostream & out) {
+	out << "{" << endl;
+	out << "  \"nodes\": " << options.nNodes << "," << endl;
+	out << "  \"seed\": " << options.seed << "," << endl;
+	out << "  \"reps\": " << options.reps << "," << endl;
+	out << "  \"queries\": " << options.nQueries << "," << endl;
+	out << "  \"threads\": " << GetProcessorCount() << "," << endl;
+	out << "  \"unit\": \"ms\"," << endl;
+	out << "  \"results\": [";
+	bool first = true;
+	for (int i = 0; i < results.size(); i++) {
+		if (results[i].samples.isEmpty()) continue;
+		summaryT s = Summarize(results[i].samples);
+		out << (first ? "" : ",") << endl;
+		out << "    {\"name\": \"" << results[i].name << "\", "
+		    << "\"dataset\": \"" << results[i].dataset << "\", "
+		    << "\"samples\": " << results[i].samples.size() << ", "
+		    << "\"min\": " << FormatNumber(s.min) << ", "
+		    << "\"p50\": " << FormatNumber(s.p50) << ", "
+		    << "\"p90\": " << FormatNumber(s.p90) << ", "
+		    << "\"p99\": " << FormatNumber(s.p99) << ", "
+		    << "\"max\": " << FormatNumber(s.max) << ", "
+		    << "\"mean\": " << FormatNumber(s.mean) << "}";
+		first = false;
+	}
+	out << endl << "  ]" << endl << "}" << endl;
+}
+
+/*
+ * Function: CompareBaseline
+ * Usage: if (CompareBaseline(results, options)) . . .
+ * ---------------------------------------------------
+ * Compares the median of each measurement with the median of the
+ * measurement with the same name and dataset in the baseline file and
+ * prints the change.  Slowdowns beyond the tolerance are marked as
+ * regressions, and the function returns false if there are any.
+ * Measurements missing from either side are listed but do not count
+ * as regressions.
+ */
+
+static bool CompareBaseline(Vector<resultT> & results, optionsT & options) {
+	ifstream infile(options.baselineFile.c_str());
+	if (infile.fail()) Error("Can't read " + options.baselineFile);
+	Map<double> baseline;
+	string line;
+	getline(infile, line);
+	while (getline(infile, line)) {
+		Vector<string> fields = SplitFields(line);
+		if (fields.size() < 5) continue;
+		baseline.put(fields[0] + "," + fields[1], StringToReal(fields[4]));
+	}
+	int nRegressions = 0;
+	cout << endl << "Comparison of medians with " << options.baselineFile
+	     << endl;
+	for (int i = 0; i < results.size(); i++) {
+		if (results[i].samples.isEmpty()) continue;
+		string key = results[i].name + "," + results[i].dataset;
+		double now = Summarize(results[i].samples).p50;
+		if (!baseline.containsKey(key)) {
+			cout << "  new         " << key << endl;
+			continue;
+		}
+		double before = baseline.get(key);
+		baseline.remove(key);
+		double change = (before > 0) ? 100 * (now - before) / before : 0;
+		string status = "  ok          ";
+		if (change > options.tolerance) {
+			status = "  REGRESSION  ";
+			nRegressions++;
+		} else if (change < -options.tolerance) {
+			status = "  improved    ";
+		}
+		cout << status << key << ": " << FormatNumber(before) << " -> "
+		     << FormatNumber(now) << " ms (" << (change > 0 ? "+" : "")
+		     << FormatNumber(change) << "%)" << endl;
+	}
+	foreach (string key in baseline) {
+		cout << "  missing     " << key << endl;
+	}
+	cout << nRegressions << " regression" << (nRegressions == 1 ? "" : "s")
+	     << " beyond " << options.tolerance << "%" << endl;
+	return nRegressions == 0;
+}
+
+/*
+ * Function: SplitFields
+ * Usage: Vector<string> fields = SplitFields(line);
+ * -------------------------------------------------
+ * Splits a line of a CSV file at its commas.
+ */
+
+static Vector<string> SplitFields(string line) {
+	Vector<string> fields;
+	string::size_type start = 0;
+	while (true) {
+		string::size_type comma = line.find(',', start);
+		if (comma == string::npos) break;
+		fields.add(line.substr(start, comma - start));
+		start = comma + 1;
+	}
+	fields.add(line.substr(start));
+	return fields;
+}
+
+static string FormatNumber(double x) {
+	char buffer[32];
+	sprintf(buffer, "%.4g", x);
+	return buffer;
+}
+
+static string ShapeName(roadShapeT shape) {
+	switch (shape) {
+	  case GRID_ROADS: return "grid";
+	  case GEOMETRIC_ROADS: return "geometric";
+	  case HIGHWAY_ROADS: return "highway";
+	}
+	return "unknown";
+}
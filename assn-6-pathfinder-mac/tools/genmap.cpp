@@ -0,0 +1,92 @@
+/*
+ * File: genmap.cpp
+ * ----------------
+ * This program writes a synthetic road map for benchmarking, using the
+ * generator in mapgen.h.  It is a command-line tool rather than part of
+ * the Pathfinder application and is run as
+ *
+ *     genmap shape nodes seed filename [threads]
+ *
+ * where shape is grid, geometric, or highway.  A filename ending in .bin
+ * is written in the binary format; any other name gets the text format
+ * read by the Pathfinder application, with USA.jpg as the background.
+ * The same shape, number of nodes, and seed always give the same map.
+ *
+ * The tool is built from this file together with mapgen.cpp and
+ * parallel.cpp in the parent directory and the CS106 library, e.g.
+ *
+ *     g++ -O2 -I.. -I../cs106 genmap.cpp ../mapgen.cpp ../parallel.cpp \
+ *         ../cs106/libcs106.a -lpthread -o genmap
+ */
+
+#include <iostream>
+#include <sys/time.h>
+#include "genlib.h"
+#include "mapgen.h"
+#include "random.h"
+#include "strutils.h"
+
+/*
+ * genlib.h renames main to Main so that the CS106 library can set up
+ * the graphics window before the program starts.  This tool has no
+ * window and needs its command-line arguments, so it defines the real
+ * main instead.
+ */
+
+#undef main
+
+/* Private function prototypes */
+
+static roadShapeT ParseShape(string name);
+static bool EndsWith(string str, string suffix);
+static double ElapsedSeconds(timeval & start);
+
+/* Main program */
+
+int main(int argc, char *argv[]) {
+	if (argc < 5 || argc > 6) {
+		cerr << "Usage: genmap grid|geometric|highway nodes seed filename "
+		     << "[threads]" << endl;
+		return 1;
+	}
+	roadShapeT shape = ParseShape(argv[1]);
+	int nNodes = StringToInteger(argv[2]);
+	int seed = StringToInteger(argv[3]);
+	string filename = argv[4];
+	int nThreads = (argc == 6) ? StringToInteger(argv[5]) : 0;
+	timeval start;
+	gettimeofday(&start, NULL);
+	SetRandomSeed(seed);
+	roadMapT map;
+	GenerateRoads(map, shape, nNodes, nThreads);
+	double genTime = ElapsedSeconds(start);
+	gettimeofday(&start, NULL);
+	if (EndsWith(filename, ".bin")) {
+		WriteBinaryMap(map, filename);
+	} else {
+		WriteTextMap(map, filename, "USA.jpg", nThreads);
+	}
+	cout << map.locs.size() << " nodes, " << map.roads.size() << " roads; "
+	     << "generated in " << genTime << " s, written in "
+	     << ElapsedSeconds(start) << " s" << endl;
+	return 0;
+}
+
+static roadShapeT ParseShape(string name) {
+	if (name == "grid") return GRID_ROADS;
+	if (name == "geometric") return GEOMETRIC_ROADS;
+	if (name == "highway") return HIGHWAY_ROADS;
+	Error("Unknown shape " + name);
+	return GRID_ROADS;
+}
+
+static bool EndsWith(string str, string suffix) {
+	return str.length() >= suffix.length()
+	    && str.substr(str.length() - suffix.length()) == suffix;
+}
+
+static double ElapsedSeconds(timeval & start) {
+	timeval now;
+	gettimeofday(&now, NULL);
+	return (now.tv_sec - start.tv_sec) + (now.tv_usec - start.tv_usec) / 1e6;
+}
@@ -0,0 +1,229 @@
+/*
+ * File: treecache.cpp
+ * -------------------
+ * This file implements the treecache.h interface.
+ */
+
+#include "genlib.h"
+#include "treecache.h"
+#include "sssp.h"
+
+TreeCache::TreeCache(int capacity) {
+	if (capacity < 1) Error("TreeCache: capacity must be at least 1");
+	this->capacity = capacity;
+	graph = NULL;
+	graphVersion = 0;
+	clock = 0;
+	nHits = nMisses = 0;
+	nRepairs = 0;
+}
+
+TreeCache::~TreeCache() {
+	detach();
+	clear();
+}
+
+void TreeCache::attach(Graph<nodeT,arcT> & graph) {
+	detach();
+	this->graph = &graph;
+	graph.addListener(this);
+}
+
+void TreeCache::detach() {
+	if (graph != NULL) graph->removeListener(this);
+	graph = NULL;
+}
+
+int TreeCache::size() {
+	return trees.size();
+}
+
+int TreeCache::getCapacity() {
+	return capacity;
+}
+
+void TreeCache::clear() {
+	for (int i = 0; i < trees.size(); i++) {
+		delete trees[i];
+	}
+	trees.clear();
+}
+
+double TreeCache::getDistance(Graph<nodeT,arcT> & graph, nodeT *source,
+                              nodeT *target, searchStatsT *stats,
+                              SearchControl *control) {
+	if (control != NULL) control->begin();
+	treeT *tree = lookup(graph, source, stats, control);
+	if (control != NULL && control->isStopped()) return UNREACHABLE;
+	return tree->dist[target->index];
+}
+
+/*
+ * Implementation notes: getPath
+ * -----------------------------
+ * The parent arcs lead backward from the target to the source, so the
+ * path is collected in reverse order and then turned around.
+ */
+
+Vector<arcT *> TreeCache::getPath(Graph<nodeT,arcT> & graph, nodeT *source,
+                                  nodeT *target) {
+	treeT *tree = lookup(graph, source);
+	Vector<arcT *> reversed;
+	for (arcT *arc = tree->parent[target->index]; arc != NULL;
+	     arc = tree->parent[arc->start->index]) {
+		reversed.add(arc);
+	}
+	Vector<arcT *> path(reversed.size());
+	for (int i = reversed.size() - 1; i >= 0; i--) {
+		path.add(reversed[i]);
+	}
+	return path;
+}
+
+int TreeCache::getHitCount() {
+	return nHits;
+}
+
+int TreeCache::getMissCount() {
+	return nMisses;
+}
+
+int TreeCache::getRepairCount() {
+	return nRepairs;
+}
+
+/*
+ * Implementation notes: listener methods
+ * --------------------------------------
+ * Each method that brings the trees up to date first calls
+ * adoptVersion, which discards the trees instead if the graph changed
+ * without telling the cache.  A new node is unreachable in every tree.
+ * Removing a node may remove the source of a tree and renumbers
+ * another node, so it discards every tree, as do the changes reported
+ * by graphReset.  Trees left behind by a stopped search belong to no
+ * source and are not repaired.
+ */
+
+void TreeCache::nodeAdded(nodeT *node) {
+	if (!adoptVersion()) return;
+	for (int i = 0; i < trees.size(); i++) {
+		if (trees[i]->source != NULL) {
+			trees[i]->dist.add(UNREACHABLE);
+			trees[i]->parent.add(NULL);
+		}
+	}
+}
+
+void TreeCache::nodeRemoved(nodeT *node) {
+	clear();
+}
+
+void TreeCache::arcAdded(arcT *arc) {
+	repairTrees(arc, UNREACHABLE);
+}
+
+void TreeCache::arcRemoved(arcT *arc) {
+	repairTrees(arc, arc->distance);
+}
+
+void TreeCache::arcWeightChanged(arcT *arc, double oldDistance) {
+	repairTrees(arc, oldDistance);
+}
+
+void TreeCache::graphReset() {
+	clear();
+}
+
+/*
+ * Private method: lookup
+ * Usage: treeT *tree = lookup(graph, source);
+ *        treeT *tree = lookup(graph, source, stats, control);
+ * -----------------------------------------------------------
+ * Returns the tree for source, computing it if necessary and reporting
+ * the work in stats if that pointer is not NULL.  The cache
+ * holds only a handful of trees, so a linear search is faster than any
+ * more elaborate structure, and the least recently used tree is found
+ * the same way.  If control stops the computation, the tree is marked
+ * as belonging to no source and as the least recently used, so that no
+ * lookup can find it and the next miss reuses its storage.
+ */
+
+TreeCache::treeT *TreeCache::lookup(Graph<nodeT,arcT> & graph, nodeT *source,
+                                    searchStatsT *stats,
+                                    SearchControl *control) {
+	if (stats != NULL) ClearSearchStats(*stats);
+	if (this->graph != NULL && this->graph != &graph) {
+		Error("TreeCache: The cache is attached to a different graph");
+	}
+	if (graph.getVersion() != graphVersion) {
+		clear();
+		graphVersion = graph.getVersion();
+	}
+	clock++;
+	for (int i = 0; i < trees.size(); i++) {
+		if (trees[i]->source == source) {
+			trees[i]->lastUsed = clock;
+			nHits++;
+			return trees[i];
+		}
+	}
+	nMisses++;
+	treeT *tree;
+	if (trees.size() < capacity) {
+		tree = new treeT;
+		trees.add(tree);
+	} else {
+		tree = trees[0];
+		for (int i = 1; i < trees.size(); i++) {
+			if (trees[i]->lastUsed < tree->lastUsed) tree = trees[i];
+		}
+	}
+	tree->source = source;
+	tree->lastUsed = clock;
+	DijkstraTree(graph, source, tree->dist, tree->parent, AUTO_QUEUE, stats,
+	             control);
+	if (control != NULL && control->isStopped()) {
+		tree->source = NULL;
+		tree->lastUsed = 0;
+	}
+	return tree;
+}
+
+/*
+ * Private method: repairTrees
+ * Usage: repairTrees(arc, oldDistance);
+ * -------------------------------------
+ * Repairs every stored tree after a change to arc.
+ */
+
+void TreeCache::repairTrees(arcT *arc, double oldDistance) {
+	if (!adoptVersion()) return;
+	for (int i = 0; i < trees.size(); i++) {
+		if (trees[i]->source != NULL) {
+			RepairTree(*graph, trees[i]->dist, trees[i]->parent, arc,
+			           oldDistance);
+			nRepairs++;
+		}
+	}
+}
+
+/*
+ * Private method: adoptVersion
+ * Usage: if (adoptVersion()) . . .
+ * --------------------------------
+ * Called by a listener method before it brings the trees up to date.
+ * If the trees matched the graph just before the change being
+ * reported, the cache records the new version, which keeps the next
+ * lookup from discarding them, and the method returns true.  If not,
+ * the graph also changed in some way the cache was not told about, so
+ * the method discards the trees and returns false.
+ */
+
+bool TreeCache::adoptVersion() {
+	if (graphVersion != graph->getPreviousVersion()) {
+		clear();
+		return false;
+	}
+	graphVersion = graph->getVersion();
+	return true;
+}
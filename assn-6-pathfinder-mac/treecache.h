@@ -0,0 +1,203 @@
+/*
+ * File: treecache.h
+ * -----------------
+ * This file provides the interface to the TreeCache class, which
+ * remembers complete shortest-path trees for the most recently used
+ * source nodes.  In the interactive application, the user typically
+ * chooses one starting point and then tries several destinations.
+ * The first query from a source computes the tree of shortest paths
+ * from that source to every node; later queries from the same source
+ * are answered by following parent arcs from the destination, which
+ * takes time proportional to the length of the path.  A cache that is
+ * attached to its graph keeps its trees through changes to the arcs,
+ * which lets traffic updates arrive between queries without throwing
+ * away the work already done.
+ */
+
+#ifndef _treecache_h
+#define _treecache_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "vector.h"
+#include "graph.h"
+#include "graphtypes.h"
+#include "searchstats.h"
+#include "searchcontrol.h"
+
+/*
+ * Constant: DEFAULT_TREE_CACHE_SIZE
+ * ---------------------------------
+ * The number of trees kept by a TreeCache if the client does not
+ * specify a capacity.  Each tree takes space proportional to the
+ * number of nodes in the graph.
+ */
+
+const int DEFAULT_TREE_CACHE_SIZE = 8;
+
+/*
+ * Class: TreeCache
+ * ----------------
+ * This class stores shortest-path trees keyed by source node.  When
+ * the cache is full, adding a tree discards the one that was used
+ * least recently.  Each method takes the graph as a parameter and
+ * compares its version, as described in graph.h, with the version of
+ * the graph from which the stored trees were computed; if the graph
+ * has changed in any way, every stored tree is discarded first.  As
+ * a result, the client never sees a path that is out of date, as long
+ * as any change to an arc distance is followed by a call to the
+ * graph's markChanged method.
+ *
+ * A cache that has been attached to the graph registers itself as a
+ * listener.  When an arc is added or removed, or its distance changes
+ * through the graph's updateArcWeight method, the attached cache
+ * repairs each stored tree with RepairTree, described in sssp.h,
+ * instead of discarding it.  Other changes still discard every tree,
+ * including the addition of an arc by giving its endpoints, whose
+ * distance is not yet known, as described for GraphListener.
+ */
+
+class TreeCache : public GraphListener<nodeT,arcT> {
+public:
+
+/*
+ * Constructor: TreeCache
+ * Usage: TreeCache cache;
+ *        TreeCache cache(capacity);
+ * ---------------------------------
+ * Creates an empty cache that holds at most capacity trees.
+ */
+	TreeCache(int capacity = DEFAULT_TREE_CACHE_SIZE);
+
+/*
+ * Destructor: ~TreeCache
+ * Usage: (usually implicit)
+ * -------------------------
+ * Detaches the cache from its graph and frees the storage used by the
+ * stored trees.
+ */
+	virtual ~TreeCache();
+
+/*
+ * Methods: attach, detach
+ * Usage: cache.attach(graph);
+ *        cache.detach();
+ * --------------------------
+ * The attach method registers the cache as a listener of the graph,
+ * after which the cache may be used only with that graph, and arc
+ * distances should be changed only through updateArcWeight.  The graph
+ * must outlive the cache or be detached from it first.  The detach
+ * method unregisters the cache, which keeps its trees.
+ */
+	void attach(Graph<nodeT,arcT> & graph);
+	void detach();
+
+/*
+ * Methods: size, getCapacity, clear
+ * Usage: int n = cache.size();
+ *        int max = cache.getCapacity();
+ *        cache.clear();
+ * -------------------------------------
+ * These methods return the number of trees in the cache and the
+ * maximum number it can hold, and discard all of the stored trees.
+ */
+	int size();
+	int getCapacity();
+	void clear();
+
+/*
+ * Method: getDistance
+ * Usage: double dist = cache.getDistance(graph, source, target);
+ *        double dist = cache.getDistance(graph, source, target, &stats);
+ *        double dist = cache.getDistance(graph, source, target, &stats,
+ *                                        &control);
+ * ----------------------------------------------------------------------
+ * Returns the length of the shortest path from source to target, or
+ * UNREACHABLE if there is no such path.  If the tree for source is not
+ * in the cache, this method computes it first.  If the client supplies
+ * a searchStatsT record, it receives the work done by that search, or
+ * zeros if the tree was already in the cache.  If the client supplies
+ * a SearchControl, as described in searchcontrol.h, and it stops the
+ * search, the incomplete tree is not kept and the method returns
+ * UNREACHABLE; the control reports why the search stopped.
+ */
+	double getDistance(Graph<nodeT,arcT> & graph, nodeT *source, nodeT *target,
+	                   searchStatsT *stats = NULL,
+	                   SearchControl *control = NULL);
+
+/*
+ * Method: getPath
+ * Usage: Vector<arcT *> path = cache.getPath(graph, source, target);
+ * ------------------------------------------------------------------
+ * Returns the arcs on the shortest path from source to target in order.
+ * The vector is empty if target is the same as source or cannot be
+ * reached from it, which the client can distinguish by calling
+ * getDistance.  If the tree for source is not in the cache, this
+ * method computes it first.
+ */
+	Vector<arcT *> getPath(Graph<nodeT,arcT> & graph, nodeT *source,
+	                       nodeT *target);
+
+/*
+ * Methods: getHitCount, getMissCount, getRepairCount
+ * Usage: int hits = cache.getHitCount();
+ *        int misses = cache.getMissCount();
+ *        int repairs = cache.getRepairCount();
+ * ---------------------------------------------
+ * These methods return the number of lookups that found the tree for
+ * their source in the cache, the number that had to compute it, and
+ * the number of times an attached cache has repaired a stored tree.
+ */
+	int getHitCount();
+	int getMissCount();
+	int getRepairCount();
+
+/* Methods called by the graph, as described in graph.h */
+
+	virtual void nodeAdded(nodeT *node);
+	virtual void nodeRemoved(nodeT *node);
+	virtual void arcAdded(arcT *arc);
+	virtual void arcRemoved(arcT *arc);
+	virtual void arcWeightChanged(arcT *arc, double oldDistance);
+	virtual void graphReset();
+
+private:
+
+/*
+ * Type: treeT
+ * -----------
+ * This type holds one shortest-path tree in the form computed by
+ * DijkstraTree, along with the time at which it was last used.
+ */
+
+	struct treeT {
+		nodeT *source;
+		long lastUsed;
+		Vector<double> dist;
+		Vector<arcT *> parent;
+	};
+
+/* Instance variables */
+
+	Vector<treeT *> trees;     /* The stored trees, in no particular order */
+	int capacity;              /* The maximum number of trees              */
+	Graph<nodeT,arcT> *graph;  /* The attached graph, or NULL              */
+	long graphVersion;         /* The version the trees last matched       */
+	long clock;                /* Counter used to order the lookups        */
+	int nHits, nMisses;        /* Statistics returned to the client        */
+	int nRepairs;              /* Trees repaired while attached            */
+
+/* Private methods */
+
+	treeT *lookup(Graph<nodeT,arcT> & graph, nodeT *source,
+	              searchStatsT *stats = NULL, SearchControl *control = NULL);
+	void repairTrees(arcT *arc, double oldDistance);
+	bool adoptVersion();
+
+/* Copying is not supported for this class */
+
+	DISALLOW_COPYING(TreeCache)
+
+};
+
+#endif